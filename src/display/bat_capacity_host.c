@@ -0,0 +1,8 @@
+// 主机构建（make HOST=1）没有libbat，用固定电量代替
+#ifdef DISPLAY_HOST
+#include "bat_capacity.h"
+
+int get_bat_capacity(void) {
+    return 100;
+}
+#endif
@@ -0,0 +1,415 @@
+// 显示管线性能基线：链接显示程序本身（main.c以DISPLAY_NO_MAIN编译），在真实代码路径上
+// 逐项测量 disp_flush、clr_cache、display_image_fast、display_rgb_image、display_string_at
+// 和 ui_Screen1 上的LVGL标签、字幕日志刷新和平滑上移，输出 ns/像素、每帧SPI字节数、每帧ioctl数和按时钟估算的帧时间
+//
+// SPI消息经记录后端转发给实际后端：主机构建（make HOST=1 bench）为模拟面板，
+// 板上为spidev，两边的统计口径一致，可直接对比
+//   ./build-host/bin/display_bench [-n 次数] [-c 用例名前缀]
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <linux/spi/spidev.h>
+#include "jbd013_api.h"
+#include "hal_driver.h"
+#include "font.h"
+#include "panel_sim.h"
+#include "caption_log.h"
+#include "hw_scroll.h"
+#include "glyph_cache.h"
+#include "ui.h"
+#include "lvgl/lvgl.h"
+
+int spi_init(void);
+void lvgl_init(void);
+void ui_font_cache_init(void);
+void disp_flush(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p);
+int display_rgb_image(uint8_t* rgb_data, uint16_t width, uint16_t height);
+int display_image_fast(uint8_t* image_data, uint16_t width, uint16_t height);
+
+extern lv_obj_t *ui_Label2;
+extern lv_obj_t *ui_TextContainer;
+extern lv_obj_t *ui_StatusLabel;
+extern lv_obj_t *ui_TeleprompTerContainer;
+extern lv_obj_t *ui_TeleprompTerTxT;
+
+#define BENCH_DEFAULT_ITERS 50
+
+// ================== 记录后端 ==================
+// 统计每个SPI消息（一次ioctl）的字节数和SYNC次数，并按SPI时钟估算总线时间，然后交给实际后端
+typedef struct {
+    uint64_t messages;
+    uint64_t wire_bytes;
+    uint64_t syncs;
+    uint64_t modeled_ns;
+} rec_stats_t;
+
+static const panel_transport_t* rec_inner = NULL;
+static rec_stats_t rec_stats;
+
+static int rec_message(struct spi_ioc_transfer* transfer, uint32_t n) {
+    bool frame_start = true;
+
+    rec_stats.messages++;
+    rec_stats.modeled_ns += PANEL_SIM_MSG_OVERHEAD_NS;
+    for (uint32_t i = 0; i < n; i++) {
+        const struct spi_ioc_transfer* t = &transfer[i];
+        const uint8_t* tx = (const uint8_t*)(unsigned long)t->tx_buf;
+        uint32_t nbits = t->tx_nbits ? t->tx_nbits : 1;
+
+        // SYNC是单独的一字节片选帧
+        if (frame_start && t->len == 1 && tx != NULL && tx[0] == SPI_SYNC) {
+            rec_stats.syncs++;
+        }
+        rec_stats.wire_bytes += t->len;
+        rec_stats.modeled_ns += (uint64_t)t->len * 8 / nbits * 1000000000ull / PANEL_SIM_SPI_HZ;
+        frame_start = t->cs_change;
+    }
+    return rec_inner->message(transfer, n);
+}
+
+static void rec_reset(void) {
+    if (rec_inner != NULL && rec_inner->reset != NULL) {
+        rec_inner->reset();
+    }
+}
+
+static panel_transport_t rec_transport = {
+    .message = rec_message,
+    .reset = rec_reset,
+};
+
+// ================== 用例 ==================
+typedef struct {
+    const char* name;
+    uint32_t pixels;                // 每次操作覆盖的像素数（ns/像素的分母）
+    void (*prepare)(uint32_t iter); // 每次操作前调用，不计时、不计入SPI统计，可为NULL
+    void (*run)(uint32_t iter);
+} bench_case_t;
+
+static uint8_t image_4bit[2][PANEL_SIM_BYTES];  // 两幅交替的4bpp全屏图（影子缓冲不会跳过）
+static uint8_t image_rgb[2][640 * 480 * 3];
+static uint8_t flush_buf[2][PANEL_SIM_BYTES];      // 绘制缓冲区内容为打包4bpp（disp_l4.c）
+static lv_area_t flush_area;
+static int quiet_fd = -1;
+static int stdout_fd = -1;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+// 被测函数自带的printf在计时期间写到/dev/null（格式化开销仍计入）
+static void quiet_begin(void) {
+    fflush(stdout);
+    if (quiet_fd >= 0) {
+        dup2(quiet_fd, STDOUT_FILENO);
+    }
+}
+
+static void quiet_end(void) {
+    fflush(stdout);
+    if (stdout_fd >= 0) {
+        dup2(stdout_fd, STDOUT_FILENO);
+    }
+}
+
+// 等待刷新工作线程发送完毕（lv_disp_flush_ready清除flushing）
+static void wait_flush_done(void) {
+    lv_disp_t* disp = lv_disp_get_default();
+
+    while (disp->driver->draw_buf->flushing) {
+        sched_yield();
+    }
+}
+
+static void make_images(void) {
+    for (uint32_t i = 0; i < PANEL_SIM_BYTES; i++) {
+        uint32_t x = (i % 320) * 2, y = i / 320;
+        uint8_t a = (uint8_t)(((x + y) >> 3) & 0x0F);
+        uint8_t b = (uint8_t)(((x ^ y) >> 2) & 0x0F);
+        image_4bit[0][i] = (uint8_t)((a << 4) | a);
+        image_4bit[1][i] = (uint8_t)((b << 4) | b);
+        flush_buf[0][i] = (uint8_t)((((x >> 4) + (y >> 4)) & 0x0F) * 0x11);
+        flush_buf[1][i] = (uint8_t)((((x >> 3) ^ (y >> 3)) & 0x0F) * 0x11);
+    }
+    for (uint32_t i = 0; i < 640 * 480; i++) {
+        uint32_t x = i % 640, y = i / 640;
+        image_rgb[0][i * 3 + 0] = (uint8_t)x;
+        image_rgb[0][i * 3 + 1] = (uint8_t)y;
+        image_rgb[0][i * 3 + 2] = (uint8_t)(x + y);
+        image_rgb[1][i * 3 + 0] = (uint8_t)(255 - x);
+        image_rgb[1][i * 3 + 1] = (uint8_t)(x ^ y);
+        image_rgb[1][i * 3 + 2] = (uint8_t)y;
+    }
+}
+
+// disp_flush：模拟LVGL一次只有一块区域的刷新，内容隔次变化
+static void run_flush(uint32_t iter) {
+    lv_disp_drv_t* drv = lv_disp_get_default()->driver;
+
+    drv->draw_buf->flushing = 1;
+    drv->draw_buf->flushing_last = 1;
+    disp_flush(drv, &flush_area, (lv_color_t *)flush_buf[iter & 1]);
+    wait_flush_done();
+}
+
+// 内容不变的整屏刷新：只剩打包和影子比较的开销
+static void run_flush_same(uint32_t iter) {
+    (void)iter;
+    run_flush(0);
+}
+
+#define FLUSH_RUN(w, h) \
+    static void run_flush_##w##x##h(uint32_t iter) { \
+        lv_area_set(&flush_area, 0, 0, (w) - 1, (h) - 1); \
+        run_flush(iter); \
+    }
+FLUSH_RUN(16, 16)
+FLUSH_RUN(64, 32)
+FLUSH_RUN(200, 48)
+FLUSH_RUN(640, 48)
+FLUSH_RUN(640, 480)
+
+static void prepare_full_area(uint32_t iter) {
+    (void)iter;
+    lv_area_set(&flush_area, 0, 0, 639, 479);
+}
+
+// 清屏前先画满，测的是真正有内容要清的情况
+static void prepare_dirty(uint32_t iter) {
+    display_image(0, 0, image_4bit[iter & 1], PANEL_SIM_BYTES);
+}
+
+static void run_clr_cache(uint32_t iter) {
+    (void)iter;
+    clr_cache();
+}
+
+static void run_image_fast_full(uint32_t iter) {
+    display_image_fast(image_4bit[iter & 1], 640, 480);
+}
+
+static void run_image_fast_320(uint32_t iter) {
+    display_image_fast(image_4bit[iter & 1], 320, 240);
+}
+
+static void run_rgb_image(uint32_t iter) {
+    display_rgb_image(image_rgb[iter & 1], 640, 480);
+}
+
+static void run_string_at(uint32_t iter) {
+    display_string_at(0, 0, (iter & 1) ? "Hello 你好" : "World 世界");
+}
+
+// ui_Screen1上的字幕日志（ui_Label2）：只布局新追加的文本、只失效新写的行
+static void prepare_caption(uint32_t iter) {
+    (void)iter;
+    lv_obj_clear_flag(ui_TextContainer, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_clear_flag(ui_Label2, LV_OBJ_FLAG_HIDDEN);
+}
+
+// 主循环的做法：每条消息另起一行
+static void run_caption_line(uint32_t iter) {
+    caption_log_append(ui_Label2, (iter & 1) ? "通过触摸左镜腿进入菜单" : "正在连接手机", true);
+    lv_refr_now(lv_disp_get_default());
+    wait_flush_done();
+}
+
+// 流式AI回复：逐词接在最后一行后面，每8个词另起一段
+static void run_caption_word(uint32_t iter) {
+    static const char* words[] = { "正在", "连接", "手机", "通过", "触摸", "左镜腿", "进入", "菜单" };
+
+    caption_log_append(ui_Label2, words[iter & 7], (iter & 7) == 0);
+    lv_refr_now(lv_disp_get_default());
+    wait_flush_done();
+}
+
+// 字幕满屏后每条新消息平滑上移一行：按定时器周期逐步推进滚动，直到移完一整行
+// 面板行原点移动的次数（模拟面板的行偏移寄存器变化）在用例结束后打印，DISPLAY_HW_SCROLL=1时应不为0
+static uint32_t caption_scroll_moves;
+
+static void run_caption_scroll(uint32_t iter) {
+    lv_coord_t row_h = lv_font_get_line_height(lv_obj_get_style_text_font(ui_Label2, LV_PART_MAIN)) +
+                       lv_obj_get_style_text_line_space(ui_Label2, LV_PART_MAIN);
+
+    caption_log_append(ui_Label2, (iter & 1) ? "通过触摸左镜腿进入菜单" : "正在连接手机", true);
+    for (lv_coord_t step = 0; step <= row_h / CAPTION_SCROLL_STEP + 1; step++) {
+        uint8_t row0, row1, col;
+
+        panel_sim_get_offset(&row0, &col);
+        usleep(HW_SCROLL_PERIOD_MS * 1000);
+        lv_timer_handler();
+        wait_flush_done();
+        panel_sim_get_offset(&row1, &col);
+        if (row1 != row0) caption_scroll_moves++;
+    }
+}
+
+// 提词器页面：约100个汉字（alibaba_30），每次只改一个字，其余重绘的字形都在缓存里
+static void prepare_cjk_page(uint32_t iter) {
+    (void)iter;
+    lv_obj_add_flag(ui_TextContainer, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_clear_flag(ui_TeleprompTerContainer, LV_OBJ_FLAG_HIDDEN);
+}
+
+static void run_cjk_page(uint32_t iter) {
+    static const char* page =
+        "通过触摸左镜腿进入菜单，向前滑动切换选项，向后滑动返回上一级。"
+        "双击镜腿确认选择，长按三秒关闭显示。提词器模式下轻触镜腿翻页，"
+        "字幕模式下新的内容会自动滚入，旧的内容向上移出屏幕。";
+
+    lv_label_set_text_fmt(ui_TeleprompTerTxT, "%s%s", (iter & 1) ? "甲" : "乙", page);
+    lv_refr_now(lv_disp_get_default());
+    wait_flush_done();
+}
+
+static void run_status_label(uint32_t iter) {
+    lv_label_set_text_fmt(ui_StatusLabel, "%u", (unsigned)iter);
+    lv_refr_now(lv_disp_get_default());
+    wait_flush_done();
+}
+
+// 主循环收到消息后的做法：整屏失效并强制刷新
+static void run_screen_refresh(uint32_t iter) {
+    (void)iter;
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(lv_disp_get_default());
+    wait_flush_done();
+}
+
+static const bench_case_t bench_cases[] = {
+    { "flush_16x16", 16 * 16, NULL, run_flush_16x16 },
+    { "flush_64x32", 64 * 32, NULL, run_flush_64x32 },
+    { "flush_200x48", 200 * 48, NULL, run_flush_200x48 },
+    { "flush_640x48", 640 * 48, NULL, run_flush_640x48 },
+    { "flush_640x480", 640 * 480, NULL, run_flush_640x480 },
+    { "flush_640x480_same", 640 * 480, prepare_full_area, run_flush_same },
+    { "clr_cache_dirty", 640 * 480, prepare_dirty, run_clr_cache },
+    { "clr_cache_clean", 640 * 480, NULL, run_clr_cache },
+    { "image_fast_640x480", 640 * 480, NULL, run_image_fast_full },
+    { "image_fast_320x240", 320 * 240, NULL, run_image_fast_320 },
+    { "rgb_image_640x480", 640 * 480, NULL, run_rgb_image },
+    { "string_at", 640 * 48, NULL, run_string_at },
+    { "caption_line", 640 * 480, prepare_caption, run_caption_line },
+    { "caption_word", 640 * 480, prepare_caption, run_caption_word },
+    { "caption_scroll", 640 * 400, prepare_caption, run_caption_scroll },
+    { "cjk_page", 640 * 240, prepare_cjk_page, run_cjk_page },
+    { "label_status", 640 * 480, NULL, run_status_label },
+    { "screen_refresh", 640 * 480, NULL, run_screen_refresh },
+};
+
+static void run_case(const bench_case_t* c, uint32_t iters) {
+    rec_stats_t sum = {0};
+    uint64_t ns = 0;
+
+    // 先跑一次预热（影子缓冲、LVGL缓存），不计入
+    if (c->prepare) c->prepare(0);
+    quiet_begin();
+    c->run(0);
+    quiet_end();
+
+    for (uint32_t i = 1; i <= iters; i++) {
+        if (c->prepare) {
+            quiet_begin();
+            c->prepare(i);
+            quiet_end();
+        }
+        rec_stats_t before = rec_stats;
+        quiet_begin();
+        uint64_t t0 = now_ns();
+        c->run(i);
+        uint64_t t1 = now_ns();
+        quiet_end();
+        ns += t1 - t0;
+        sum.messages += rec_stats.messages - before.messages;
+        sum.wire_bytes += rec_stats.wire_bytes - before.wire_bytes;
+        sum.syncs += rec_stats.syncs - before.syncs;
+        sum.modeled_ns += rec_stats.modeled_ns - before.modeled_ns;
+    }
+
+    printf("%-20s %9.1f %8.2f %11.0f %8.1f %6.2f %9.2f\n", c->name,
+           (double)ns / iters / 1000.0,
+           (double)ns / iters / c->pixels,
+           (double)sum.wire_bytes / iters,
+           (double)sum.messages / iters,
+           (double)sum.syncs / iters,
+           (double)sum.modeled_ns / iters / 1e6);
+}
+
+static void print_glyph_cache(const char* name, const lv_font_t* font) {
+    glyph_cache_stats_t st;
+
+    if (!glyph_cache_font_stats(font, &st)) return;
+    printf("字形缓存 %s: 描述 命中%u/未命中%u, 位图 命中%u/未命中%u, %zu/%zu 字节\n", name,
+           st.dsc_hits, st.dsc_misses, st.bitmap_hits, st.bitmap_misses, st.bytes, st.cap_bytes);
+}
+
+int main(int argc, char** argv) {
+    uint32_t iters = BENCH_DEFAULT_ITERS;
+    const char* only = NULL;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:c:")) != -1) {
+        if (opt == 'n') {
+            iters = (uint32_t)atoi(optarg);
+        } else if (opt == 'c') {
+            only = optarg;
+        } else {
+            fprintf(stderr, "用法: %s [-n 次数] [-c 用例名前缀]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (iters == 0) {
+        iters = 1;
+    }
+
+    quiet_fd = open("/dev/null", O_WRONLY);
+    stdout_fd = dup(STDOUT_FILENO);
+
+    // 与main()相同的初始化顺序，只是在面板初始化前插入记录后端
+    lv_init();
+    if (spi_init() != 0) {
+        return 1;
+    }
+    rec_inner = spi_get_transport();
+    rec_transport.name = rec_inner->name;
+    spi_set_transport(&rec_transport);
+    panel_init();
+    lvgl_init();
+    ui_init();
+    ui_font_cache_init();
+    lv_scr_load(ui_Screen1);
+    lv_refr_now(lv_disp_get_default());
+    wait_flush_done();
+    make_images();
+
+    // 与main()相同：DISPLAY_HW_SCROLL=1 打开面板行原点移动
+    const char* scroll_env = getenv("DISPLAY_HW_SCROLL");
+    if (scroll_env != NULL && strcmp(scroll_env, "1") == 0) {
+        hw_scroll_set_enabled(true);
+    }
+
+    printf("后端: %s, SPI %u Hz, 每消息开销 %u ns, 每项 %u 次\n", rec_inner->name,
+           PANEL_SIM_SPI_HZ, PANEL_SIM_MSG_OVERHEAD_NS, iters);
+    printf("%-20s %9s %8s %11s %8s %6s %9s\n", "case", "us/op", "ns/px", "bytes/frame",
+           "ioctl/f", "sync/f", "model ms");
+    for (uint32_t i = 0; i < sizeof(bench_cases) / sizeof(bench_cases[0]); i++) {
+        if (only != NULL && strncmp(bench_cases[i].name, only, strlen(only)) != 0) {
+            continue;
+        }
+        run_case(&bench_cases[i], iters);
+    }
+    printf("硬件滚动: %s, caption_scroll 行原点移动 %u 次（模拟面板）\n",
+           hw_scroll_enabled() ? "打开" : "关闭", caption_scroll_moves);
+    print_glyph_cache("alibaba_30", &ui_font_alibaba_30);
+    print_glyph_cache("alibaba_48", &ui_font_alibaba_48);
+    return 0;
+}
@@ -0,0 +1,373 @@
+// .gfnt往返测试：
+// - 位图压缩：1/2/4/8bpp，各种宽高下全零、全满、零行和满行交替、游程正好结束在行尾、
+//   只有最后一个像素、竖直笔画（与上一行异或后全零）和随机位图，压缩后不超过上限、解压后逐字节相同，
+//   截掉一个字节时解压失败，不写出输出缓冲
+// - 整个转换流程：构造一个合成的LVGL字体（五种码点表格式、两种字距表格式），用tools/font_pack.c转换，
+//   再用font_bin_load加载，逐字形比较位图，逐对比较字距调整后的步进
+// 只用LVGL的头文件（字体描述结构），不链接LVGL
+// 主机上编译运行：make -C src/display/bench font_bin_test && ./src/display/bench/font_bin_test
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+// 转换工具的main改名后一起编译，转换FONT_NAME（下面的合成字体）
+#define FONT_NAME font_bin_test_font
+#define main font_pack_main
+#include "../tools/font_pack.c"
+#undef main
+
+#define MAX_W 255
+#define MAX_H 64
+#define GUARD 16                // 解压输出后面的保护字节
+
+static const uint8_t bpps[] = { 1, 2, 4, 8 };
+
+// ================== 位图压缩 ==================
+enum {
+    PAT_ZERO,
+    PAT_FULL,
+    PAT_ZERO_ROWS,              // 零行和满行交替
+    PAT_ROW_END_RUNS,           // 每行末尾一段满值，游程正好结束在行尾
+    PAT_LAST_PIXEL,
+    PAT_VERTICAL,               // 竖直笔画，与上一行异或后除第一行外全零
+    PAT_RANDOM,
+    PAT_SPARSE,
+    PAT_COUNT
+};
+
+// LVGL位图：像素连续存放，高位在前
+static void bmp_set(uint8_t *bmp, uint32_t i, uint8_t bpp, uint8_t v) {
+    uint32_t bit = i * bpp;
+
+    bmp[bit >> 3] |= (uint8_t)(v << (8 - bpp - (bit & 7)));
+}
+
+static void make_bitmap(uint8_t *bmp, uint32_t w, uint32_t h, uint8_t bpp, int pat) {
+    uint32_t n = w * h, max = (1u << bpp) - 1;
+
+    memset(bmp, 0, (n * bpp + 7) / 8);
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t x = i % w, y = i / w, v = 0;
+
+        switch (pat) {
+        case PAT_FULL: v = max; break;
+        case PAT_ZERO_ROWS: v = (y & 1) ? max : 0; break;
+        case PAT_ROW_END_RUNS: v = x + 1 + y % 4 > w ? max - y % (max + 1) : 0; break;
+        case PAT_LAST_PIXEL: v = i == n - 1 ? max : 0; break;
+        case PAT_VERTICAL: v = x % 5 == 2 ? max : 0; break;
+        case PAT_RANDOM: v = (uint32_t)rand() & max; break;
+        case PAT_SPARSE: v = rand() % 8 ? 0 : (uint32_t)rand() & max; break;
+        default: break;
+        }
+        bmp_set(bmp, i, bpp, (uint8_t)v);
+    }
+}
+
+static int check_codec(void) {
+    static const uint8_t ws[] = { 1, 2, 3, 5, 8, 13, 31, 64, 255 };
+    static const uint8_t hs[] = { 1, 2, 3, 7, 16, MAX_H };
+    static uint8_t src[MAX_W * MAX_H], comp[MAX_W * MAX_H * 2], out[MAX_W * MAX_H + GUARD];
+    int fail = 0, cases = 0;
+
+    srand(1);
+    for (uint32_t b = 0; b < sizeof(bpps); b++) {
+        for (uint32_t wi = 0; wi < sizeof(ws); wi++) {
+            for (uint32_t hi = 0; hi < sizeof(hs); hi++) {
+                for (int pat = 0; pat < PAT_COUNT; pat++) {
+                    uint8_t bpp = bpps[b], w = ws[wi], h = hs[hi];
+                    size_t len = ((size_t)w * h * bpp + 7) / 8;
+                    size_t c;
+
+                    make_bitmap(src, w, h, bpp, pat);
+                    c = font_bin_compress(src, w, h, bpp, comp);
+                    memset(out, 0xA5, len + GUARD);
+                    cases++;
+                    if (c > font_bin_comp_bound(w, h, bpp)) {
+                        printf("FAIL %ubpp %ux%u 图案%d: 压缩后%zu字节，超过上限%zu\n", bpp, w, h, pat, c,
+                               font_bin_comp_bound(w, h, bpp));
+                        fail++;
+                    } else if (font_bin_decompress(comp, c, w, h, bpp, out) < 0 || memcmp(src, out, len) != 0) {
+                        printf("FAIL %ubpp %ux%u 图案%d: 解压结果不一致\n", bpp, w, h, pat);
+                        fail++;
+                    } else if (out[len] != 0xA5 || out[len + GUARD - 1] != 0xA5) {
+                        printf("FAIL %ubpp %ux%u 图案%d: 写出了输出缓冲\n", bpp, w, h, pat);
+                        fail++;
+                    } else if (c > 0 && font_bin_decompress(comp, c - 1, w, h, bpp, out) == 0) {
+                        printf("FAIL %ubpp %ux%u 图案%d: 截掉一个字节仍解压成功\n", bpp, w, h, pat);
+                        fail++;
+                    }
+                }
+            }
+        }
+    }
+    printf("位图压缩（%d种）: %s\n", cases, fail ? "FAIL" : "OK");
+    return fail;
+}
+// ================== 位图压缩结束 ==================
+
+// ================== 合成字体 ==================
+// 字形1为空格（0x0），2~10为'A'~'I'（FORMAT0_TINY），11~15为'a'~'e'（FORMAT0_FULL），
+// 16~19为U+4E00起的稀疏码点（SPARSE_TINY），20~21为U+1F600起的稀疏码点（SPARSE_FULL）
+#define GLYPHS 22               // 含不用的字形0
+
+static const uint8_t full_ofs[] = { 0, 1, 2, 3, 4 };
+static const uint16_t tiny_list[] = { 0, 5, 0x100, 0x1234 };
+static const uint16_t full_list[] = { 0, 3 };
+static const uint16_t full_list_ofs[] = { 0, 1 };
+
+static const lv_font_fmt_txt_cmap_t test_cmaps[] = {
+    { .range_start = ' ', .range_length = 1, .glyph_id_start = 1, .type = LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY },
+    { .range_start = 'A', .range_length = 9, .glyph_id_start = 2, .type = LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY },
+    { .range_start = 'a', .range_length = 5, .glyph_id_start = 11, .glyph_id_ofs_list = full_ofs,
+      .list_length = 5, .type = LV_FONT_FMT_TXT_CMAP_FORMAT0_FULL },
+    { .range_start = 0x4E00, .range_length = 0x1235, .glyph_id_start = 16, .unicode_list = tiny_list,
+      .list_length = 4, .type = LV_FONT_FMT_TXT_CMAP_SPARSE_TINY },
+    { .range_start = 0x1F600, .range_length = 4, .glyph_id_start = 20, .unicode_list = full_list,
+      .glyph_id_ofs_list = full_list_ofs, .list_length = 2, .type = LV_FONT_FMT_TXT_CMAP_SPARSE_FULL },
+};
+
+// 字距（字形对）：左、右字形序号，值
+static const uint8_t pair_ids8[] = { 2, 3, 3, 2, 4, 4, 11, 16, 16, 11, 20, 21, 21, 1, 1, 5 };
+static const uint16_t pair_ids16[] = { 2, 3, 3, 2, 4, 4, 11, 16, 16, 11, 20, 21, 21, 1, 1, 5 };
+static const int8_t pair_values[] = { -5, 7, 127, -12, 3, -128, 40, -1 };
+static const lv_font_fmt_txt_kern_pair_t kern_pairs8 = {
+    .glyph_ids = pair_ids8, .values = pair_values, .pair_cnt = 8, .glyph_ids_size = 0,
+};
+static const lv_font_fmt_txt_kern_pair_t kern_pairs16 = {
+    .glyph_ids = pair_ids16, .values = pair_values, .pair_cnt = 8, .glyph_ids_size = 1,
+};
+
+// 字距（字形类）：3个左类、2个右类，类0为不调整
+static const uint8_t left_class[GLYPHS] = { 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3, 1, 2 };
+static const uint8_t right_class[GLYPHS] = { 0, 2, 1, 0, 2, 1, 0, 2, 1, 0, 2, 1, 0, 2, 1, 0, 2, 1, 0, 2, 2, 1 };
+static const int8_t class_values[] = { -9, 14, 0, -128, 127, 6 };
+static const lv_font_fmt_txt_kern_classes_t kern_classes = {
+    .class_pair_values = class_values, .left_class_mapping = left_class, .right_class_mapping = right_class,
+    .left_class_cnt = 3, .right_class_cnt = 2,
+};
+
+static lv_font_fmt_txt_glyph_dsc_t test_glyphs[GLYPHS];
+static uint8_t test_bitmaps[GLYPHS * MAX_W * MAX_H];
+static lv_font_fmt_txt_dsc_t test_dsc;
+
+const lv_font_t font_bin_test_font = {
+    .line_height = 40,
+    .base_line = 8,
+    .underline_position = -4,
+    .underline_thickness = 2,
+    .dsc = &test_dsc,
+};
+
+// 第k种配置：bpp，字距表的格式
+static void build_font(int k) {
+    static const uint8_t sizes[GLYPHS][2] = {
+        { 0, 0 }, { 0, 0 }, { 1, 1 }, { 7, 5 }, { 9, 6 }, { 13, 8 }, { 11, 7 }, { 10, 9 }, { 16, 12 },
+        { 255, 2 }, { 3, 40 }, { 20, 30 }, { 17, 17 }, { 31, 1 }, { 1, 31 }, { 24, 24 }, { 33, 29 },
+        { 2, 2 }, { 5, 64 }, { 64, 5 }, { 40, 40 }, { 19, 23 },
+    };
+    uint8_t bpp = bpps[k];
+    uint32_t index = 0;
+
+    memset(test_glyphs, 0, sizeof(test_glyphs));
+    memset(&test_dsc, 0, sizeof(test_dsc));
+    srand(100 + k);
+    for (uint32_t g = 1; g < GLYPHS; g++) {
+        lv_font_fmt_txt_glyph_dsc_t *gd = &test_glyphs[g];
+        uint32_t w = sizes[g][0], h = sizes[g][1], adv = (w + 12) * 16;
+
+        gd->bitmap_index = index;
+        gd->adv_w = adv > 4095 ? 4095 : adv;
+        gd->box_w = w;
+        gd->box_h = h;
+        gd->ofs_x = (int8_t)(g % 5) - 2;
+        gd->ofs_y = (int8_t)(g % 7) - 3;
+        if (w > 0 && h > 0) make_bitmap(test_bitmaps + index, w, h, bpp, (int)(g % PAT_COUNT));
+        index += (w * h * bpp + 7) / 8;
+    }
+
+    test_dsc.glyph_bitmap = test_bitmaps;
+    test_dsc.glyph_dsc = test_glyphs;
+    test_dsc.cmaps = test_cmaps;
+    test_dsc.cmap_num = sizeof(test_cmaps) / sizeof(test_cmaps[0]);
+    test_dsc.bpp = bpp;
+    test_dsc.bitmap_format = LV_FONT_FMT_TXT_PLAIN;
+    test_dsc.kern_scale = k & 1 ? 23 : 16;
+    if (k == 0) {
+        test_dsc.kern_dsc = &kern_pairs8;
+    } else if (k == 2) {
+        test_dsc.kern_dsc = &kern_pairs16;
+    } else {
+        test_dsc.kern_dsc = &kern_classes;
+        test_dsc.kern_classes = 1;
+    }
+}
+
+// 按LVGL的规则（lv_font_fmt_txt.c）查码点和字距，作为比较的基准
+static uint32_t ref_gid(uint32_t letter) {
+    for (uint32_t i = 0; i < test_dsc.cmap_num; i++) {
+        const lv_font_fmt_txt_cmap_t *cm = &test_dsc.cmaps[i];
+        uint32_t r = letter - cm->range_start;
+
+        if (letter < cm->range_start || r >= cm->range_length) continue;
+        switch (cm->type) {
+        case LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY:
+            return cm->glyph_id_start + r;
+        case LV_FONT_FMT_TXT_CMAP_FORMAT0_FULL:
+            return cm->glyph_id_start + ((const uint8_t *)cm->glyph_id_ofs_list)[r];
+        default:
+            for (uint32_t j = 0; j < cm->list_length; j++) {
+                if (cm->unicode_list[j] != r) continue;
+                if (cm->type == LV_FONT_FMT_TXT_CMAP_SPARSE_TINY) return cm->glyph_id_start + j;
+                return cm->glyph_id_start + ((const uint16_t *)cm->glyph_id_ofs_list)[j];
+            }
+            return 0;
+        }
+    }
+    return 0;
+}
+
+static int32_t ref_kern(uint32_t left, uint32_t right) {
+    if (test_dsc.kern_classes == 0) {
+        const lv_font_fmt_txt_kern_pair_t *kp = test_dsc.kern_dsc;
+
+        for (uint32_t i = 0; i < kp->pair_cnt; i++) {
+            uint32_t l = kp->glyph_ids_size == 0 ? ((const uint8_t *)kp->glyph_ids)[2 * i] :
+                                                   ((const uint16_t *)kp->glyph_ids)[2 * i];
+            uint32_t r = kp->glyph_ids_size == 0 ? ((const uint8_t *)kp->glyph_ids)[2 * i + 1] :
+                                                   ((const uint16_t *)kp->glyph_ids)[2 * i + 1];
+            if (l == left && r == right) return kp->values[i];
+        }
+        return 0;
+    } else {
+        const lv_font_fmt_txt_kern_classes_t *kc = test_dsc.kern_dsc;
+        uint8_t lc = kc->left_class_mapping[left], rc = kc->right_class_mapping[right];
+
+        if (lc == 0 || rc == 0) return 0;
+        return kc->class_pair_values[(lc - 1) * kc->right_class_cnt + (rc - 1)];
+    }
+}
+
+static bool ref_dsc(uint32_t letter, uint32_t letter_next, lv_font_glyph_dsc_t *dsc) {
+    bool is_tab = letter == '\t';
+    uint32_t gid = ref_gid(is_tab ? ' ' : letter), gid_next = ref_gid(letter_next);
+    const lv_font_fmt_txt_glyph_dsc_t *gd = &test_glyphs[gid];
+    int32_t adv;
+
+    if (gid == 0) return false;
+    adv = gd->adv_w * (is_tab ? 2 : 1);
+    if (gid_next != 0) adv += (ref_kern(gid, gid_next) * test_dsc.kern_scale) >> 4;
+    dsc->adv_w = (uint16_t)((adv + 8) >> 4);
+    dsc->box_w = gd->box_w * (is_tab ? 2 : 1);
+    dsc->box_h = gd->box_h;
+    dsc->ofs_x = gd->ofs_x;
+    dsc->ofs_y = gd->ofs_y;
+    dsc->bpp = test_dsc.bpp;
+    return true;
+}
+
+static int check_font(int k, const char *path) {
+    static const uint32_t letters[] = {
+        ' ', 'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'a', 'b', 'c', 'd', 'e',
+        0x4E00, 0x4E05, 0x4F00, 0x6034, 0x1F600, 0x1F603,
+        '\t', 'J', 'Z', 'f', 0x4E01, 0x1F601, 0,        // 制表符和字体里没有的码点
+    };
+    const uint32_t n = sizeof(letters) / sizeof(letters[0]);
+    char *argv[] = { "font_pack", (char *)path, NULL };
+    lv_font_t *font;
+    int fail = 0, kerned = 0;
+
+    build_font(k);
+    if (font_pack_main(2, argv) != 0 || (font = font_bin_load(path)) == NULL) {
+        printf("FAIL %ubpp: 转换或加载失败\n", bpps[k]);
+        return 1;
+    }
+    if (font->line_height != font_bin_test_font.line_height || font->base_line != font_bin_test_font.base_line) {
+        printf("FAIL %ubpp: 行高/基线不一致\n", bpps[k]);
+        fail++;
+    }
+
+    // 两遍：第二遍描述和位图都从字形缓存取
+    for (int pass = 0; pass < 2; pass++) {
+        for (uint32_t i = 0; i < n; i++) {
+            uint32_t gid = ref_gid(letters[i]);
+            const lv_font_fmt_txt_glyph_dsc_t *gd = &test_glyphs[gid];
+            const uint8_t *bmp = font_bin_get_glyph_bitmap(font, letters[i]);
+            size_t len = ((size_t)gd->box_w * gd->box_h * bpps[k] + 7) / 8;
+
+            if (letters[i] == '\t') {
+                // 位图按空格取
+            } else if (gid == 0 ? bmp != NULL :
+                       bmp == NULL || memcmp(bmp, test_bitmaps + gd->bitmap_index, len) != 0) {
+                printf("FAIL %ubpp U+%04X: 位图不一致\n", bpps[k], (unsigned)letters[i]);
+                fail++;
+            }
+
+            for (uint32_t j = 0; j < n; j++) {
+                lv_font_glyph_dsc_t got, want;
+                bool ok_got, ok_want;
+
+                memset(&got, 0, sizeof(got));
+                memset(&want, 0, sizeof(want));
+                ok_got = font_bin_get_glyph_dsc(font, &got, letters[i], letters[j]);
+                ok_want = ref_dsc(letters[i], letters[j], &want);
+                if (ok_got != ok_want || (ok_want && (got.adv_w != want.adv_w || got.box_w != want.box_w ||
+                    got.box_h != want.box_h || got.ofs_x != want.ofs_x || got.ofs_y != want.ofs_y ||
+                    got.bpp != want.bpp))) {
+                    printf("FAIL %ubpp U+%04X U+%04X: 步进%u 期望%u\n", bpps[k], (unsigned)letters[i],
+                           (unsigned)letters[j], got.adv_w, want.adv_w);
+                    fail++;
+                }
+                if (pass == 0 && ok_want && ref_gid(letters[j]) != 0 &&
+                    ref_kern(ref_gid(letters[i] == '\t' ? ' ' : letters[i]), ref_gid(letters[j])) != 0) {
+                    kerned++;
+                }
+            }
+        }
+    }
+    printf("%ubpp（%s，kern_scale %u）: %u个码点，%d对有字距调整: %s\n", bpps[k],
+           test_dsc.kern_classes ? "字形类" : (k == 0 ? "字形对/8位" : "字形对/16位"),
+           test_dsc.kern_scale, n, kerned, fail ? "FAIL" : "OK");
+    font_bin_free(font);
+    return fail;
+}
+
+// 文件被截断时font_bin_load应当拒绝
+static int check_truncated(const char *path) {
+    lv_font_t *font;
+
+    if (truncate(path, sizeof(font_bin_header_t) + 8) != 0) {
+        perror(path);
+        return 1;
+    }
+    font = font_bin_load(path);
+    if (font != NULL) {
+        printf("FAIL 截断的字体文件加载成功\n");
+        font_bin_free(font);
+        return 1;
+    }
+    return 0;
+}
+// ================== 合成字体结束 ==================
+
+int main(void) {
+    char path[] = "/tmp/font_bin_test_XXXXXX";
+    int fd = mkstemp(path);
+    int fail = 0;
+
+    if (fd < 0) {
+        perror("mkstemp");
+        return 1;
+    }
+    close(fd);
+
+    fail += check_codec();
+    for (int k = 0; k < (int)sizeof(bpps); k++) {
+        fail += check_font(k, path);
+    }
+    fail += check_truncated(path);
+    unlink(path);
+    printf("正确性: %s (%d 项失败)\n", fail ? "FAIL" : "PASS", fail);
+    return fail ? 1 : 0;
+}
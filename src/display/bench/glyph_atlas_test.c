@@ -0,0 +1,228 @@
+// 字形图集测试：display_string_at（图集 + 行合成）在模拟面板上画出的画面，
+// 与逐字形逐像素放置（原write_char的定位规则，重叠处按灰度取大）的参考画面逐像素比较
+// - 同一字符串从偶数列和奇数列开始画：字形宽度有奇有偶，两种半字节相位的副本都要用到
+// - 字符串超出一行时自动换行；同一位置重画一遍（旧区域清除、长条覆盖）画面不变
+// - 不同的字符超过图集槽数的一半，图集整表清空后重新取到的字形仍然正确
+// - 逐个clr_char后整屏为黑
+// 字形由这里按码点生成（宽高、步进、灰度都是确定的），不用字体里的数据；font.c整个包含进来，以便读图集的计数
+// 主机上编译运行：make -C src/display/bench glyph_atlas_test && ./src/display/bench/glyph_atlas_test
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "jbd013_api.h"
+#include "panel_sim.h"
+#include "../font.c"
+
+#define MISSING '#'             // 字体里没有的字符
+
+int spi_file = -1;
+
+static uint8_t glyph_bmp[64 * 64];
+
+// ================== 合成字体 ==================
+// 宽度9~22（奇偶都有），高度不超过行高，步进比宽度大2~4像素；每个字形四周的像素都不为0，错位一列就能看出来
+static void glyph_geo(uint32_t c, int* w, int* h, int* adv) {
+    int lh = lv_font_get_line_height(&Font);
+
+    *w = 9 + (int)(c * 7 % 14);
+    *h = lh / 2 + (int)(c % (uint32_t)(lh / 3));
+    *adv = *w + 2 + (int)(c % 3);
+}
+
+bool lv_font_get_glyph_dsc(const lv_font_t* font, lv_font_glyph_dsc_t* dsc, uint32_t letter, uint32_t letter_next) {
+    int w, h, adv;
+
+    if (letter == MISSING) return false;
+    glyph_geo(letter, &w, &h, &adv);
+    memset(dsc, 0, sizeof(*dsc));
+    dsc->adv_w = adv;
+    dsc->box_w = letter == ' ' ? 0 : w;
+    dsc->box_h = letter == ' ' ? 0 : h;
+    dsc->bpp = 4;
+    return true;
+}
+
+const uint8_t* lv_font_get_glyph_bitmap(const lv_font_t* font, uint32_t letter) {
+    int w, h, adv;
+
+    glyph_geo(letter, &w, &h, &adv);
+    memset(glyph_bmp, 0, sizeof(glyph_bmp));
+    srand(letter);
+    for (int p = 0; p < w * h; p++) {
+        int x = p % w, y = p / w;
+        uint8_t v = (x == 0 || y == 0 || x == w - 1 || y == h - 1) ? 1 + (uint8_t)((x + y) % 15) : (uint8_t)(rand() & 15);
+
+        glyph_bmp[p >> 1] |= (p & 1) ? v : (uint8_t)(v << 4);
+    }
+    return glyph_bmp;
+}
+
+uint16_t lv_font_get_glyph_width(const lv_font_t* font, uint32_t letter, uint32_t letter_next) {
+    lv_font_glyph_dsc_t g;
+
+    return lv_font_get_glyph_dsc(font, &g, letter, letter_next) ? g.adv_w : 0;
+}
+
+// 字体源文件引用了LVGL的取字形函数，这里不会调用到
+bool lv_font_get_glyph_dsc_fmt_txt(const lv_font_t* font, lv_font_glyph_dsc_t* dsc_out, uint32_t unicode_letter, uint32_t unicode_letter_next) {
+    return false;
+}
+
+const uint8_t* lv_font_get_bitmap_fmt_txt(const lv_font_t* font, uint32_t letter) {
+    return NULL;
+}
+// ================== 合成字体结束 ==================
+
+// ================== 参考画面 ==================
+static uint8_t ref[PANEL_SIM_H][PANEL_SIM_W];     // 每像素一个字节
+
+// 与compose_char相同的定位，只画进[line_row, line_row + line_rows)行
+static void ref_glyph(int line_row, int line_rows, int x, int y, uint32_t c, int adv_x, int adv_y) {
+    lv_font_glyph_dsc_t g;
+    const uint8_t* bmp;
+    int row, col;
+
+    if (!lv_font_get_glyph_dsc(&Font, &g, c, '\0') || g.box_w == 0 || g.box_h == 0) return;
+    bmp = lv_font_get_glyph_bitmap(&Font, c);
+    row = x + ((adv_y - g.box_h) / 2);
+    col = y + ((adv_x - g.box_w) / 2);
+    if (check_chars(c, "abcdefhiklmnorstuvwxz,。.．_")) row = x + adv_y * 0.85 - g.box_h;
+    if (check_chars(c, "gjpqy")) row = x + adv_y - g.box_h;
+    if (check_chars(c, "^\"'~")) row = x + adv_y * 0.15;
+
+    for (int p = 0; p < g.box_w * g.box_h; p++) {
+        int py = row + p / g.box_w, px = col + p % g.box_w;
+        uint8_t v = (p & 1) ? (bmp[p >> 1] & 0x0F) : (bmp[p >> 1] >> 4);
+
+        if (py < line_row || py >= line_row + line_rows || px < 0 || px >= PANEL_SIM_W) continue;
+        if (v > ref[py][px]) ref[py][px] = v;
+    }
+}
+
+// 与draw_string_at相同的排版（字符串不回绕到起始行）
+static void ref_string(int x, int y, const char* text) {
+    const char* p = text;
+    int adv_y = lv_font_get_line_height(&Font);
+    int cur_x = x, cur_y = y;
+
+    while (480 % adv_y != 0) adv_y--;
+    while (*p) {
+        uint32_t unicode = utf8_to_unicode(&p);
+        int adv_x = lv_font_get_glyph_width(&Font, unicode, 0);
+        int rows = adv_y < LINE_STRIP_ROWS ? adv_y : LINE_STRIP_ROWS;
+
+        if (check_chars(unicode, "j")) adv_x *= 1.5;
+        if (cur_x + rows > 480) rows = 480 - cur_x;
+        ref_glyph(cur_x, rows, cur_x, cur_y, unicode, adv_x, adv_y);
+        cur_y += adv_x;
+        if (cur_y + adv_x >= 640) {
+            cur_x += adv_y;
+            cur_y = y;
+        }
+    }
+}
+
+// 模拟面板锁存的缓存（不经镜像，行原点不动时即逻辑画面）与参考画面逐像素比较
+static int compare(const char* what) {
+    const uint8_t* vis = panel_sim_frame();
+
+    for (int y = 0; y < PANEL_SIM_H; y++) {
+        for (int x = 0; x < PANEL_SIM_W; x++) {
+            uint8_t b = vis[y * (PANEL_SIM_W / 2) + x / 2];
+            uint8_t v = (x & 1) ? (b & 0x0F) : (b >> 4);
+
+            if (v != ref[y][x]) {
+                printf("FAIL %s: (%d, %d) 为%u，期望%u\n", what, y, x, v, ref[y][x]);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+// 清掉所有字符区域，画面应当全黑
+static int clear_all(const char* what) {
+    int fail;
+
+    while (clr_char() == 0) {
+    }
+    memset(ref, 0, sizeof(ref));
+    fail = compare(what);
+    if (fail) printf("  （clr_char之后）\n");
+    return fail;
+}
+// ================== 参考画面结束 ==================
+
+// 在(x, y)画一遍、原位置重画一遍，都与参考画面比较，最后清除
+static int check_string(int x, int y, const char* text) {
+    char what[96];
+    int fail = 0;
+
+    snprintf(what, sizeof(what), "(%d, %d) \"%.40s\"", x, y, text);
+    memset(ref, 0, sizeof(ref));
+    ref_string(x, y, text);
+    for (int pass = 0; pass < 2; pass++) {
+        if (display_string_at(x, y, text) != 0) {
+            printf("FAIL %s: display_string_at失败\n", what);
+            return 1;
+        }
+        fail += compare(what);
+    }
+    return fail + clear_all(what);
+}
+
+int main(void) {
+    static const char* texts[] = {
+        "Hello World jpgq",
+        "^~'\" a#b c,.",
+        "ftrun 你好 abc xyz ABCDEFGHIJKLMNOP 0123456789",
+        "正在连接手机，通过触摸左镜腿进入菜单。",
+    };
+    static const int cols[] = { 0, 1, 2, 3, 7, 100, 101, 333 };
+    char cjk[4 * 40 + 1];
+    uint32_t max_used = 0;
+    int fail = 0, cases = 0, clears = 0, atlas_fail = 0;
+
+    spi_set_transport(&panel_sim_transport);
+    panel_init();
+    clr_cache();
+    panel_sync();
+
+    // 奇偶列起点
+    for (uint32_t t = 0; t < sizeof(texts) / sizeof(texts[0]); t++) {
+        for (uint32_t c = 0; c < sizeof(cols) / sizeof(cols[0]); c++) {
+            fail += check_string(48 + (int)c * 7, cols[c], texts[t]);
+            cases++;
+        }
+    }
+    printf("奇偶列起点（%d种）: %s\n", cases, fail ? "FAIL" : "OK");
+
+    // 每次40个新的汉字，共400个：图集装满一半时整表清空，之后再画最早的字符串
+    for (int round = 0; round <= 10; round++) {
+        uint32_t base = 0x4E00 + (uint32_t)(round % 10) * 40;
+        char* p = cjk;
+        uint32_t before = glyph_atlas_used;
+
+        for (uint32_t i = 0; i < 40; i++) {
+            uint32_t u = base + i;
+
+            *p++ = (char)(0xE0 | (u >> 12));
+            *p++ = (char)(0x80 | ((u >> 6) & 0x3F));
+            *p++ = (char)(0x80 | (u & 0x3F));
+        }
+        *p = '\0';
+        atlas_fail += check_string(0, round & 1, cjk);
+        if (glyph_atlas_used < before) clears++;
+        if (glyph_atlas_used > max_used) max_used = glyph_atlas_used;
+    }
+    if (clears == 0 || max_used > GLYPH_ATLAS_SLOTS / 2) {
+        printf("FAIL 图集: 清空%d次，最多%u个字形（上限%d）\n", clears, max_used, GLYPH_ATLAS_SLOTS / 2);
+        atlas_fail++;
+    }
+    printf("图集清空（%d次，最多%u个字形）: %s\n", clears, max_used, atlas_fail ? "FAIL" : "OK");
+    fail += atlas_fail;
+
+    printf("正确性: %s (%d 项失败)\n", fail ? "FAIL" : "PASS", fail);
+    return fail ? 1 : 0;
+}
@@ -0,0 +1,147 @@
+// 硬件滚动测试：在模拟面板上让中间240行的文字区逐步上移，区域外有固定的状态栏，
+// 对比 每步重发整个区域 与 panel_scroll_rows移动行原点后再重发整个区域（影子缓冲只发送对不上的行），
+// 逐步校验看到的画面与期望一致，并统计每步的传输量
+// 主机上编译运行：make -C src/display/bench hw_scroll_bench && ./src/display/bench/hw_scroll_bench
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "jbd013_api.h"
+#include "panel_sim.h"
+
+#define ROW_BYTES (PANEL_SIM_W / 2)
+#define REGION_Y 120
+#define REGION_H 240
+#define STRIP_H 2048            // 提词器文字的总高度
+#define LINE_H 40
+#define GLYPH_W 30
+
+int spi_file = -1;
+
+static uint8_t strip[STRIP_H * ROW_BYTES];      // 整篇文字渲染成的4bpp长条
+static uint8_t frame_buf[PANEL_SIM_BYTES];      // 当前逻辑画面
+
+static void set_px(uint8_t* buf, int x, int y, uint8_t gray) {
+    uint8_t* b = &buf[y * ROW_BYTES + x / 2];
+    if (x & 1) {
+        *b = (*b & 0xF0) | gray;
+    } else {
+        *b = (*b & 0x0F) | (gray << 4);
+    }
+}
+
+// 伪文字：每行若干个由横竖笔画组成的字形，笔画边缘带灰度
+static void render_strip(void) {
+    memset(strip, 0, sizeof(strip));
+    srand(7);
+    for (int line = 0; line * LINE_H + LINE_H <= STRIP_H; line++) {
+        for (int g = 0; g < PANEL_SIM_W / GLYPH_W; g++) {
+            int x0 = g * GLYPH_W, y0 = line * LINE_H;
+            int strokes = 2 + rand() % 3;
+            for (int s = 0; s < strokes; s++) {
+                int horiz = rand() & 1;
+                int pos = 4 + rand() % (horiz ? LINE_H - 12 : GLYPH_W - 8);
+                for (int t = 3; t < (horiz ? GLYPH_W - 3 : LINE_H - 8); t++) {
+                    for (int w = -1; w <= 1; w++) {
+                        int px = horiz ? x0 + t : x0 + pos + w;
+                        int py = horiz ? y0 + pos + w : y0 + t;
+                        set_px(strip, px, py, w == 0 ? 15 : 7);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// 逻辑画面：顶部状态栏（固定），中间区域显示长条从scroll行开始的部分，其余为黑
+static void render_frame(int scroll) {
+    memset(frame_buf, 0, sizeof(frame_buf));
+    for (int y = 8; y < 40; y++) {
+        for (int x = 16; x < 200; x += 2) {
+            set_px(frame_buf, x, y, ((x / 8 + y / 4) & 1) ? 15 : 0);
+        }
+    }
+    memcpy(&frame_buf[REGION_Y * ROW_BYTES], &strip[scroll * ROW_BYTES], REGION_H * ROW_BYTES);
+}
+
+static uint8_t get_px(const uint8_t* buf, int x, int y) {
+    uint8_t b = buf[y * ROW_BYTES + x / 2];
+    return (x & 1) ? (b & 0x0F) : (b >> 4);
+}
+
+// 看到的画面：panel_init设置了居中偏移和左右镜像，
+// 看到的(W-1-x, y)为逻辑画面的((x + 列偏移) % W, (y + 行偏移) % H)，与行原点无关
+static int check_visible(void) {
+    for (int y = 0; y < PANEL_SIM_H; y++) {
+        int ly = (y + PANEL_ROW_OFFSET_BASE) % PANEL_SIM_H;
+        for (int x = 0; x < PANEL_SIM_W; x++) {
+            int lx = (x + PANEL_COL_OFFSET_BASE) % PANEL_SIM_W;
+            if (panel_sim_pixel(PANEL_SIM_W - 1 - x, y) != get_px(frame_buf, lx, ly)) {
+                return y;
+            }
+        }
+    }
+    return -1;
+}
+
+// 每步上移step行，共滚动到长条末尾；hw非0时先移动行原点；返回失败步数
+static int run(const char* name, int step, int hw) {
+    panel_sim_stats_t st;
+    spi_wr_seg_t seg;
+    int steps = 0, fail = 0;
+
+    spi_set_transport(&panel_sim_transport);
+    panel_init();
+    render_frame(0);
+    display_image_sync(0, 0, frame_buf, sizeof(frame_buf), 1);
+    panel_sim_stats_reset();
+
+    for (int scroll = step; scroll + REGION_H <= STRIP_H; scroll += step, steps++) {
+        int bad;
+
+        render_frame(scroll);
+        panel_frame_begin();
+        if (hw) {
+            panel_scroll_rows(REGION_Y, REGION_H, (int16_t)step);
+        }
+        // 与LVGL一样重绘整个区域，由影子缓冲决定实际发送的部分
+        seg.col = 0;
+        seg.row = REGION_Y;
+        seg.pBuf = &frame_buf[REGION_Y * ROW_BYTES];
+        seg.len = REGION_H * ROW_BYTES;
+        display_segments(&seg, 1);
+        panel_frame_end();
+
+        bad = check_visible();
+        if (bad >= 0) {
+            if (fail < 3) {
+                printf("  %s: 第%d步（滚动%d行）画面第%d行不一致\n", name, steps, scroll, bad);
+            }
+            fail++;
+        }
+    }
+    panel_sim_stats_get(&st);
+    printf("%-16s step=%d: %4d 步, 线上 %8llu 字节 (每步 %6.0f), %3llu 次SYNC, 估算每步 %6.2f ms, 行原点 %d, %s\n",
+           name, step, steps, (unsigned long long)st.wire_bytes, (double)st.wire_bytes / steps,
+           (unsigned long long)st.syncs, st.modeled_ns / 1e6 / steps, panel_get_row_origin(),
+           fail ? "FAIL" : "ok");
+    return fail;
+}
+
+int main(void) {
+    static const int steps[] = { 1, 2, 4, 8 };
+    int fail = 0;
+
+    render_strip();
+    for (size_t i = 0; i < sizeof(steps) / sizeof(steps[0]); i++) {
+        panel_sim_stats_t full, hw;
+
+        fail += run("resend_region", steps[i], 0);
+        panel_sim_stats_get(&full);
+        fail += run("hw_offset", steps[i], 1);
+        panel_sim_stats_get(&hw);
+        printf("  传输量 %.1f%%\n", 100.0 * hw.wire_bytes / full.wire_bytes);
+    }
+    printf("%s\n", fail ? "FAIL" : "PASS");
+    return fail ? 1 : 0;
+}
@@ -0,0 +1,153 @@
+// 1bit快速通道测试：在模拟面板上对比4bpp/自动识别/整屏单色三种模式，
+// 校验面板显示内容与期望一致，并统计每帧的传输量
+// 主机上编译运行：make -C src/display/bench && ./src/display/bench/mono_bench
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "jbd013_api.h"
+#include "panel_sim.h"
+
+#define FRAMES 60
+#define LINE_H 32
+#define GLYPH_W 24
+
+int spi_file = -1;
+
+static uint8_t frame_buf[PANEL_SIM_BYTES];
+static uint8_t expect_buf[PANEL_SIM_BYTES];
+
+static void set_px(uint8_t* buf, int x, int y, uint8_t gray) {
+    uint8_t* b = &buf[(y * PANEL_SIM_W + x) / 2];
+    if (x & 1) {
+        *b = (*b & 0xF0) | gray;
+    } else {
+        *b = (*b & 0x0F) | (gray << 4);
+    }
+}
+
+// 在(x,y)画一个伪字形：由若干横竖笔画组成；aa非0时笔画边缘带灰度（模拟抗锯齿）
+static void draw_glyph(uint8_t* buf, int x, int y, unsigned seed, int aa) {
+    srand(seed);
+    int strokes = 2 + rand() % 3;
+    for (int s = 0; s < strokes; s++) {
+        int horiz = rand() & 1;
+        int pos = 4 + rand() % (horiz ? LINE_H - 8 : GLYPH_W - 8);
+        for (int t = 2; t < (horiz ? GLYPH_W - 2 : LINE_H - 2); t++) {
+            for (int w = -1; w <= 1; w++) {
+                int px = horiz ? x + t : x + pos + w;
+                int py = horiz ? y + pos + w : y + t;
+                uint8_t g = (aa && w != 0) ? 6 + rand() % 4 : 15;
+                set_px(buf, px, py, g);
+            }
+        }
+    }
+}
+
+// 生成第n帧：提词器式逐行滚动，每帧新增一个字形
+static void render_frame(uint8_t* buf, int n, int aa) {
+    int per_line = PANEL_SIM_W / GLYPH_W;
+    int lines = PANEL_SIM_H / LINE_H;
+    int total = n + 1;
+    int first = 0;
+
+    memset(buf, 0, PANEL_SIM_BYTES);
+    if (total > per_line * lines) {
+        first = ((total - per_line * lines + per_line - 1) / per_line) * per_line;
+    }
+    for (int i = first; i < total; i++) {
+        int k = i - first;
+        draw_glyph(buf, (k % per_line) * GLYPH_W, (k / per_line) * LINE_H, 1000 + i, aa);
+    }
+}
+
+static void threshold(uint8_t* buf) {
+    for (int i = 0; i < PANEL_SIM_BYTES; i++) {
+        uint8_t hi = buf[i] >> 4, lo = buf[i] & 0x0F;
+        buf[i] = ((hi >= 8) ? 0xF0 : 0) | ((lo >= 8) ? 0x0F : 0);
+    }
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+// 以指定模式播放FRAMES帧，逐帧校验，返回失败帧数
+static int run_mode(const char* name, uint8_t mode, int aa) {
+    panel_sim_stats_t st;
+    int failed = 0;
+    uint64_t cpu = 0;
+
+    spi_set_transport(&panel_sim_transport);
+    panel_init();
+    panel_set_1bit_mode(mode);
+    shadow_stats_reset();
+    panel_sim_stats_reset();
+
+    for (int n = 0; n < FRAMES; n++) {
+        render_frame(frame_buf, n * 7, aa);
+        memcpy(expect_buf, frame_buf, sizeof(expect_buf));
+        if (mode == PANEL_1BIT_FORCE) {
+            threshold(expect_buf);
+        }
+        uint64_t t0 = now_ns();
+        display_image(0, 0, frame_buf, PANEL_SIM_BYTES);
+        cpu += now_ns() - t0;
+        if (memcmp(panel_sim_frame(), expect_buf, PANEL_SIM_BYTES) != 0) {
+            failed++;
+        }
+    }
+
+    panel_sim_stats_get(&st);
+    printf("%-6s %-4s 每帧: 线上 %7.0f 字节, 4bpp %7.0f, 1bit %6.0f, 消息 %5.1f, 估算传输 %6.2f ms, CPU %6.3f ms  %s\n",
+           name, aa ? "aa" : "mono",
+           (double)st.wire_bytes / FRAMES, (double)st.wr4_bytes / FRAMES, (double)st.wr1_bytes / FRAMES,
+           (double)st.messages / FRAMES, st.modeled_ns / 1e6 / FRAMES,
+           cpu / 1e6 / FRAMES, failed ? "校验失败" : "OK");
+    return failed;
+}
+
+// 非8像素对齐的小区域：扩展对齐后不能破坏相邻像素
+static int check_unaligned(void) {
+    static const uint16_t cols[] = { 2, 6, 10, 630 };
+    int failed = 0;
+
+    spi_set_transport(&panel_sim_transport);
+    panel_init();
+    panel_set_1bit_mode(PANEL_1BIT_AUTO);
+    memset(expect_buf, 0, sizeof(expect_buf));
+    for (int y = 100; y < 110; y++) {
+        for (int x = 0; x < PANEL_SIM_W; x += 3) {
+            set_px(expect_buf, x, y, 15);
+        }
+    }
+    display_image(100, 0, &expect_buf[100 * PANEL_SIM_W / 2], 10 * PANEL_SIM_W / 2);
+    for (unsigned i = 0; i < sizeof(cols) / sizeof(cols[0]); i++) {
+        uint8_t row[4] = { 0xFF, 0x0F, 0xF0, 0x00 };
+        uint16_t n = (cols[i] + 8 <= PANEL_SIM_W) ? 4 : (PANEL_SIM_W - cols[i]) / 2;
+        memcpy(&expect_buf[(105 * PANEL_SIM_W + cols[i]) / 2], row, n);
+        display_image(105, cols[i], row, n);
+    }
+    if (memcmp(panel_sim_frame(), expect_buf, PANEL_SIM_BYTES) != 0) {
+        printf("未对齐区域校验失败\n");
+        failed++;
+    }
+    return failed;
+}
+
+int main(void) {
+    int failed = 0;
+
+    failed += check_unaligned();
+    failed += run_mode("4bpp", PANEL_1BIT_OFF, 0);
+    failed += run_mode("auto", PANEL_1BIT_AUTO, 0);
+    failed += run_mode("force", PANEL_1BIT_FORCE, 0);
+    failed += run_mode("4bpp", PANEL_1BIT_OFF, 1);
+    failed += run_mode("auto", PANEL_1BIT_AUTO, 1);
+    failed += run_mode("force", PANEL_1BIT_FORCE, 1);
+    shadow_stats_print();
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,348 @@
+// 消息总线测试：多个订阅者进程各自收到每一条消息（序号连续、内容正确、不丢失），
+// 多个发布者并发时每个发布者的消息保持顺序；统计发布到接收的延迟和吞吐量，
+// 并与旧的 128字节槽位+信号量 方式对比突发消息的丢失情况
+// 主机上编译运行：make -C src/display/bench msg_bus_bench && ./src/display/bench/msg_bus_bench
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <semaphore.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include "msg_bus.h"
+
+#define BUS_NAME "/msg_bus_bench"
+#define SUBSCRIBERS 2
+#define PUBLISHERS 2
+#define MESSAGES 20000
+#define BURST 32
+#define FLOOD_MESSAGES 1000000
+#define LEGACY_MESSAGES 2000
+#define LEGACY_SIZE 128
+
+typedef struct {
+    uint32_t received;
+    uint32_t errors;
+    uint32_t lost;
+    uint64_t lat_ns[5];             // p50 p90 p99 max 平均
+} sub_result_t;
+
+typedef struct {
+    uint32_t sender_idx;
+    uint32_t count;
+} bench_payload_t;
+
+static int cmp_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return x < y ? -1 : x > y;
+}
+
+// 等所有订阅者的读游标追上写序号（突发之间的节拍，保证不因落后而丢失）
+static void wait_drained(msg_bus_t* bus) {
+    uint32_t w = __atomic_load_n(&bus->shm->write_seq, __ATOMIC_ACQUIRE);
+
+    for (int i = 0; i < MSG_BUS_MAX_SUBS; i++) {
+        msg_bus_sub_t* s = &bus->shm->subs[i];
+        while (__atomic_load_n(&s->in_use, __ATOMIC_ACQUIRE) &&
+               (int32_t)(w - __atomic_load_n(&s->read_seq, __ATOMIC_ACQUIRE)) > 0) {
+            usleep(20);
+        }
+    }
+}
+
+// 订阅者进程：收expect条消息，检查每个发布者的计数连续，结果写入管道
+static void run_subscriber(int idx, uint32_t expect, int ready_fd, int result_fd) {
+    msg_bus_t bus;
+    msg_bus_msg_t msg;
+    sub_result_t res;
+    uint32_t next_count[PUBLISHERS] = { 0 };
+    uint64_t* lat = calloc(expect, sizeof(uint64_t));
+    uint64_t sum = 0;
+    char name[16];
+
+    memset(&res, 0, sizeof(res));
+    snprintf(name, sizeof(name), "sub%d", idx);
+    if (lat == NULL || msg_bus_open(&bus, BUS_NAME) != 0 || msg_bus_subscribe(&bus, name) != 0) {
+        exit(1);
+    }
+    if (write(ready_fd, "r", 1) != 1) exit(1);
+
+    while (res.received < expect) {
+        if (msg_bus_recv(&bus, &msg, 2000) <= 0) {
+            printf("FAIL %s: 等待超时，已收到 %u/%u\n", name, res.received, expect);
+            break;
+        }
+        uint64_t dt = msg_bus_now_ns() - msg.time_ns;
+        bench_payload_t p;
+
+        memcpy(&p, msg.payload, sizeof(p));
+        res.lost += msg.lost;
+        if (msg.type != MSG_TYPE_USER || msg.len != sizeof(p) || p.sender_idx >= PUBLISHERS ||
+            p.count != next_count[p.sender_idx]) {
+            res.errors++;
+        } else {
+            next_count[p.sender_idx]++;
+        }
+        lat[res.received++] = dt;
+        sum += dt;
+    }
+    if (res.received > 0) {
+        qsort(lat, res.received, sizeof(uint64_t), cmp_u64);
+        res.lat_ns[0] = lat[res.received / 2];
+        res.lat_ns[1] = lat[res.received * 9 / 10];
+        res.lat_ns[2] = lat[res.received * 99 / 100];
+        res.lat_ns[3] = lat[res.received - 1];
+        res.lat_ns[4] = sum / res.received;
+    }
+    if (write(result_fd, &res, sizeof(res)) != sizeof(res)) exit(1);
+    msg_bus_close(&bus);
+    free(lat);
+    exit(0);
+}
+
+// 发布者：按BURST条一组发布，组间等订阅者读完
+static void publish_paced(msg_bus_t* bus, uint32_t sender_idx, uint32_t n, int pace) {
+    for (uint32_t i = 0; i < n; i++) {
+        bench_payload_t p = { sender_idx, i };
+        msg_bus_publish(bus, MSG_TYPE_USER, &p, sizeof(p));
+        if (pace && (i % BURST) == BURST - 1) {
+            wait_drained(bus);
+        }
+    }
+}
+
+// nsubs个订阅者，npubs个发布者进程（npubs为1时由本进程发布），返回失败项数
+static int run_case(const char* name, int npubs, int pace) {
+    uint32_t per_pub = MESSAGES / npubs;
+    int ready[2], result[2];
+    pid_t pids[SUBSCRIBERS + PUBLISHERS];
+    int nproc = 0, fail = 0;
+    msg_bus_t bus;
+    char c;
+    uint64_t t0, t1;
+
+    msg_bus_unlink(BUS_NAME);
+    if (pipe(ready) != 0 || pipe(result) != 0 || msg_bus_open(&bus, BUS_NAME) != 0) {
+        perror("run_case");
+        return 1;
+    }
+    for (int i = 0; i < SUBSCRIBERS; i++) {
+        fflush(stdout);
+        pid_t pid = fork();
+        if (pid == 0) run_subscriber(i, per_pub * npubs, ready[1], result[1]);
+        pids[nproc++] = pid;
+    }
+    for (int i = 0; i < SUBSCRIBERS; i++) {
+        if (read(ready[0], &c, 1) != 1) return 1;
+    }
+
+    t0 = msg_bus_now_ns();
+    if (npubs == 1) {
+        publish_paced(&bus, 0, per_pub, pace);
+    } else {
+        for (int i = 0; i < npubs; i++) {
+            fflush(stdout);
+            pid_t pid = fork();
+            if (pid == 0) {
+                msg_bus_t pub;
+                if (msg_bus_open(&pub, BUS_NAME) != 0) exit(1);
+                publish_paced(&pub, (uint32_t)i, per_pub, pace);
+                msg_bus_close(&pub);
+                exit(0);
+            }
+            pids[nproc++] = pid;
+        }
+    }
+
+    printf("%s（%d发布者 x %u条，%d订阅者）\n", name, npubs, per_pub, SUBSCRIBERS);
+    for (int i = 0; i < SUBSCRIBERS; i++) {
+        sub_result_t res;
+        if (read(result[0], &res, sizeof(res)) != sizeof(res)) {
+            fail++;
+            continue;
+        }
+        printf("  订阅者: 收到%u 错序%u 丢失%u  延迟us p50 %.1f p90 %.1f p99 %.1f max %.1f 平均 %.1f\n",
+               res.received, res.errors, res.lost, res.lat_ns[0] / 1e3, res.lat_ns[1] / 1e3,
+               res.lat_ns[2] / 1e3, res.lat_ns[3] / 1e3, res.lat_ns[4] / 1e3);
+        if (res.received != per_pub * npubs || res.errors || res.lost) fail++;
+    }
+    t1 = msg_bus_now_ns();
+    printf("  耗时 %.1f ms，%.0f 条/秒\n", (t1 - t0) / 1e6, (double)per_pub * npubs / ((t1 - t0) / 1e9));
+
+    for (int i = 0; i < nproc; i++) {
+        int status;
+        waitpid(pids[i], &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) fail++;
+    }
+    msg_bus_close(&bus);
+    msg_bus_unlink(BUS_NAME);
+    close(ready[0]);
+    close(ready[1]);
+    close(result[0]);
+    close(result[1]);
+    return fail;
+}
+
+// 几个进程同时启动：第一个进程写了magic还没写version时，后打开的进程要等它写完，不能报版本不兼容
+// 先确定性地构造这个中间状态，再让多个进程同时打开新建的总线
+#define OPEN_ROUNDS 50
+#define OPENERS 4
+static int run_concurrent_open(void) {
+    msg_bus_t first, late;
+    int fail = 0;
+
+    msg_bus_unlink(BUS_NAME);
+    if (msg_bus_open(&first, BUS_NAME) != 0) return 1;
+    __atomic_store_n(&first.shm->version, 0, __ATOMIC_RELEASE);
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        usleep(50 * 1000);
+        __atomic_store_n(&first.shm->version, MSG_BUS_VERSION, __ATOMIC_RELEASE);
+        exit(0);
+    }
+    if (msg_bus_open(&late, BUS_NAME) != 0) {
+        printf("FAIL 第一个进程还没写version时打开失败\n");
+        fail++;
+    } else {
+        msg_bus_close(&late);
+    }
+    waitpid(pid, NULL, 0);
+    msg_bus_close(&first);
+
+    for (int r = 0; r < OPEN_ROUNDS; r++) {
+        int go[2], failed = 0;
+        pid_t pids[OPENERS];
+        char c;
+
+        msg_bus_unlink(BUS_NAME);
+        if (pipe(go) != 0) return fail + 1;
+        for (int i = 0; i < OPENERS; i++) {
+            fflush(stdout);
+            pids[i] = fork();
+            if (pids[i] == 0) {
+                msg_bus_t bus;
+                close(go[1]);
+                if (read(go[0], &c, 1) != 0) exit(1);     // 父进程关闭写端时一起开始
+                exit(msg_bus_open(&bus, BUS_NAME) == 0 ? 0 : 1);
+            }
+        }
+        close(go[0]);
+        close(go[1]);
+        for (int i = 0; i < OPENERS; i++) {
+            int status;
+            waitpid(pids[i], &status, 0);
+            if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) failed++;
+        }
+        if (failed) {
+            printf("FAIL 同时打开：第%d轮%d个进程失败\n", r, failed);
+            fail++;
+        }
+    }
+    msg_bus_unlink(BUS_NAME);
+    printf("同时打开（%d轮 x %d进程）: %s\n", OPEN_ROUNDS, OPENERS, fail ? "FAIL" : "OK");
+    return fail;
+}
+
+// 不加节拍全速发布：测发布吞吐，订阅者跟不上时报告被覆盖的条数（预期行为，不算失败）
+static void run_flood(void) {
+    msg_bus_t bus, sub;
+    msg_bus_msg_t msg;
+    uint64_t t0, t1, lost = 0, got = 0;
+    pid_t pid;
+
+    msg_bus_unlink(BUS_NAME);
+    msg_bus_open(&bus, BUS_NAME);
+    msg_bus_open(&sub, BUS_NAME);
+    msg_bus_subscribe(&sub, "flood");
+    fflush(stdout);
+    pid = fork();
+    if (pid == 0) {
+        bench_payload_t p = { 0, 0 };
+        for (p.count = 0; p.count < FLOOD_MESSAGES; p.count++) {
+            msg_bus_publish(&bus, MSG_TYPE_USER, &p, sizeof(p));
+        }
+        exit(0);
+    }
+    t0 = msg_bus_now_ns();
+    while (msg_bus_recv(&sub, &msg, 200) > 0) {
+        bench_payload_t p;
+        lost += msg.lost;
+        got++;
+        memcpy(&p, msg.payload, sizeof(p));
+        if (p.count == FLOOD_MESSAGES - 1) break;
+    }
+    t1 = msg_bus_now_ns();
+    waitpid(pid, NULL, 0);
+    printf("全速发布 %u 条：订阅者收到 %llu，被覆盖 %llu，%.0f 条/秒\n", FLOOD_MESSAGES,
+           (unsigned long long)got, (unsigned long long)lost, FLOOD_MESSAGES / ((t1 - t0) / 1e9));
+    msg_bus_close(&sub);
+    msg_bus_close(&bus);
+    msg_bus_unlink(BUS_NAME);
+}
+
+// 旧方式：一个128字节槽位+一个信号量，两个读者竞争；写者按同样的突发节奏发送
+static void run_legacy(void) {
+    struct legacy { sem_t sem; char buf[LEGACY_SIZE]; } *shm;
+    int result[2];
+    pid_t pids[SUBSCRIBERS];
+    uint32_t total = 0;
+
+    shm = mmap(NULL, sizeof(*shm), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shm == MAP_FAILED || pipe(result) != 0) return;
+    sem_init(&shm->sem, 1, 0);
+    for (int i = 0; i < SUBSCRIBERS; i++) {
+        fflush(stdout);
+        pids[i] = fork();
+        if (pids[i] == 0) {
+            uint32_t distinct = 0;
+            char last[LEGACY_SIZE] = "";
+            struct timespec ts;
+            while (1) {
+                clock_gettime(CLOCK_REALTIME, &ts);
+                ts.tv_nsec += 200000000;
+                if (ts.tv_nsec >= 1000000000) { ts.tv_sec++; ts.tv_nsec -= 1000000000; }
+                if (sem_timedwait(&shm->sem, &ts) != 0) break;
+                if (strcmp(last, shm->buf) != 0) {
+                    memcpy(last, shm->buf, LEGACY_SIZE);
+                    distinct++;
+                }
+            }
+            if (write(result[1], &distinct, sizeof(distinct)) != sizeof(distinct)) exit(1);
+            exit(0);
+        }
+    }
+    for (uint32_t i = 0; i < LEGACY_MESSAGES; i++) {
+        snprintf(shm->buf, LEGACY_SIZE, "msg %u", i);
+        sem_post(&shm->sem);
+        if ((i % BURST) == BURST - 1) usleep(1000);
+    }
+    printf("旧方式（128字节槽位+信号量，%d读者）发送 %u 条：", SUBSCRIBERS, LEGACY_MESSAGES);
+    for (int i = 0; i < SUBSCRIBERS; i++) {
+        uint32_t distinct = 0;
+        if (read(result[0], &distinct, sizeof(distinct)) == sizeof(distinct)) {
+            printf(" 读者%d看到%u条", i, distinct);
+            total += distinct;
+        }
+        waitpid(pids[i], NULL, 0);
+    }
+    printf("（每个读者都应看到%u条，合计只有%u）\n", LEGACY_MESSAGES, total);
+    sem_destroy(&shm->sem);
+    munmap(shm, sizeof(*shm));
+    close(result[0]);
+    close(result[1]);
+}
+
+int main(void) {
+    int fail = 0;
+
+    fail += run_concurrent_open();
+    fail += run_case("单发布者突发", 1, 1);
+    fail += run_case("多发布者突发", PUBLISHERS, 1);
+    run_flood();
+    run_legacy();
+    printf("正确性: %s (%d 项失败)\n", fail ? "FAIL" : "PASS", fail);
+    return fail ? 1 : 0;
+}
@@ -0,0 +1,218 @@
+// 像素转换内核测试：逐个内核与逐像素的参考实现比较（各种长度，覆盖向量尾部），
+// 然后测量640x480整屏的吞吐量
+// 主机上编译运行：make -C src/display/bench && ./src/display/bench/pix_bench
+// 板上（NEON）：make -C src/display/bench CC=<交叉编译gcc> CFLAGS="-O2 -std=gnu99 -I.. -mfpu=neon-vfpv4" pix_bench
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "pix_kernels.h"
+
+#define W 640
+#define H 480
+#define ROUNDS 20
+
+static uint8_t rgb[W * H * 3];
+static uint8_t gray[W * H];
+static uint8_t out[W * H];
+static uint8_t ref[W * H];
+
+static const uint8_t ref_bayer[4][4] = {
+    {  0,  8,  2, 10 },
+    { 12,  4, 14,  6 },
+    {  3, 11,  1,  9 },
+    { 15,  7, 13,  5 },
+};
+
+// ================== 参考实现（逐像素，不考虑速度） ==================
+static uint8_t ref_gray(const uint8_t* p, int bgr) {
+    int r = bgr ? p[2] : p[0], g = p[1], b = bgr ? p[0] : p[2];
+    return (uint8_t)((r * 77 + g * 151 + b * 28) >> 8);
+}
+
+static void ref_put(uint8_t* dst, uint32_t x, uint8_t v) {
+    if (x & 1) {
+        dst[x / 2] = (uint8_t)((dst[x / 2] & 0xF0) | v);
+    } else {
+        dst[x / 2] = (uint8_t)((dst[x / 2] & 0x0F) | (v << 4));
+    }
+}
+
+// 参考误差扩散：整幅int误差图，与库里的两行滚动实现算法相同、结构不同
+static void ref_fs(const uint8_t* src, uint8_t* dst, uint32_t w, uint32_t h) {
+    int* e = calloc((size_t)(w + 2) * (h + 1), sizeof(int));
+    uint32_t stride = w + 2;
+
+    for (uint32_t y = 0; y < h; y++) {
+        for (uint32_t x = 0; x < w; x++) {
+            int* cell = &e[y * stride + x + 1];
+            int v = src[y * w + x] + *cell / 16;
+            v = v < 0 ? 0 : (v > 255 ? 255 : v);
+            int q = (v + 8) / 17;
+            int d = v - q * 17;
+            cell[1] += d * 7;
+            cell[stride - 1] += d * 3;
+            cell[stride] += d * 5;
+            cell[stride + 1] += d;
+            ref_put(&dst[y * ((w + 1) / 2)], x, (uint8_t)q);
+        }
+    }
+    free(e);
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static int check(const char* name, uint32_t n, uint32_t bytes) {
+    if (memcmp(out, ref, bytes) != 0) {
+        for (uint32_t i = 0; i < bytes; i++) {
+            if (out[i] != ref[i]) {
+                printf("FAIL %s n=%u: 字节%u 得到0x%02x 期望0x%02x\n", name, n, i, out[i], ref[i]);
+                break;
+            }
+        }
+        return 1;
+    }
+    return 0;
+}
+
+static int test_correctness(void) {
+    static const uint32_t lens[] = { 1, 2, 3, 15, 16, 17, 31, 32, 33, 47, 100, 639, 640 };
+    int fail = 0;
+
+    for (uint32_t k = 0; k < sizeof(lens) / sizeof(lens[0]); k++) {
+        uint32_t n = lens[k];
+        uint32_t bytes = (n + 1) / 2;
+
+        for (int bgr = 0; bgr <= 1; bgr++) {
+            memset(ref, 0, sizeof(ref));
+            for (uint32_t i = 0; i < n; i++) ref[i] = ref_gray(&rgb[i * 3], bgr);
+            pix_rgb_to_gray8(rgb, out, n, bgr ? PIX_ORDER_BGR : PIX_ORDER_RGB);
+            fail += check(bgr ? "rgb_to_gray8(bgr)" : "rgb_to_gray8", n, n);
+
+            memset(ref, 0, sizeof(ref));
+            for (uint32_t i = 0; i < n; i++) ref_put(ref, i, ref_gray(&rgb[i * 3], bgr) >> 4);
+            pix_rgb_to_4bpp(rgb, out, n, bgr ? PIX_ORDER_BGR : PIX_ORDER_RGB);
+            fail += check(bgr ? "rgb_to_4bpp(bgr)" : "rgb_to_4bpp", n, bytes);
+        }
+
+        memset(ref, 0, sizeof(ref));
+        for (uint32_t i = 0; i < n; i++) ref_put(ref, i, gray[i] >> 4);
+        pix_gray8_to_4bpp(gray, out, n);
+        fail += check("gray8_to_4bpp", n, bytes);
+
+        for (uint32_t y = 0; y < 4; y++) {
+            memset(ref, 0, sizeof(ref));
+            for (uint32_t i = 0; i < n; i++) {
+                int v = gray[i] + ref_bayer[y][i % 4];
+                ref_put(ref, i, (uint8_t)((v > 255 ? 255 : v) >> 4));
+            }
+            pix_gray8_to_4bpp_bayer(gray, out, n, y);
+            fail += check("gray8_to_4bpp_bayer", n, bytes);
+        }
+
+        memset(ref, 0, sizeof(ref));
+        for (uint32_t i = 0; i < n; i++) ref_put(ref, i, gray[i] & 0x0F);
+        pix_pack_4bpp(gray, out, n);
+        fail += check("pack_4bpp", n, bytes);
+
+        for (uint32_t i = 0; i < n; i++) ref[i] = (i & 1) ? (rgb[i / 2] & 0x0F) : (rgb[i / 2] >> 4);
+        pix_unpack_4bpp(rgb, out, n);
+        fail += check("unpack_4bpp", n, n);
+    }
+
+    // 误差扩散：奇数宽度和整屏
+    static const uint32_t fs_w[] = { 1, 7, 33, 640 };
+    static const uint32_t fs_h[] = { 1, 5, 9, 480 };
+    for (uint32_t k = 0; k < 4; k++) {
+        uint32_t w = fs_w[k], h = fs_h[k], stride = (w + 1) / 2;
+
+        memset(ref, 0, sizeof(ref));
+        memset(out, 0, sizeof(out));
+        ref_fs(gray, ref, w, h);
+        if (pix_gray8_to_4bpp_fs(gray, w, out, stride, w, h) != 0) {
+            fail++;
+        }
+        fail += check("gray8_to_4bpp_fs", w * h, stride * h);
+    }
+
+    // 平坦灰度经抖动后平均亮度应接近原值（Bayer在240以上饱和为15，不参与比较）
+    for (int level = 8; level < 240; level += 40) {
+        uint64_t sum_b = 0, sum_f = 0;
+
+        memset(gray, level, W * H);
+        for (uint32_t y = 0; y < H; y++) {
+            pix_gray8_to_4bpp_bayer(&gray[y * W], &out[y * W / 2], W, y);
+        }
+        for (uint32_t i = 0; i < W * H / 2; i++) sum_b += (out[i] >> 4) + (out[i] & 0x0F);
+        pix_gray8_to_4bpp_fs(gray, W, out, W / 2, W, H);
+        for (uint32_t i = 0; i < W * H / 2; i++) sum_f += ((out[i] >> 4) + (out[i] & 0x0F)) * 17;
+        double mean_b = (double)sum_b / (W * H) * 16.0;    // Bayer按截断尺度（x16）
+        double mean_f = (double)sum_f / (W * H);            // 误差扩散按0..255
+        if (mean_b < level - 1.0 || mean_b > level + 1.0 || mean_f < level - 1.0 || mean_f > level + 1.0) {
+            printf("FAIL 平坦灰度%d: bayer均值%.2f fs均值%.2f\n", level, mean_b, mean_f);
+            fail++;
+        }
+    }
+    return fail;
+}
+
+static void report(const char* name, uint64_t ns) {
+    printf("%-22s %8.2f ms/帧  %6.2f ns/像素\n", name, ns / 1e6 / ROUNDS, (double)ns / ROUNDS / (W * H));
+}
+
+static void bench_throughput(void) {
+    uint64_t t;
+
+    t = now_ns();
+    for (int r = 0; r < ROUNDS; r++) pix_rgb_to_4bpp(rgb, out, W * H, PIX_ORDER_RGB);
+    report("rgb_to_4bpp", now_ns() - t);
+
+    t = now_ns();
+    for (int r = 0; r < ROUNDS; r++) pix_rgb_to_gray8(rgb, out, W * H, PIX_ORDER_BGR);
+    report("rgb_to_gray8(bgr)", now_ns() - t);
+
+    t = now_ns();
+    for (int r = 0; r < ROUNDS; r++) pix_gray8_to_4bpp(gray, out, W * H);
+    report("gray8_to_4bpp", now_ns() - t);
+
+    t = now_ns();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (uint32_t y = 0; y < H; y++) {
+            pix_gray8_to_4bpp_bayer(&gray[y * W], &out[y * W / 2], W, y);
+        }
+    }
+    report("gray8_to_4bpp_bayer", now_ns() - t);
+
+    t = now_ns();
+    for (int r = 0; r < ROUNDS; r++) pix_gray8_to_4bpp_fs(gray, W, out, W / 2, W, H);
+    report("gray8_to_4bpp_fs", now_ns() - t);
+
+    t = now_ns();
+    for (int r = 0; r < ROUNDS; r++) pix_pack_4bpp(gray, out, W * H);
+    report("pack_4bpp", now_ns() - t);
+
+    t = now_ns();
+    for (int r = 0; r < ROUNDS; r++) pix_unpack_4bpp(gray, out, W * H);
+    report("unpack_4bpp", now_ns() - t);
+}
+
+int main(void) {
+    srand(1234);
+    for (uint32_t i = 0; i < sizeof(rgb); i++) rgb[i] = (uint8_t)rand();
+    for (uint32_t i = 0; i < sizeof(gray); i++) gray[i] = (uint8_t)rand();
+    gray[0] = 0;
+    gray[1] = 255;      // 覆盖饱和加法
+
+    printf("像素内核实现: %s\n", pix_impl_name());
+    int fail = test_correctness();
+    printf("正确性: %s (%d 项失败)\n", fail ? "FAIL" : "PASS", fail);
+
+    for (uint32_t i = 0; i < sizeof(gray); i++) gray[i] = (uint8_t)rand();
+    bench_throughput();
+    return fail ? 1 : 0;
+}
@@ -0,0 +1,265 @@
+// 缩放测试：pix_scale的三种模式（灰度/4bpp）与逐像素的参考实现比较（各种尺寸、奇数宽度、行间距），
+// 然后与main.c里原来的scale_image_nearest（RGB888逐像素缩放，之后再转4bpp）比较每帧耗时
+// 主机上编译运行：make -C src/display/bench && ./src/display/bench/scale_bench
+// 板上（NEON）：make -C src/display/bench CC=<交叉编译gcc> CFLAGS="-O2 -std=gnu99 -I.. -mfpu=neon-vfpv4" scale_bench
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "pix_kernels.h"
+#include "pix_scale.h"
+
+#define SRC_MAX_W 1280
+#define SRC_MAX_H 960
+#define PAD 8            // 正确性测试的行间距比行宽多几个字节
+#define ROUNDS 20
+
+static uint8_t rgb[SRC_MAX_W * SRC_MAX_H * 3];
+static uint8_t gray[(SRC_MAX_W + PAD) * SRC_MAX_H];
+static uint8_t packed[(SRC_MAX_W / 2 + PAD) * SRC_MAX_H];
+static uint8_t out[(SRC_MAX_W + PAD) * SRC_MAX_H];
+static uint8_t ref[(SRC_MAX_W + PAD) * SRC_MAX_H];
+static uint8_t tmp[SRC_MAX_W * SRC_MAX_H];
+
+static const char* mode_name[] = { "nearest", "bilinear", "box" };
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+// main.c中scale_image_nearest的原样拷贝（main.c依赖LVGL和面板驱动，不便链接）
+static uint8_t* scale_image_nearest(uint8_t* src_data, uint16_t src_width, uint16_t src_height,
+                                    uint16_t dst_width, uint16_t dst_height) {
+    if (!src_data || dst_width == 0 || dst_height == 0) {
+        return NULL;
+    }
+    uint32_t dst_size = dst_width * dst_height * 3;
+    uint8_t* dst_data = malloc(dst_size);
+    if (!dst_data) {
+        return NULL;
+    }
+    uint32_t x_ratio = (src_width << 16) / dst_width;
+    uint32_t y_ratio = (src_height << 16) / dst_height;
+
+    for (uint16_t dst_y = 0; dst_y < dst_height; dst_y++) {
+        for (uint16_t dst_x = 0; dst_x < dst_width; dst_x++) {
+            uint16_t src_x = (dst_x * x_ratio) >> 16;
+            uint16_t src_y = (dst_y * y_ratio) >> 16;
+
+            if (src_x >= src_width) src_x = src_width - 1;
+            if (src_y >= src_height) src_y = src_height - 1;
+
+            uint32_t src_idx = (src_y * src_width + src_x) * 3;
+            uint32_t dst_idx = (dst_y * dst_width + dst_x) * 3;
+
+            dst_data[dst_idx + 0] = src_data[src_idx + 0];
+            dst_data[dst_idx + 1] = src_data[src_idx + 1];
+            dst_data[dst_idx + 2] = src_data[src_idx + 2];
+        }
+    }
+    return dst_data;
+}
+
+// ================== 参考实现（逐像素，不用表，不考虑速度） ==================
+// 双线性的一个方向：像素中心对齐，位置单位1/128
+static void ref_coord(uint32_t i, uint32_t src, uint32_t dst, uint32_t* p0, uint32_t* p1, uint32_t* w) {
+    int64_t f = (int64_t)(((2 * (uint64_t)i + 1) * src * 128) / (2 * (uint64_t)dst)) - 64;
+
+    if (f < 0) f = 0;
+    *p0 = (uint32_t)(f >> 7);
+    *w = (uint32_t)(f & 127);
+    if (*p0 >= src - 1) {
+        *p0 = src - 1;
+        *w = 0;
+    }
+    *p1 = *p0 + 1 < src ? *p0 + 1 : *p0;
+}
+
+static uint8_t ref_pixel(const uint8_t* src, uint32_t stride, uint32_t sw, uint32_t sh, uint32_t dw, uint32_t dh,
+                         uint32_t x, uint32_t y, uint8_t mode) {
+    if (mode == PIX_SCALE_NEAREST) {
+        uint32_t sx = (uint32_t)((2 * (uint64_t)x + 1) * sw / (2 * (uint64_t)dw));
+        uint32_t sy = (uint32_t)((2 * (uint64_t)y + 1) * sh / (2 * (uint64_t)dh));
+        return src[sy * stride + sx];
+    }
+    if (mode == PIX_SCALE_BILINEAR) {
+        uint32_t x0, x1, wx, y0, y1, wy;
+
+        ref_coord(x, sw, dw, &x0, &x1, &wx);
+        ref_coord(y, sh, dh, &y0, &y1, &wy);
+        // 先水平后垂直，每步四舍五入
+        uint32_t top = (src[y0 * stride + x0] * (128 - wx) + src[y0 * stride + x1] * wx + 64) >> 7;
+        uint32_t bot = (src[y1 * stride + x0] * (128 - wx) + src[y1 * stride + x1] * wx + 64) >> 7;
+        return (uint8_t)((top * (128 - wy) + bot * wy + 64) >> 7);
+    }
+    uint32_t xa = (uint32_t)((uint64_t)x * sw / dw), xb = (uint32_t)((uint64_t)(x + 1) * sw / dw);
+    uint32_t ya = (uint32_t)((uint64_t)y * sh / dh), yb = (uint32_t)((uint64_t)(y + 1) * sh / dh);
+    uint64_t sum = 0, area;
+
+    if (xb <= xa) xb = xa + 1;
+    if (yb <= ya) yb = ya + 1;
+    for (uint32_t j = ya; j < yb; j++) {
+        for (uint32_t i = xa; i < xb; i++) sum += src[j * stride + i];
+    }
+    area = (uint64_t)(xb - xa) * (yb - ya);
+    return (uint8_t)((sum + area / 2) / area);
+}
+
+static void ref_put(uint8_t* dst, uint32_t x, uint8_t v) {
+    if (x & 1) {
+        dst[x / 2] = (uint8_t)((dst[x / 2] & 0xF0) | v);
+    } else {
+        dst[x / 2] = (uint8_t)((dst[x / 2] & 0x0F) | (v << 4));
+    }
+}
+// ================== 参考实现结束 ==================
+
+static int check(const char* what, uint8_t mode, uint32_t sw, uint32_t sh, uint32_t dw, uint32_t dh,
+                 uint32_t row_bytes, uint32_t stride) {
+    for (uint32_t y = 0; y < dh; y++) {
+        if (memcmp(&out[y * stride], &ref[y * stride], row_bytes) != 0) {
+            printf("FAIL %s/%s %ux%u->%ux%u: 第%u行不一致\n", what, mode_name[mode], sw, sh, dw, dh, y);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int test_correctness(void) {
+    static const uint32_t sizes[][4] = {
+        { 1, 1, 1, 1 }, { 1, 1, 7, 5 }, { 7, 5, 1, 1 }, { 17, 9, 33, 19 }, { 33, 19, 17, 9 },
+        { 640, 480, 320, 240 }, { 640, 480, 213, 160 }, { 320, 240, 640, 480 }, { 100, 75, 641, 479 },
+        { 1280, 960, 640, 480 }, { 1279, 719, 640, 360 }, { 640, 480, 31, 23 }, { 257, 3, 1, 1 },
+    };
+    int fail = 0;
+
+    for (uint32_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+        uint32_t sw = sizes[k][0], sh = sizes[k][1], dw = sizes[k][2], dh = sizes[k][3];
+        uint32_t gs = sw + 3, ps = (sw + 1) / 2 + 2, ogs = dw + 5, ops = (dw + 1) / 2 + 1;
+
+        for (uint8_t mode = PIX_SCALE_NEAREST; mode <= PIX_SCALE_BOX; mode++) {
+            pix_scale_t s;
+
+            if (pix_scale_init(&s, sw, sh, dw, dh, mode) != 0) {
+                printf("FAIL init %s %ux%u->%ux%u\n", mode_name[mode], sw, sh, dw, dh);
+                fail++;
+                continue;
+            }
+
+            // 灰度
+            for (uint32_t y = 0; y < dh; y++) {
+                for (uint32_t x = 0; x < dw; x++) ref[y * ogs + x] = ref_pixel(gray, gs, sw, sh, dw, dh, x, y, mode);
+            }
+            pix_scale_gray8(&s, gray, gs, out, ogs);
+            fail += check("gray8", mode, sw, sh, dw, dh, dw, ogs);
+
+            // 4bpp：参考实现在解包后的0~15上算
+            for (uint32_t y = 0; y < sh; y++) pix_unpack_4bpp(&packed[y * ps], &tmp[y * sw], sw);
+            memset(ref, 0, sizeof(ref));
+            for (uint32_t y = 0; y < dh; y++) {
+                for (uint32_t x = 0; x < dw; x++) {
+                    ref_put(&ref[y * ops], x, ref_pixel(tmp, sw, sw, sh, dw, dh, x, y, mode));
+                }
+            }
+            pix_scale_4bpp(&s, packed, ps, out, ops);
+            fail += check("4bpp", mode, sw, sh, dw, dh, (dw + 1) / 2, ops);
+
+            // 同一个对象再跑一次，结果不变（行缓存每次重置）
+            pix_scale_4bpp(&s, packed, ps, out, ops);
+            fail += check("4bpp(复用)", mode, sw, sh, dw, dh, (dw + 1) / 2, ops);
+            pix_scale_free(&s);
+        }
+    }
+
+    // 区域平均：平坦灰度缩小后不变
+    for (int level = 0; level < 256; level += 51) {
+        pix_scale_t s;
+
+        memset(tmp, level, 1280 * 960);
+        pix_scale_init(&s, 1280, 960, 37, 29, PIX_SCALE_BOX);
+        pix_scale_gray8(&s, tmp, 1280, out, 37);
+        for (uint32_t i = 0; i < 37 * 29; i++) {
+            if (out[i] != level) {
+                printf("FAIL 平坦灰度%d: 区域平均得到%d\n", level, out[i]);
+                fail++;
+                break;
+            }
+        }
+        pix_scale_free(&s);
+    }
+
+    // 超出区域平均的限制应当返回失败
+    {
+        pix_scale_t s;
+        if (pix_scale_init(&s, 1280, 960, 1, 1, PIX_SCALE_BOX) == 0) {
+            printf("FAIL 1280x960->1x1区域平均应当拒绝\n");
+            pix_scale_free(&s);
+            fail++;
+        }
+    }
+    return fail;
+}
+
+static void report(const char* name, uint32_t sw, uint32_t sh, uint32_t dw, uint32_t dh, uint64_t ns) {
+    printf("%-28s %4ux%-4u -> %4ux%-4u %8.2f ms/帧\n", name, sw, sh, dw, dh, ns / 1e6 / ROUNDS);
+}
+
+// 每帧耗时：原来的做法是RGB最近邻缩放再转4bpp；新做法源图事先转成灰度/4bpp（动画只转一次），
+// 每帧建表、缩放、转4bpp
+static void bench_case(uint32_t sw, uint32_t sh, uint32_t dw, uint32_t dh) {
+    uint64_t t;
+    pix_scale_t s;
+
+    t = now_ns();
+    for (int r = 0; r < ROUNDS; r++) {
+        uint8_t* scaled = scale_image_nearest(rgb, sw, sh, dw, dh);
+        for (uint32_t y = 0; y < dh; y++) {
+            pix_rgb_to_4bpp(&scaled[y * dw * 3], &out[y * ((dw + 1) / 2)], dw, PIX_ORDER_RGB);
+        }
+        free(scaled);
+    }
+    report("scale_image_nearest+4bpp", sw, sh, dw, dh, now_ns() - t);
+
+    for (uint8_t mode = PIX_SCALE_NEAREST; mode <= PIX_SCALE_BOX; mode++) {
+        char name[40];
+
+        if (mode == PIX_SCALE_BOX && (sw < dw || sh < dh)) continue;
+        t = now_ns();
+        for (int r = 0; r < ROUNDS; r++) {
+            pix_scale_init(&s, sw, sh, dw, dh, mode);
+            pix_scale_gray8(&s, gray, sw, tmp, dw);
+            pix_gray8_to_4bpp(tmp, out, dw * dh);
+            pix_scale_free(&s);
+        }
+        snprintf(name, sizeof(name), "gray8 %s+4bpp", mode_name[mode]);
+        report(name, sw, sh, dw, dh, now_ns() - t);
+
+        // 表建好后只缩放（相机预览每帧的情况）
+        pix_scale_init(&s, sw, sh, dw, dh, mode);
+        t = now_ns();
+        for (int r = 0; r < ROUNDS; r++) pix_scale_4bpp(&s, packed, (sw + 1) / 2, out, (dw + 1) / 2);
+        pix_scale_free(&s);
+        snprintf(name, sizeof(name), "4bpp %s", mode_name[mode]);
+        report(name, sw, sh, dw, dh, now_ns() - t);
+    }
+}
+
+int main(void) {
+    srand(1234);
+    for (uint32_t i = 0; i < sizeof(rgb); i++) rgb[i] = (uint8_t)rand();
+    for (uint32_t i = 0; i < sizeof(gray); i++) gray[i] = (uint8_t)rand();
+    for (uint32_t i = 0; i < sizeof(packed); i++) packed[i] = (uint8_t)rand();
+
+    printf("像素内核实现: %s\n", pix_impl_name());
+    int fail = test_correctness();
+    printf("正确性: %s (%d 项失败)\n", fail ? "FAIL" : "PASS", fail);
+
+    bench_case(1280, 960, 640, 480);
+    bench_case(640, 480, 320, 240);
+    bench_case(640, 480, 64, 48);
+    bench_case(320, 240, 640, 480);
+    return fail ? 1 : 0;
+}
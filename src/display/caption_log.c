@@ -0,0 +1,214 @@
+#include <stdio.h>
+#include <string.h>
+#include "caption_log.h"
+#include "hw_scroll.h"
+
+typedef struct {
+    char text[CAPTION_LINE_BYTES];
+} caption_line_t;
+
+typedef struct {
+    caption_line_t lines[CAPTION_LOG_LINES];
+    uint32_t head;      // 下一行的序号（只增，取模得到环中位置）
+    uint32_t count;     // 环中的有效行数
+    uint32_t top;       // 显示的第一行序号
+    uint32_t want_top;  // 滚动的目标：top追上它之前由定时器逐像素上移
+    lv_coord_t shift;   // top行已经上移出去的像素
+    lv_timer_t *timer;
+    bool open;          // 最后一行可以续写
+    const char *hint;   // 日志为空时显示
+} caption_log_t;
+
+static lv_coord_t row_height(lv_obj_t *obj) {
+    const lv_font_t *font = lv_obj_get_style_text_font(obj, LV_PART_MAIN);
+
+    return lv_font_get_line_height(font) + lv_obj_get_style_text_line_space(obj, LV_PART_MAIN);
+}
+
+static uint32_t visible_rows(lv_obj_t *obj) {
+    lv_coord_t rows = lv_obj_get_content_height(obj) / row_height(obj);
+
+    return rows > 0 ? (uint32_t)rows : 1;
+}
+
+// 序号为idx的行在屏幕上的区域（idx须不小于top）
+static void row_area(lv_obj_t *obj, const caption_log_t *log, uint32_t idx, lv_area_t *area) {
+    lv_coord_t h = row_height(obj);
+
+    lv_obj_get_content_coords(obj, area);
+    area->y1 += (lv_coord_t)(idx - log->top) * h - log->shift;
+    area->y2 = area->y1 + h - 1;
+}
+
+static void push_line(caption_log_t *log, const char *text, uint32_t len) {
+    caption_line_t *line = &log->lines[log->head % CAPTION_LOG_LINES];
+
+    memcpy(line->text, text, len);
+    line->text[len] = '\0';
+    log->head++;
+    if (log->count < CAPTION_LOG_LINES) log->count++;
+}
+
+static void caption_log_draw(lv_event_t *e) {
+    lv_obj_t *obj = lv_event_get_target(e);
+    caption_log_t *log = lv_obj_get_user_data(obj);
+    lv_draw_ctx_t *draw_ctx = lv_event_get_draw_ctx(e);
+    lv_draw_label_dsc_t dsc;
+    lv_area_t content, row, clip;
+
+    lv_draw_label_dsc_init(&dsc);
+    lv_obj_init_draw_label_dsc(obj, LV_PART_MAIN, &dsc);
+    lv_obj_get_content_coords(obj, &content);
+
+    // 只画与本次刷新区域相交的行；滚动中top行的上半部分已移出内容区
+    if (!_lv_area_intersect(&content, &content, draw_ctx->clip_area)) return;
+    if (log->count == 0 && log->hint != NULL) {
+        lv_obj_get_content_coords(obj, &row);
+        lv_draw_label(draw_ctx, &dsc, &row, log->hint, NULL);
+        return;
+    }
+    for (uint32_t i = log->top; i != log->head; i++) {
+        const lv_area_t *old_clip = draw_ctx->clip_area;
+
+        row_area(obj, log, i, &row);
+        if (row.y1 > content.y2) break;
+        if (!_lv_area_intersect(&clip, &row, &content)) continue;
+        draw_ctx->clip_area = &clip;
+        lv_draw_label(draw_ctx, &dsc, &row, log->lines[i % CAPTION_LOG_LINES].text, NULL);
+        draw_ctx->clip_area = old_clip;
+    }
+}
+
+static void stop_scroll(caption_log_t *log) {
+    if (log->timer != NULL) {
+        lv_timer_del(log->timer);
+        log->timer = NULL;
+    }
+    log->top = log->want_top;
+    log->shift = 0;
+}
+
+// 每个周期上移CAPTION_SCROLL_STEP像素，面板行原点跟着移动，只有新露出的部分上线
+static void caption_scroll_tick(lv_timer_t *timer) {
+    lv_obj_t *obj = timer->user_data;
+    caption_log_t *log = lv_obj_get_user_data(obj);
+    lv_coord_t h = row_height(obj);
+    lv_coord_t left = (lv_coord_t)(log->want_top - log->top) * h - log->shift;
+    lv_coord_t dy = left < CAPTION_SCROLL_STEP ? left : CAPTION_SCROLL_STEP;
+
+    log->shift += dy;
+    while (log->shift >= h) {
+        log->shift -= h;
+        log->top++;
+    }
+    // 控件在父容器（ui_TextContainer）的边框以内，不是整行宽度，面板行原点按占满整行的父容器移动；
+    // 父容器里的其他内容也跟着上移，随后整个父容器重绘，经影子缓冲比较后补回
+    hw_scroll_shift(lv_obj_get_parent(obj), dy);
+    if (log->top == log->want_top) stop_scroll(log);
+}
+
+static void caption_log_event(lv_event_t *e) {
+    lv_event_code_t code = lv_event_get_code(e);
+
+    if (code == LV_EVENT_DRAW_MAIN) {
+        caption_log_draw(e);
+    } else if (code == LV_EVENT_DELETE) {
+        caption_log_t *log = lv_obj_get_user_data(lv_event_get_target(e));
+        stop_scroll(log);
+        lv_mem_free(log);
+    }
+}
+
+lv_obj_t *caption_log_create(lv_obj_t *parent) {
+    lv_obj_t *obj = lv_obj_create(parent);
+    caption_log_t *log = lv_mem_alloc(sizeof(caption_log_t));
+
+    LV_ASSERT_MALLOC(log);
+    memset(log, 0, sizeof(caption_log_t));
+    lv_obj_set_user_data(obj, log);
+
+    // 不画背景和边框（背景由父容器画），自己不滚动
+    lv_obj_remove_style_all(obj);
+    lv_obj_clear_flag(obj, LV_OBJ_FLAG_SCROLLABLE | LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_event_cb(obj, caption_log_event, LV_EVENT_ALL, NULL);
+    return obj;
+}
+
+void caption_log_set_hint(lv_obj_t *obj, const char *text) {
+    caption_log_t *log = lv_obj_get_user_data(obj);
+
+    log->hint = text;
+    if (log->count == 0) lv_obj_invalidate(obj);
+}
+
+void caption_log_append(lv_obj_t *obj, const char *text, bool new_paragraph) {
+    caption_log_t *log = lv_obj_get_user_data(obj);
+    const lv_font_t *font = lv_obj_get_style_text_font(obj, LV_PART_MAIN);
+    lv_coord_t letter_space = lv_obj_get_style_text_letter_space(obj, LV_PART_MAIN);
+    lv_coord_t width = lv_obj_get_content_width(obj);
+    char joined[CAPTION_LINE_BYTES * 2];
+    const char *p = text;
+    uint32_t first = log->head;   // 第一条被改写的行
+    uint32_t rows, top;
+
+    // 提示文字可能比第一行长，整个换掉
+    if (log->count == 0 && log->hint != NULL) lv_obj_invalidate(obj);
+    // 续写时只把最后一行和新文本合起来重新折行，之前的行不动
+    if (!new_paragraph && log->open && log->count > 0) {
+        first = log->head - 1;
+        snprintf(joined, sizeof(joined), "%s%s", log->lines[first % CAPTION_LOG_LINES].text, text);
+        log->head--;
+        log->count--;
+        p = joined;
+    }
+
+    while (*p) {
+        uint32_t n = _lv_txt_get_next_line(p, font, letter_space, width, NULL, LV_TEXT_FLAG_NONE);
+        uint32_t len = n;
+
+        if (n == 0) break;
+        while (len > 0 && (p[len - 1] == '\n' || p[len - 1] == '\r')) len--;
+        // 一行放不下时在UTF-8字符边界截断，剩下的折到下一行
+        if (len > CAPTION_LINE_BYTES - 1) {
+            len = CAPTION_LINE_BYTES - 1;
+            while (len > 0 && ((uint8_t)p[len] & 0xC0) == 0x80) len--;
+            n = len;
+        }
+        push_line(log, p, len);
+        p += n;
+    }
+    log->open = true;
+
+    // 只显示最新的rows行：需要上移时逐像素滚上去（新行先画在下方，随滚动露出），
+    // 上移超过一屏或显示中的行已被覆盖时直接跳到最新
+    rows = visible_rows(obj);
+    top = log->head - (log->count < rows ? log->count : rows);
+    if (top > log->want_top && top - log->top <= rows && log->top >= log->head - log->count) {
+        log->want_top = top;
+        if (log->timer == NULL) {
+            log->timer = lv_timer_create(caption_scroll_tick, HW_SCROLL_PERIOD_MS, obj);
+        }
+    } else if (top != log->want_top) {
+        log->want_top = top;
+        stop_scroll(log);
+        lv_obj_invalidate(obj);
+        return;
+    }
+    // 只失效改写过的行（滚动中的定时器每步会失效整个对象）
+    for (uint32_t i = first; i != log->head; i++) {
+        lv_area_t row;
+        row_area(obj, log, i, &row);
+        lv_obj_invalidate_area(obj, &row);
+    }
+}
+
+void caption_log_clear(lv_obj_t *obj) {
+    caption_log_t *log = lv_obj_get_user_data(obj);
+
+    log->head = 0;
+    log->count = 0;
+    log->want_top = 0;
+    stop_scroll(log);
+    log->open = false;
+    lv_obj_invalidate(obj);
+}
@@ -0,0 +1,24 @@
+#ifndef CAPTION_LOG_H_
+#define CAPTION_LOG_H_
+
+#include <stdbool.h>
+#include "lvgl/lvgl.h"
+
+// 字幕日志控件：ASR/AI的流式文本只追加不修改
+// - 文本按控件宽度折行后存进行记录环，追加时只对新文本折行，旧行不再重新布局
+// - 只显示最新的几行，超出时逐像素平滑上移（面板行原点按父容器的区域移动，见hw_scroll.h，
+//   父容器须占满整行宽度，否则只按普通失效重绘）；
+//   最旧的行被新行覆盖，不再整段清空
+// - 没有滚动时只失效新写入的行，不再整屏失效、强制刷新
+// 字体、颜色、行距取对象的 text 样式；宽度和字体在追加第一条文本后不应再改变
+#define CAPTION_LOG_LINES 32        // 行记录环的行数（历史行数）
+#define CAPTION_LINE_BYTES 128      // 每行最多的UTF-8字节数（含结束符）
+#define CAPTION_SCROLL_STEP 6       // 平滑上移时每个周期移动的像素
+
+lv_obj_t *caption_log_create(lv_obj_t *parent);
+// 日志为空时显示的提示文字（不进记录环，第一条文本追加后消失；text须一直有效）
+void caption_log_set_hint(lv_obj_t *obj, const char *text);
+// new_paragraph为true时另起一行，否则接在最后一行后面（流式逐词追加）
+void caption_log_append(lv_obj_t *obj, const char *text, bool new_paragraph);
+void caption_log_clear(lv_obj_t *obj);
+#endif
@@ -0,0 +1,114 @@
+#include <stdint.h>
+#include <string.h>
+#include "disp_l4.h"
+#include "lvgl/src/draw/sw/lv_draw_sw.h"
+
+// lv_color_t（LV_COLOR_DEPTH 8）-> 0~15灰度
+static uint8_t l4_lut[256];
+static bool l4_lut_ready = false;
+
+static void l4_lut_init(void) {
+    for (uint32_t i = 0; i < 256; i++) {
+        lv_color_t c;
+        c.full = (uint8_t)i;
+        l4_lut[i] = lv_color_brightness(c) >> 4;
+    }
+    l4_lut_ready = true;
+}
+
+static inline uint8_t l4_get(const uint8_t *row, int32_t x) {
+    return (x & 1) ? (row[x >> 1] & 0x0F) : (row[x >> 1] >> 4);
+}
+
+static inline void l4_set(uint8_t *row, int32_t x, uint8_t gray) {
+    uint8_t *b = &row[x >> 1];
+    *b = (x & 1) ? (uint8_t)((*b & 0xF0) | gray) : (uint8_t)((*b & 0x0F) | (gray << 4));
+}
+
+static inline uint8_t l4_mix(uint8_t fg, uint8_t bg, lv_opa_t opa) {
+    return (uint8_t)((fg * opa + bg * (255 - opa) + 127) / 255);
+}
+
+// 不透明纯色填充一行：两端的半字节单独处理，中间整字节memset
+static void l4_fill_row(uint8_t *row, int32_t x1, int32_t x2, uint8_t gray) {
+    if (x1 & 1) {
+        l4_set(row, x1, gray);
+        x1++;
+    }
+    if (!(x2 & 1) && x2 >= x1) {
+        l4_set(row, x2, gray);
+        x2--;
+    }
+    if (x2 > x1) {
+        memset(&row[x1 >> 1], (gray << 4) | gray, (size_t)(x2 - x1 + 1) / 2);
+    }
+}
+
+// 与lv_draw_sw_blend_basic相同的裁剪和取址方式，目标换成打包的L4（只做普通混合）
+static void l4_blend(lv_draw_ctx_t *draw_ctx, const lv_draw_sw_blend_dsc_t *dsc) {
+    lv_disp_t *disp = _lv_refr_get_disp_refreshing();
+    lv_disp_draw_buf_t *draw_buf = disp->driver->draw_buf;
+    const lv_opa_t *mask;
+    lv_area_t blend_area;
+
+    // 不透明度图层等临时缓冲区是lv_color_t格式，交给默认实现
+    if (draw_ctx->buf != draw_buf->buf1 && draw_ctx->buf != draw_buf->buf2) {
+        lv_draw_sw_blend_basic(draw_ctx, dsc);
+        return;
+    }
+    if (dsc->mask_buf && dsc->mask_res == LV_DRAW_MASK_RES_TRANSP) return;
+    mask = dsc->mask_res == LV_DRAW_MASK_RES_FULL_COVER ? NULL : dsc->mask_buf;
+    if (!_lv_area_intersect(&blend_area, dsc->blend_area, draw_ctx->clip_area)) return;
+    if (!l4_lut_ready) l4_lut_init();
+
+    int32_t dest_stride = lv_area_get_width(draw_ctx->buf_area) / 2;
+    int32_t w = lv_area_get_width(&blend_area);
+    int32_t h = lv_area_get_height(&blend_area);
+    int32_t x0 = blend_area.x1 - draw_ctx->buf_area->x1;
+    uint8_t *dest = (uint8_t *)draw_ctx->buf + (blend_area.y1 - draw_ctx->buf_area->y1) * dest_stride;
+
+    const lv_color_t *src = dsc->src_buf;
+    int32_t src_stride = 0;
+    if (src) {
+        src_stride = lv_area_get_width(dsc->blend_area);
+        src += src_stride * (blend_area.y1 - dsc->blend_area->y1) + (blend_area.x1 - dsc->blend_area->x1);
+    }
+    int32_t mask_stride = 0;
+    if (mask) {
+        mask_stride = lv_area_get_width(dsc->mask_area);
+        mask += mask_stride * (blend_area.y1 - dsc->mask_area->y1) + (blend_area.x1 - dsc->mask_area->x1);
+    }
+
+    uint8_t fill = l4_lut[dsc->color.full];
+    lv_opa_t opa = dsc->opa;
+
+    for (int32_t y = 0; y < h; y++) {
+        if (src == NULL && mask == NULL && opa >= LV_OPA_MAX) {
+            l4_fill_row(dest, x0, x0 + w - 1, fill);
+        } else {
+            for (int32_t x = 0; x < w; x++) {
+                uint8_t fg = src ? l4_lut[src[x].full] : fill;
+                lv_opa_t a = opa;
+
+                if (mask) {
+                    a = a >= LV_OPA_MAX ? mask[x] : (lv_opa_t)((a * mask[x]) >> 8);
+                }
+                if (a <= LV_OPA_MIN) continue;
+                if (a >= LV_OPA_MAX) {
+                    l4_set(dest, x0 + x, fg);
+                } else {
+                    l4_set(dest, x0 + x, l4_mix(fg, l4_get(dest, x0 + x), a));
+                }
+            }
+        }
+        dest += dest_stride;
+        if (src) src += src_stride;
+        if (mask) mask += mask_stride;
+    }
+}
+
+// 作为disp_drv.draw_ctx_init：先按软件绘制初始化，再换掉blend
+void disp_l4_draw_ctx_init(lv_disp_drv_t *drv, lv_draw_ctx_t *draw_ctx) {
+    lv_draw_sw_init_ctx(drv, draw_ctx);
+    ((lv_draw_sw_ctx_t *)draw_ctx)->blend = l4_blend;
+}
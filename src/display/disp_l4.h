@@ -0,0 +1,16 @@
+#ifndef DISP_L4_H_
+#define DISP_L4_H_
+
+#include "lvgl/lvgl.h"
+
+// LVGL原生4bpp灰度绘制：替换软件绘制上下文的blend，直接往打包的L4缓冲区
+// （每字节2像素，高4位在前，与面板写缓存格式相同）里合成，flush时不再转换
+//
+// 要求：rounder把刷新区域对齐到偶数x1、奇数x2，每行正好整字节；
+// 绘制缓冲区按 宽*高/2 字节分配，lv_disp_draw_buf_init 的大小仍按像素数给出
+// 不透明度图层（lv_obj_set_style_opa等）的临时缓冲区仍为lv_color_t格式，
+// 照常由LVGL绘制，合成回显示缓冲区时再转换
+#define DISP_L4_BUF_SIZE(px) ((px) / 2)
+
+void disp_l4_draw_ctx_init(lv_disp_drv_t *drv, lv_draw_ctx_t *draw_ctx);
+#endif
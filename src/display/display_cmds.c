@@ -0,0 +1,82 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "display_cmds.h"
+
+// 命令文本 -> 命令的完美哈希：启动时从命令表挑一个种子，使所有命令落在不同的桶里，
+// 查找就是一次哈希加一次strcmp，与命令数量无关
+#define CMD_HASH_BITS 8
+#define CMD_HASH_SIZE (1u << CMD_HASH_BITS)     // 至少为命令数的4倍，几十次尝试就能找到种子
+#define CMD_HASH_MAX_SEED 65536
+
+#define DISPLAY_CMD_TEXT(id, handler, text) [id] = text,
+static const char *const cmd_text[DISPLAY_CMD_COUNT] = {
+    DISPLAY_CMD_LIST(DISPLAY_CMD_TEXT)
+    DISPLAY_CMD_PREFIX_LIST(DISPLAY_CMD_TEXT)
+};
+#undef DISPLAY_CMD_TEXT
+
+#define DISPLAY_CMD_ID(id, handler, text) id,
+static const uint8_t prefix_cmds[] = { DISPLAY_CMD_PREFIX_LIST(DISPLAY_CMD_ID) };
+#undef DISPLAY_CMD_ID
+#define EXACT_CMD_COUNT (DISPLAY_CMD_COUNT - (int)sizeof(prefix_cmds))
+
+typedef char cmd_hash_size_check[(EXACT_CMD_COUNT * 4 <= CMD_HASH_SIZE) ? 1 : -1];
+
+static uint8_t cmd_bucket[CMD_HASH_SIZE];    // 命令序号+1，0为空桶
+static uint32_t cmd_seed;
+static int cmd_hash_ready = 0;
+
+// FNV-1a，种子作为初始值的扰动
+static uint32_t cmd_hash(const char *s, uint32_t seed) {
+    uint32_t h = 2166136261u ^ seed;
+
+    while (*s) {
+        h ^= (uint8_t)*s++;
+        h *= 16777619u;
+    }
+    return (h ^ (h >> 15)) & (CMD_HASH_SIZE - 1);
+}
+
+void display_cmds_init(void) {
+    for (uint32_t seed = 0; seed < CMD_HASH_MAX_SEED; seed++) {
+        int ok = 1;
+
+        memset(cmd_bucket, 0, sizeof(cmd_bucket));
+        for (int i = 0; i < EXACT_CMD_COUNT && ok; i++) {
+            uint32_t b = cmd_hash(cmd_text[i], seed);
+            if (cmd_bucket[b] != 0) {
+                ok = 0;
+            } else {
+                cmd_bucket[b] = (uint8_t)(i + 1);
+            }
+        }
+        if (ok) {
+            cmd_seed = seed;
+            cmd_hash_ready = 1;
+            return;
+        }
+    }
+    // 找不到种子（命令表太大）时退化成逐个比较
+    printf("display_cmds_init: 未找到无冲突的哈希种子，改为逐个比较\n");
+}
+
+int display_cmd_lookup(const char *text) {
+    if (cmd_hash_ready) {
+        int idx = cmd_bucket[cmd_hash(text, cmd_seed)] - 1;
+        if (idx >= 0 && strcmp(cmd_text[idx], text) == 0) {
+            return idx;
+        }
+    } else {
+        for (int i = 0; i < EXACT_CMD_COUNT; i++) {
+            if (strcmp(cmd_text[i], text) == 0) return i;
+        }
+    }
+    for (size_t i = 0; i < sizeof(prefix_cmds); i++) {
+        const char *p = cmd_text[prefix_cmds[i]];
+        if (strncmp(text, p, strlen(p)) == 0) {
+            return prefix_cmds[i];
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,91 @@
+#ifndef DISPLAY_CMDS_H_
+#define DISPLAY_CMDS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// display接受的文本命令表，发送方（touchpad_manager、btgatt-server、FFlaunch）和
+// display共用这一份：X(枚举, display中的处理函数, 命令文本)
+// display按枚举生成 命令文本 -> 处理函数 的表，少写一个处理函数就编译不过；
+// 发送方用 display_cmd_str(枚举) 取文本，不再手写字符串
+// 不在表里的文本按普通字幕显示
+#define DISPLAY_CMD_LIST(X) \
+    X(DISPLAY_CMD_GPIOA,             cmd_gpioa,             "GPIOA") \
+    X(DISPLAY_CMD_BRIGHT_UP,         cmd_bright_up,         "Bright++") \
+    X(DISPLAY_CMD_CAMERA,            cmd_camera,            "CamerA") \
+    X(DISPLAY_CMD_RECORD,            cmd_record,            "Record") \
+    X(DISPLAY_CMD_AI_TALK,           cmd_ai_talk,           "AiTalk") \
+    X(DISPLAY_CMD_BLE_DISCONNECTED,  cmd_ble_disconnected,  "BLE DissCon") \
+    X(DISPLAY_CMD_PHONE_CONNECTED,   cmd_phone_connected,   "Phone ConnecTed") \
+    X(DISPLAY_CMD_RECORDER,          cmd_recorder,          "RecorDeR") \
+    X(DISPLAY_CMD_BRIGHTNESS,        cmd_brightness,        "Brightness") \
+    X(DISPLAY_CMD_ALBUM_SYNC,        cmd_album_sync,        "BLE:AlbumSync") \
+    X(DISPLAY_CMD_PHOTO_FINISHED,    cmd_photo_finished,    "Finish-Photo") \
+    X(DISPLAY_CMD_RECORDER_WORKING,  cmd_recorder_working,  "RecorDeRworking") \
+    X(DISPLAY_CMD_RECORDER_END,      cmd_recorder_end,      "RecorDeR-End") \
+    X(DISPLAY_CMD_TRANSLATE_ON,      cmd_translate_on,      "TranslatE-ON") \
+    X(DISPLAY_CMD_NAVIGATE_ON,       cmd_navigate_on,       "NavigaT-ON") \
+    X(DISPLAY_CMD_IMU_TEST_ON,       cmd_imu_test_on,       "IMUtest-ON") \
+    X(DISPLAY_CMD_TELEPROMPTER,      cmd_teleprompter,      "TelePrompTer") \
+    X(DISPLAY_CMD_TELEPROMPTER_NEXT, cmd_teleprompter_next, "TelePrompTerNextParagraph") \
+    X(DISPLAY_CMD_TELEPROMPTER_PREV, cmd_teleprompter_prev, "TelePrompTerPrevParagraph") \
+    X(DISPLAY_CMD_TELEPROMPTER_SCROLL, cmd_teleprompter_scroll, "TelePrompTerScroll") \
+    X(DISPLAY_CMD_FFM_FINISHED,      cmd_ffm_finished,      "FFmFinished") \
+    X(DISPLAY_CMD_VIDEO_RECORDING,   cmd_video_recording,   "VideoRecing") \
+    X(DISPLAY_CMD_VIDEO_FINISHED,    cmd_video_finished,    "Finish-Video") \
+    X(DISPLAY_CMD_TURN_LEFT,         cmd_ignore,            "TurnLefT") \
+    X(DISPLAY_CMD_TURN_RIGHT,        cmd_ignore,            "TurnRighT") \
+    X(DISPLAY_CMD_GO_STRAIGHT,       cmd_ignore,            "GoStraighT") \
+    X(DISPLAY_CMD_MEMO,              cmd_memo,              "MeMo") \
+    X(DISPLAY_CMD_MEMO_DISPLAY,      cmd_memo_display,      "MeMoDisplay") \
+    X(DISPLAY_CMD_MORE,              cmd_more,              "MoRe") \
+    X(DISPLAY_CMD_TRANSLATE,         cmd_translate,         "TranslatE") \
+    X(DISPLAY_CMD_NAVIGATE,          cmd_navigate,          "NavigaT") \
+    X(DISPLAY_CMD_DISPLAY_PHOTO,     cmd_display_photo,     "DisplayPhoto") \
+    X(DISPLAY_CMD_DISPLAY_PHOTO_ON,  cmd_display_photo_on,  "DisplayPhoto-ON") \
+    X(DISPLAY_CMD_FONT_SIZE_ON,      cmd_font_size_on,      "FontSize-ON") \
+    X(DISPLAY_CMD_ASR,               cmd_asr,               "bd_ASR") \
+    X(DISPLAY_CMD_SLEEP,             cmd_sleep,             "SleeP") \
+    X(DISPLAY_CMD_FONT_SIZE,         cmd_font_size,         "FontSize") \
+    X(DISPLAY_CMD_QUIT,              cmd_quit,              "QuiT") \
+    X(DISPLAY_CMD_QUITED,            cmd_quited,            "QuiTed") \
+    X(DISPLAY_CMD_INTO_SLEEP,        cmd_into_sleep,        "IntoSleep") \
+    X(DISPLAY_CMD_IMU_TEST,          cmd_imu_test,          "IMUtest") \
+    X(DISPLAY_CMD_INIT,              cmd_ignore,            "init") \
+    X(DISPLAY_CMD_FINISHED,          cmd_finished,          "finished") \
+    X(DISPLAY_CMD_RECORDING,         cmd_recording,         "Recording") \
+    X(DISPLAY_CMD_UPLOAD,            cmd_upload,            "Upload") \
+    X(DISPLAY_CMD_PROCESSING,        cmd_processing,        "ProceSSing")
+
+// 按前缀匹配的命令（后面带参数），只在精确匹配失败后逐个比较
+#define DISPLAY_CMD_PREFIX_LIST(X) \
+    X(DISPLAY_CMD_METER,             cmd_ignore,            "MeTeR")
+
+#define DISPLAY_CMD_ENUM(id, handler, text) id,
+typedef enum {
+    DISPLAY_CMD_LIST(DISPLAY_CMD_ENUM)
+    DISPLAY_CMD_PREFIX_LIST(DISPLAY_CMD_ENUM)
+    DISPLAY_CMD_COUNT
+} display_cmd_t;
+#undef DISPLAY_CMD_ENUM
+
+#define DISPLAY_CMD_CASE(id, handler, text) case id: return text;
+static inline const char *display_cmd_str(display_cmd_t cmd) {
+    switch (cmd) {
+    DISPLAY_CMD_LIST(DISPLAY_CMD_CASE)
+    DISPLAY_CMD_PREFIX_LIST(DISPLAY_CMD_CASE)
+    default: return "";
+    }
+}
+#undef DISPLAY_CMD_CASE
+
+// 以下只在display中实现（display_cmds.c）
+// 文本 -> 命令；不是命令时返回-1
+void display_cmds_init(void);
+int display_cmd_lookup(const char *text);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,316 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "doc_pager.h"
+
+// 在UTF-8字符边界上截断：len之后的字节不是续字节
+static uint32_t utf8_floor(const char *s, uint32_t len) {
+    while (len > 0 && ((uint8_t)s[len] & 0xC0) == 0x80) len--;
+    return len;
+}
+
+static bool same_layout(const doc_layout_t *a, const doc_layout_t *b) {
+    return a->font == b->font && a->letter_space == b->letter_space &&
+           a->width == b->width && a->rows == b->rows;
+}
+
+// 先占一段比文件多至少一个字节的匿名内存，再把文件映射到开头：
+// 文件最后一页超出文件长度的部分和后面的匿名页都是0，文本总以'\0'结尾，
+// 可以直接交给_lv_txt_get_next_line
+static int map_file(doc_pager_t *pg, int fd, size_t size) {
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t len = (size + 1 + page - 1) & ~(page - 1);
+    void *base = mmap(NULL, len, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (base == MAP_FAILED) {
+        perror("doc_pager: mmap");
+        return -1;
+    }
+    if (size > 0 && mmap(base, size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        perror("doc_pager: mmap file");
+        munmap(base, len);
+        return -1;
+    }
+    pg->data = base;
+    pg->fd = fd;
+    pg->size = size;
+    pg->map_len = len;
+    return 0;
+}
+
+int doc_pager_open(doc_pager_t *pg, const char *path, const doc_layout_t *layout) {
+    struct stat st;
+    int fd;
+
+    if (stat(path, &st) < 0) {
+        doc_pager_close(pg);
+        return -1;
+    }
+    if (pg->data != NULL && strcmp(pg->path, path) == 0 && (size_t)st.st_size == pg->size &&
+        st.st_mtime == pg->mtime && same_layout(&pg->layout, layout)) {
+        return 0;
+    }
+
+    doc_pager_close(pg);
+    if (st.st_size >= UINT32_MAX) {
+        printf("doc_pager: %s 太大\n", path);
+        return -1;
+    }
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        perror("doc_pager: open");
+        return -1;
+    }
+    if (map_file(pg, fd, (size_t)st.st_size) < 0) {
+        close(fd);
+        return -1;
+    }
+
+    pg->page_cap = 64;
+    pg->pages = malloc(pg->page_cap * sizeof(uint32_t));
+    if (pg->pages == NULL) {
+        perror("doc_pager: malloc");
+        doc_pager_close(pg);
+        return -1;
+    }
+    pg->pages[0] = 0;
+    pg->page_num = 0;
+    pg->complete = false;
+    pg->shown = false;
+    pg->cur = 0;
+    pg->path = path;
+    pg->mtime = st.st_mtime;
+    pg->layout = *layout;
+    pg->version++;
+    return 0;
+}
+
+void doc_pager_close(doc_pager_t *pg) {
+    if (pg->data != NULL) {
+        munmap((void *)pg->data, pg->map_len);
+        close(pg->fd);
+        pg->data = NULL;
+    }
+    free(pg->pages);
+    pg->pages = NULL;
+    pg->page_num = 0;
+    pg->page_cap = 0;
+    pg->size = 0;
+    pg->shown = false;
+}
+
+// 映射后文件被截短，读到文件末尾之后的页会SIGBUS；改写后页索引也不再对应。
+// 大小或修改时间变了就关闭文档
+static bool file_unchanged(doc_pager_t *pg) {
+    struct stat st;
+
+    if (fstat(pg->fd, &st) == 0 && (size_t)st.st_size == pg->size && st.st_mtime == pg->mtime) {
+        return true;
+    }
+    printf("doc_pager: %s 已被改写，关闭\n", pg->path);
+    doc_pager_close(pg);
+    return false;
+}
+
+// 从上一页的终点排一页：最多rows行，最多DOC_PAGE_MAX_BYTES-1字节
+static bool build_next_page(doc_pager_t *pg) {
+    const doc_layout_t *lay = &pg->layout;
+    uint32_t start = pg->pages[pg->page_num];
+    uint32_t off = start;
+
+    // 空文件也有一页（空白页）
+    if (start >= pg->size && pg->page_num > 0) {
+        pg->complete = true;
+        return false;
+    }
+    if (pg->page_num + 2 > pg->page_cap) {
+        uint32_t *pages = realloc(pg->pages, pg->page_cap * 2 * sizeof(uint32_t));
+        if (pages == NULL) {
+            perror("doc_pager: realloc");
+            return false;
+        }
+        pg->pages = pages;
+        pg->page_cap *= 2;
+    }
+
+    for (uint32_t row = 0; row < lay->rows && off < pg->size; row++) {
+        uint32_t n = _lv_txt_get_next_line(pg->data + off, lay->font, lay->letter_space,
+                                           lay->width, NULL, LV_TEXT_FLAG_NONE);
+        if (n == 0) n = 1;          // 文件中间的'\0'：跳过
+        if (off + n - start > DOC_PAGE_MAX_BYTES - 1) {
+            // 放不下整行：行首就放不下时在字符边界截断，否则这一行留到下一页
+            // 开头全是续字节（不是合法的UTF-8）时utf8_floor为0，至少前进一个字节，不能排出空页
+            if (row == 0) {
+                uint32_t len = utf8_floor(pg->data + start, DOC_PAGE_MAX_BYTES - 1);
+                off = start + (len > 0 ? len : 1);
+            }
+            break;
+        }
+        off += n;
+    }
+
+    pg->page_num++;
+    pg->pages[pg->page_num] = off;
+    if (off >= pg->size) pg->complete = true;
+    return true;
+}
+
+bool doc_pager_has_page(doc_pager_t *pg, uint32_t idx) {
+    if (pg->data == NULL || !file_unchanged(pg)) return false;
+    while (idx >= pg->page_num) {
+        if (pg->complete || !build_next_page(pg)) return false;
+    }
+    return true;
+}
+
+int doc_pager_page(doc_pager_t *pg, uint32_t idx, char *buf, size_t size) {
+    uint32_t start, len;
+
+    if (size == 0 || !doc_pager_has_page(pg, idx)) return -1;
+    start = pg->pages[idx];
+    len = pg->pages[idx + 1] - start;
+    if (len > size - 1) len = utf8_floor(pg->data + start, (uint32_t)size - 1);
+    memcpy(buf, pg->data + start, len);
+    buf[len] = '\0';
+    return (int)len;
+}
+
+uint32_t doc_pager_page_rows(doc_pager_t *pg, uint32_t idx) {
+    const doc_layout_t *lay = &pg->layout;
+    uint32_t off, end, rows = 0;
+
+    if (!doc_pager_has_page(pg, idx)) return 0;
+    end = pg->pages[idx + 1];
+    for (off = pg->pages[idx]; off < end; rows++) {
+        uint32_t n = _lv_txt_get_next_line(pg->data + off, lay->font, lay->letter_space,
+                                           lay->width, NULL, LV_TEXT_FLAG_NONE);
+        off += n > 0 ? n : 1;
+    }
+    return rows;
+}
+
+uint32_t doc_pager_peek(doc_pager_t *pg, uint32_t idx, int step) {
+    if (step > 0) return doc_pager_has_page(pg, idx + 1) ? idx + 1 : 0;
+    if (step < 0) return idx > 0 ? idx - 1 : 0;
+    return idx;
+}
+
+uint32_t doc_pager_step(doc_pager_t *pg, int step) {
+    if (!pg->shown) {
+        pg->shown = true;
+        pg->cur = 0;
+    } else {
+        pg->cur = doc_pager_peek(pg, pg->cur, step);
+    }
+    return pg->cur;
+}
+
+// ================== 双标签显示 ==================
+static char page_buf[DOC_PAGE_MAX_BYTES];   // 只在LVGL线程使用
+static char run_buf[DOC_PAGE_MAX_BYTES * 2];
+
+static void set_page(lv_obj_t *label, doc_pager_t *pg, uint32_t idx) {
+    if (doc_pager_page(pg, idx, page_buf, sizeof(page_buf)) < 0) page_buf[0] = '\0';
+    lv_label_set_text(label, page_buf);
+}
+
+void doc_view_init(doc_view_t *view, lv_obj_t *label) {
+    lv_obj_t *back = lv_label_create(lv_obj_get_parent(label));
+
+    // 与label同位置、同样式
+    lv_obj_set_width(back, LV_PCT(100));
+    lv_obj_set_height(back, LV_SIZE_CONTENT);
+    lv_obj_set_align(back, LV_ALIGN_TOP_LEFT);
+    lv_label_set_long_mode(back, LV_LABEL_LONG_WRAP);
+    lv_label_set_text(back, "");
+    lv_obj_set_style_text_font(back, lv_obj_get_style_text_font(label, LV_PART_MAIN), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_line_space(back, lv_obj_get_style_text_line_space(label, LV_PART_MAIN), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_letter_space(back, lv_obj_get_style_text_letter_space(label, LV_PART_MAIN), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_color(back, lv_obj_get_style_text_color(label, LV_PART_MAIN), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_align(back, lv_obj_get_style_text_align(label, LV_PART_MAIN), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_add_flag(back, LV_OBJ_FLAG_HIDDEN);
+
+    view->label[0] = label;
+    view->label[1] = back;
+    view->front = 0;
+    view->back_doc = NULL;
+}
+
+// 行宽取标签的内容宽度，行数取父容器的内容高度能放下的整行数
+void doc_view_get_layout(const doc_view_t *view, doc_layout_t *layout) {
+    lv_obj_t *label = view->label[view->front];
+    lv_coord_t line_space = lv_obj_get_style_text_line_space(label, LV_PART_MAIN);
+    lv_coord_t row_h;
+    lv_coord_t rows;
+
+    lv_obj_update_layout(label);
+    layout->font = lv_obj_get_style_text_font(label, LV_PART_MAIN);
+    layout->letter_space = lv_obj_get_style_text_letter_space(label, LV_PART_MAIN);
+    layout->width = lv_obj_get_content_width(label);
+    row_h = lv_font_get_line_height(layout->font) + line_space;
+    rows = (lv_obj_get_content_height(lv_obj_get_parent(label)) + line_space) / row_h;
+    layout->rows = rows > 0 ? (uint32_t)rows : 1;
+}
+
+void doc_view_show(doc_view_t *view, doc_pager_t *pg) {
+    lv_obj_t *parent = lv_obj_get_parent(view->label[view->front]);
+    uint8_t back = view->front ^ 1;
+    uint32_t next;
+
+    // 连续滚动过后回到顶部
+    if (lv_obj_get_scroll_y(parent) != 0) lv_obj_scroll_to_y(parent, 0, LV_ANIM_OFF);
+
+    if (view->back_doc == pg && view->back_version == pg->version && view->back_page == pg->cur) {
+        // 这一页已经预排在隐藏标签里：只交换隐藏标志
+        lv_obj_clear_flag(view->label[back], LV_OBJ_FLAG_HIDDEN);
+        lv_obj_add_flag(view->label[view->front], LV_OBJ_FLAG_HIDDEN);
+        view->front = back;
+        back ^= 1;
+    } else {
+        set_page(view->label[view->front], pg, pg->cur);
+    }
+
+    // 隐藏的标签设置文本时只排版，不重画
+    next = doc_pager_peek(pg, pg->cur, 1);
+    set_page(view->label[back], pg, next);
+    view->back_doc = pg;
+    view->back_version = pg->version;
+    view->back_page = next;
+}
+
+void doc_view_show_run(doc_view_t *view, doc_pager_t *pg) {
+    int len = doc_pager_page(pg, pg->cur, run_buf, DOC_PAGE_MAX_BYTES);
+
+    if (len < 0) len = 0;
+    if (doc_pager_page(pg, pg->cur + 1, run_buf + len, DOC_PAGE_MAX_BYTES) < 0) run_buf[len] = '\0';
+    lv_label_set_text(view->label[view->front], run_buf);
+    view->back_doc = NULL;      // 隐藏标签不再是预排的下一页
+}
+
+bool doc_view_run_advance(doc_view_t *view, doc_pager_t *pg) {
+    lv_obj_t *label = view->label[view->front];
+    lv_obj_t *parent = lv_obj_get_parent(label);
+    lv_coord_t row_h;
+    uint32_t rows;
+
+    if (!doc_pager_has_page(pg, pg->cur + 2)) return false;
+    row_h = lv_font_get_line_height(pg->layout.font) + lv_obj_get_style_text_line_space(label, LV_PART_MAIN);
+    rows = doc_pager_page_rows(pg, pg->cur);
+    pg->cur++;
+    doc_view_show_run(view, pg);
+    // 去掉了开头的一页，滚动位置同样上移一页，画面不变（重绘后影子缓冲比较不出差别）
+    lv_obj_update_layout(label);
+    lv_obj_scroll_to_y(parent, lv_obj_get_scroll_y(parent) - (lv_coord_t)rows * row_h, LV_ANIM_OFF);
+    return true;
+}
+
+void doc_view_set_text(doc_view_t *view, const char *text) {
+    lv_label_set_text(view->label[view->front], text);
+    view->back_doc = NULL;
+}
+// ================== 双标签显示结束 ==================
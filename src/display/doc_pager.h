@@ -0,0 +1,81 @@
+#ifndef DOC_PAGER_H_
+#define DOC_PAGER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <time.h>
+#include "lvgl/lvgl.h"
+
+// 文档分页：提词器、电话本、备忘录等文本文件
+// - 整个文件mmap一次，之后翻页不再fopen/fseek/fread
+// - 页索引按显示控件的字体、宽度和行数切分，断点都在UTF-8字符或行边界上
+// - 页索引按需向后扩展（每页只排一次版），已排过的页前后翻都只是查表
+// - 文件被改写（大小或修改时间变化）或布局变化后重新映射，从第一页开始
+// - 映射期间保留fd，每次排版/拷贝前fstat：文件被截短后再读映射会SIGBUS，
+//   发现大小或修改时间变了就关闭文档（下一次doc_pager_open重新映射）
+// 只在LVGL线程调用（排版要读字体，字体的字形缓存不是线程安全的）
+#define DOC_PAGE_MAX_BYTES 1024     // 一页最多的UTF-8字节数（含结束符）
+
+typedef struct {
+    const lv_font_t *font;
+    lv_coord_t letter_space;
+    lv_coord_t width;               // 行宽（像素）
+    uint32_t rows;                  // 每页行数
+} doc_layout_t;
+
+typedef struct {
+    const char *path;
+    const char *data;               // 文件内容，后面保证有一个'\0'
+    size_t size;
+    size_t map_len;
+    int fd;                         // data不为NULL时有效
+    time_t mtime;
+    doc_layout_t layout;
+    uint32_t *pages;                // pages[i]为第i页的起始偏移，pages[page_num]为下一页起点
+    uint32_t page_num;              // 已排好的页数
+    uint32_t page_cap;
+    bool complete;                  // 已排到文件末尾
+    bool shown;                     // cur是否已显示过
+    uint32_t cur;                   // 当前显示的页
+    uint32_t version;               // 每次重新映射加一，显示端据此判断预排的页是否过期
+} doc_pager_t;
+
+// 打开或复用：文件和布局都没变时直接返回0，否则重新映射、清空页索引；失败返回-1
+int doc_pager_open(doc_pager_t *pg, const char *path, const doc_layout_t *layout);
+void doc_pager_close(doc_pager_t *pg);
+// 第idx页是否存在（需要时向后排版到这一页）；文件已被改写时关闭文档，返回false
+bool doc_pager_has_page(doc_pager_t *pg, uint32_t idx);
+// 把第idx页拷到buf（带结束符），返回字节数；页不存在返回-1
+int doc_pager_page(doc_pager_t *pg, uint32_t idx, char *buf, size_t size);
+// step>0前进一页，step<0后退一页，返回新的当前页：第一次调用返回第0页，
+// 最后一页之后回到第0页，第0页之前停在第0页
+uint32_t doc_pager_step(doc_pager_t *pg, int step);
+// 第idx页排了几行；页不存在返回0
+uint32_t doc_pager_page_rows(doc_pager_t *pg, uint32_t idx);
+// 从idx按step翻一页会到哪一页（不改变当前页），用于预排下一页
+uint32_t doc_pager_peek(doc_pager_t *pg, uint32_t idx, int step);
+
+// 双标签显示：一个标签显示当前页，另一个隐藏的标签预先放好下一页的文本（已排版），
+// 下一页只需交换两个标签的隐藏标志
+typedef struct {
+    lv_obj_t *label[2];
+    uint8_t front;                  // label[front]为显示中的标签
+    doc_pager_t *back_doc;          // 隐藏标签里放的是哪个文档的哪一页，NULL为无效
+    uint32_t back_version;
+    uint32_t back_page;
+} doc_view_t;
+
+// 在label旁边创建一个同样式的隐藏标签
+void doc_view_init(doc_view_t *view, lv_obj_t *label);
+void doc_view_get_layout(const doc_view_t *view, doc_layout_t *layout);
+// 显示pg的当前页，并把下一页预排到隐藏标签
+void doc_view_show(doc_view_t *view, doc_pager_t *pg);
+// 连续滚动（提词器自动滚动）：标签放当前页和下一页，父容器逐像素滚动（hw_scroll.h）
+void doc_view_show_run(doc_view_t *view, doc_pager_t *pg);
+// 滚到底时调用：当前页后移一页并补上新的下一页，滚动位置同步上移，画面不变；
+// 已到文档末尾返回false
+bool doc_view_run_advance(doc_view_t *view, doc_pager_t *pg);
+// 显示普通文本（错误提示等）
+void doc_view_set_text(doc_view_t *view, const char *text);
+#endif
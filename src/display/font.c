@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/time.h>
+#include <string.h>
 #include <font.h>
 #include "lv_font_montserrat_48.c"
 
@@ -9,104 +10,208 @@
 int x_clr, y_clr = 0;
 int x_write, y_write = 0;
 
-// 定义字符区域结构体
+// 定义字符区域结构体（行为top/bottom，列为left/right，半开区间）
 typedef struct {
     int top;        // 上边界
     int bottom;     // 下边界
     int left;       // 左边界
     int right;      // 右边界
+    uint32_t line;  // 写入时的行序号，同一行的字符互不清除
 } area;
 
-// 字符区域指针
-size_t size = 0;
-area* areas = NULL;
+// ================== 字符区域索引 ==================
+// 区域记录放在固定大小的池里，用位图分配；屏幕按AREA_CELL像素分成粗网格，
+// 每个格子用位图记下与它相交的区域，查重叠时只需把覆盖到的格子的位图或起来再逐个精确比较，
+// 不再逐点线性扫描整个数组，也不再每次增删都realloc
+#define AREA_POOL_MAX 512           // 最多同时记录的字符区域（640x480按最小字号也放不满）
+#define AREA_CELL 32
+#define AREA_GRID_COLS (640 / AREA_CELL)
+#define AREA_GRID_ROWS (480 / AREA_CELL)
+#define AREA_WORDS (AREA_POOL_MAX / 64)
+
+static area area_pool[AREA_POOL_MAX];
+static uint64_t area_used[AREA_WORDS];
+static uint64_t area_grid[AREA_GRID_ROWS][AREA_GRID_COLS][AREA_WORDS];
+static uint32_t area_line = 0;      // 当前行序号，每合成一行加一
+
+// 区域覆盖的格子范围，完全在屏幕外返回false
+static bool area_cells(const area* a, int* r0, int* r1, int* c0, int* c1) {
+    if (a->bottom <= 0 || a->right <= 0 || a->top >= 480 || a->left >= 640 ||
+        a->bottom <= a->top || a->right <= a->left) {
+        return false;
+    }
+    *r0 = a->top > 0 ? a->top / AREA_CELL : 0;
+    *c0 = a->left > 0 ? a->left / AREA_CELL : 0;
+    *r1 = (a->bottom >= 480 ? 479 : a->bottom - 1) / AREA_CELL;
+    *c1 = (a->right >= 640 ? 639 : a->right - 1) / AREA_CELL;
+    return true;
+}
+
+static void area_link(int id, bool set) {
+    int r0, r1, c0, c1;
+    uint64_t bit = 1ull << (id % 64);
+
+    if (!area_cells(&area_pool[id], &r0, &r1, &c0, &c1)) return;
+    for (int r = r0; r <= r1; r++) {
+        for (int c = c0; c <= c1; c++) {
+            if (set) {
+                area_grid[r][c][id / 64] |= bit;
+            } else {
+                area_grid[r][c][id / 64] &= ~bit;
+            }
+        }
+    }
+}
 
-// 向数组中添加新的字符区域
+// 向池中添加新的字符区域
+// 空区域（换行等步进为0的字符）和完全在屏幕外的区域不进网格，以后也查不到、释放不了，不占池
 int add_area(area new_area) {
-    // 扩展数组大小
-    area* new_array = realloc(areas, (size + 1) * sizeof(area));
-    if (new_array == NULL) {
-        return -1; // 内存分配失败
+    int r0, r1, c0, c1;
+
+    if (!area_cells(&new_area, &r0, &r1, &c0, &c1)) {
+        return 0;
     }
-    areas = new_array; // 更新指针
+    for (int w = 0; w < AREA_WORDS; w++) {
+        if (area_used[w] != ~0ull) {
+            int id = w * 64 + __builtin_ctzll(~area_used[w]);
+
+            area_used[w] |= 1ull << (id % 64);
+            new_area.line = area_line;
+            area_pool[id] = new_area;
+            area_link(id, true);
+            return 0;
+        }
+    }
+    return -1; // 池已满
+}
 
-    // 添加新区域
-    areas[size] = new_area;
-    size++;
+static void free_area(int id) {
+    area_link(id, false);
+    area_used[id / 64] &= ~(1ull << (id % 64));
+}
 
-    return 0;
+static bool area_overlap(const area* a, const area* b) {
+    return a->top < b->bottom && b->top < a->bottom && a->left < b->right && b->left < a->right;
 }
 
-// 查找并删除满足条件的区域
-int find_remove_area(int x, int y) {
-    for (size_t i = 0; i < size; ++i) {
-        if (areas[i].top < x && x < areas[i].bottom && 
-            areas[i].left < y && y < areas[i].right) {
-            
-            // 计算缓冲区大小（确保对齐）
-            int width = areas[i].right - areas[i].left;
-            int buf_size = (width + 1) / 2;  // 4bpp 打包格式
-            uint8_t *pBuf = malloc(buf_size);
-            if (!pBuf) return -1;
-            memset(pBuf, 0, buf_size);
-
-            // 逐行清除（可调整 sync 策略）
-            int height = areas[i].bottom - areas[i].top;
-            for (int j = 0; j < height; j++) {
-                bool sync = (j == height - 1);  // 或直接 true 强制每行同步
-                display_image_sync(areas[i].top + j, areas[i].left, pBuf, buf_size, sync);
-            }
-            free(pBuf);
+// 清除一个矩形（裁到屏幕内），帧结束时统一同步
+static void clear_area(int top, int bottom, int left, int right) {
+    if (top < 0) top = 0;
+    if (left < 0) left = 0;
+    if (bottom > 480) bottom = 480;
+    if (right > 640) right = 640;
+    if (bottom > top && right > left) {
+        clear_rect(left, top, right - left, bottom - top, 0);
+    }
+}
 
-            // 安全删除区域
-            area *old_areas = areas;  // 备份指针
-            for (size_t j = i; j < size - 1; ++j) {
-                areas[j] = areas[j + 1];
+// 一次查出与q重叠的所有区域（当前行写入的除外），清除后删除记录；
+// keep为马上要整体重写的矩形（行长条），与它相交的部分不先清成黑色，避免同一像素发两次
+static void remove_overlaps(const area* q, const area* keep) {
+    int r0, r1, c0, c1;
+    uint64_t hit[AREA_WORDS] = { 0 };
+
+    if (!area_cells(q, &r0, &r1, &c0, &c1)) return;
+    for (int r = r0; r <= r1; r++) {
+        for (int c = c0; c <= c1; c++) {
+            for (int w = 0; w < AREA_WORDS; w++) {
+                hit[w] |= area_grid[r][c][w];
             }
-            size--;
+        }
+    }
 
-            // 安全 realloc
-            area *tmp = realloc(old_areas, size * sizeof(area));
-            if (!tmp && size > 0) {
-                free(old_areas);  // 避免内存泄漏
-                return -1;
+    for (int w = 0; w < AREA_WORDS; w++) {
+        while (hit[w]) {
+            int id = w * 64 + __builtin_ctzll(hit[w]);
+            const area* a = &area_pool[id];
+
+            hit[w] &= hit[w] - 1;
+            if (a->line == area_line || !area_overlap(a, q)) continue;
+            if (keep != NULL && area_overlap(a, keep)) {
+                // 去掉与keep相交的部分：上、下两条和中间的左、右两块
+                int t = a->top > keep->top ? a->top : keep->top;
+                int b = a->bottom < keep->bottom ? a->bottom : keep->bottom;
+                clear_area(a->top, t, a->left, a->right);
+                clear_area(b, a->bottom, a->left, a->right);
+                clear_area(t, b, a->left, keep->left);
+                clear_area(t, b, keep->right, a->right);
+            } else {
+                clear_area(a->top, a->bottom, a->left, a->right);
             }
-            areas = tmp;
-
-            return 0;  // 成功删除
+            free_area(id);
         }
     }
-    return -1;  // 未找到
 }
 
-// 清除一个字符区域
+// 从(x_clr, y_clr)起按行扫描，a内第一个被扫到的点（只算a的内部，与原来逐点查找一致）；
+// 返回与起点的距离，扫不到返回-1
+static long area_scan_dist(const area* a, int* x, int* y) {
+    int top = a->top + 1, left = a->left + 1;
+    int bottom = a->bottom < 480 ? a->bottom : 480;
+    int right = a->right < 640 ? a->right : 640;
+    long d;
+
+    if (top < 0) top = 0;
+    if (left < 0) left = 0;
+    if (top >= bottom || left >= right) return -1;
+    if (x_clr >= top && x_clr < bottom && y_clr < right) {
+        *x = x_clr;
+        *y = y_clr > left ? y_clr : left;
+    } else if (x_clr + 1 >= top && x_clr + 1 < bottom) {
+        *x = x_clr + 1;
+        *y = left;
+    } else {
+        *x = top;
+        *y = left;
+    }
+    d = (long)(*x - x_clr) * 640 + (*y - y_clr);
+    if (d < 0) d += 640L * 480;
+    return d;
+}
+
+// 清除一个字符区域：从上次的位置接着扫，清除最先扫到的区域
 int clr_char(void) {
-    for (int i = 0; i < 640 * 480; i++) {
-        if (find_remove_area(x_clr, y_clr) == 0) {
-            return 0;
-        }
-        else {
-            y_clr += 1;
-            if (y_clr >= 640) {
-                x_clr += 1;
-                y_clr = 0;
-                if (x_clr >= 480) {
-                    x_clr = 0;
-                }
+    long best = -1;
+    int best_id = -1, bx = 0, by = 0;
+
+    for (int w = 0; w < AREA_WORDS; w++) {
+        uint64_t used = area_used[w];
+
+        while (used) {
+            int id = w * 64 + __builtin_ctzll(used);
+            int x, y;
+            long d = area_scan_dist(&area_pool[id], &x, &y);
+
+            used &= used - 1;
+            if (d >= 0 && (best < 0 || d < best)) {
+                best = d;
+                best_id = id;
+                bx = x;
+                by = y;
             }
         }
     }
-
-    return -1;
+    if (best_id < 0) return -1;
+
+    x_clr = bx;
+    y_clr = by;
+    clear_area(area_pool[best_id].top, area_pool[best_id].bottom,
+               area_pool[best_id].left, area_pool[best_id].right);
+    free_area(best_id);
+    panel_sync();
+    return 0;
 }
 
-// 打印 area 数组中的所有值
+// 打印所有字符区域
 void print_areas() {
-    for (size_t i = 0; i < size; i++) {
-        printf("Area %zu: top = %d, bottom = %d, left = %d, right = %d\n",
-            i, areas[i].top, areas[i].bottom, areas[i].left, areas[i].right);
+    for (int id = 0; id < AREA_POOL_MAX; id++) {
+        if (area_used[id / 64] & (1ull << (id % 64))) {
+            printf("Area %d: top = %d, bottom = %d, left = %d, right = %d\n",
+                id, area_pool[id].top, area_pool[id].bottom, area_pool[id].left, area_pool[id].right);
+        }
     }
 }
+// ================== 字符区域索引结束 ==================
 
 // 将UTF-8编码转为Unicode码
 uint32_t utf8_to_unicode(const char** str) {
@@ -150,94 +255,228 @@ bool check_chars(uint32_t unicode, const char* chars) {
     return false;
 }
 
-// 将字符的位图数据写入屏幕
+// ================== 字形图集 ==================
+// 按(字体, 码点)缓存面板格式的字形：4bpp，高4位在前，每行从整字节开始（LVGL的位图行与行之间不对齐），
+// 另存一份右移一个像素的副本，放到奇数列时也只需按字节合成，不再每次逐字节移位
+#define GLYPH_ATLAS_SLOTS 256       // 哈希表槽数（2的幂），装满一半时整表清空重来
+
+typedef struct {
+    const lv_font_t* font;          // NULL为空槽
+    uint32_t unicode;
+    uint16_t box_w;
+    uint16_t box_h;
+    uint16_t stride[2];             // 每行字节数：[0]从偶数列开始，[1]从奇数列开始
+    uint8_t* bmp[2];                // 两种对齐的位图（同一块内存），空白字形为NULL
+} glyph_entry_t;
+
+static glyph_entry_t glyph_atlas[GLYPH_ATLAS_SLOTS];
+static uint32_t glyph_atlas_used = 0;
+
+static void glyph_atlas_clear(void) {
+    for (int i = 0; i < GLYPH_ATLAS_SLOTS; i++) {
+        free(glyph_atlas[i].bmp[0]);
+    }
+    memset(glyph_atlas, 0, sizeof(glyph_atlas));
+    glyph_atlas_used = 0;
+}
+
+// 把LVGL的连续4bpp位图拆成行对齐的两份
+static int glyph_pack(glyph_entry_t* e, const uint8_t* src) {
+    int w = e->box_w, h = e->box_h;
+    uint8_t* buf;
+
+    e->stride[0] = (w + 1) / 2;
+    e->stride[1] = (w + 2) / 2;
+    buf = calloc(h, e->stride[0] + e->stride[1]);
+    if (buf == NULL) {
+        perror("glyph_pack: calloc");
+        return -1;
+    }
+    e->bmp[0] = buf;
+    e->bmp[1] = buf + h * e->stride[0];
+
+    for (int r = 0; r < h; r++) {
+        for (int c = 0; c < w; c++) {
+            int p = r * w + c;
+            uint8_t v = (p & 1) ? (src[p >> 1] & 0x0F) : (src[p >> 1] >> 4);
+
+            for (int k = 0; k < 2; k++) {
+                uint8_t* b = &e->bmp[k][r * e->stride[k] + ((c + k) >> 1)];
+                *b |= ((c + k) & 1) ? v : (uint8_t)(v << 4);
+            }
+        }
+    }
+    return 0;
+}
+
+// 查找或加入一个字形；字体里没有的字符按空白字形缓存；取不到位图返回NULL
+static const glyph_entry_t* glyph_atlas_get(const lv_font_t* font, uint32_t unicode) {
+    uint32_t i = (unicode * 2654435761u ^ (uint32_t)(uintptr_t)font) & (GLYPH_ATLAS_SLOTS - 1);
+    lv_font_glyph_dsc_t g;
+    glyph_entry_t* e;
+
+    while (glyph_atlas[i].font != NULL) {
+        if (glyph_atlas[i].font == font && glyph_atlas[i].unicode == unicode) {
+            return &glyph_atlas[i];
+        }
+        i = (i + 1) & (GLYPH_ATLAS_SLOTS - 1);
+    }
+
+    if (glyph_atlas_used >= GLYPH_ATLAS_SLOTS / 2) {
+        glyph_atlas_clear();
+        return glyph_atlas_get(font, unicode);
+    }
+    e = &glyph_atlas[i];
+    memset(e, 0, sizeof(*e));
+    if (lv_font_get_glyph_dsc(font, &g, unicode, '\0') && g.box_w > 0 && g.box_h > 0) {
+        const uint8_t* src = lv_font_get_glyph_bitmap(font, unicode);
+
+        if (src == NULL || g.bpp != 4) {
+            fprintf(stderr, "Null Font!\n");
+            return NULL;
+        }
+        e->box_w = g.box_w;
+        e->box_h = g.box_h;
+        if (glyph_pack(e, src) < 0) return NULL;
+    }
+    e->font = font;
+    e->unicode = unicode;
+    glyph_atlas_used++;
+    return e;
+}
+// ================== 字形图集结束 ==================
+
+// ================== 行合成 ==================
+// 一行文字先在内存里拼成一条4bpp长条（包括字与字之间的黑色），整行一次交给影子缓冲比较后发送，
+// 不再每个字形每行一次display_image_sync
+#define LINE_STRIP_ROWS 64          // 长条最多的行数（行高超出部分不画）
+#define LINE_STRIP_BYTES (640 / 2)
+
+static uint8_t line_strip[LINE_STRIP_ROWS * LINE_STRIP_BYTES];
+static spi_wr_seg_t line_segs[LINE_STRIP_ROWS];
+
+typedef struct {
+    int row;            // 长条第一行的屏幕行
+    int rows;
+    int height;         // 行高（未裁剪）
+    int col;            // 长条第一列（偶数）
+    int end;            // 已写到的列（不含）
+} line_strip_t;
+
+static void line_begin(line_strip_t* ls, int row, int col, int rows) {
+    area_line++;        // 之后添加的字符区域属于新的一行
+    ls->row = row;
+    ls->height = rows;
+    ls->rows = rows < LINE_STRIP_ROWS ? rows : LINE_STRIP_ROWS;
+    if (ls->row + ls->rows > 480) ls->rows = 480 - ls->row;
+    if (ls->rows < 0) ls->rows = 0;
+    ls->col = col & ~1;
+    ls->end = ls->col;
+    memset(line_strip, 0, sizeof(line_strip));
+}
+
+// 按4位灰度取大合成，字形框相互重叠时不互相擦掉
+static inline uint8_t nibble_max(uint8_t d, uint8_t s) {
+    if (d == 0) return s;
+    if ((s & 0xF0) > (d & 0xF0)) d = (d & 0x0F) | (s & 0xF0);
+    if ((s & 0x0F) > (d & 0x0F)) d = (d & 0xF0) | (s & 0x0F);
+    return d;
+}
+
+// 把字形放到屏幕(row, col)，超出长条的部分裁掉
+static void line_put(line_strip_t* ls, const glyph_entry_t* e, int row, int col) {
+    int phase = col & 1;
+    int stride = e->stride[phase];
+    int x0 = (col - ls->col - phase) / 2;       // 长条内的字节位置
+    int b0 = x0 < 0 ? -x0 : 0;                  // 左边超出长条的字节
+
+    if (e->bmp[0] == NULL) return;
+    if (x0 + stride > LINE_STRIP_BYTES) stride = LINE_STRIP_BYTES - x0;
+    for (int r = 0; r < e->box_h; r++) {
+        int y = row + r - ls->row;
+        const uint8_t* src = &e->bmp[phase][r * e->stride[phase]];
+        uint8_t* dst;
+
+        if (y < 0) continue;
+        if (y >= ls->rows) break;
+        dst = &line_strip[y * LINE_STRIP_BYTES + x0];
+        for (int b = b0; b < stride; b++) {
+            if (src[b]) dst[b] = nibble_max(dst[b], src[b]);
+        }
+    }
+}
+
+// 整条发送：先一次清掉被这一行覆盖的旧字符区域（长条范围内的部分不清，由长条直接覆盖），
+// 再每行一段，一次display_segments；整行宽时各行连续，合成一段
+static void line_flush(line_strip_t* ls) {
+    int end = ls->end > 640 ? 640 : ls->end;
+    int len = (end - ls->col + 1) / 2;
+    area line = { ls->row, ls->row + ls->height, ls->col, ls->end };
+    area keep = { ls->row, ls->row + ls->rows, ls->col, ls->col + len * 2 };
+
+    remove_overlaps(&line, len > 0 && ls->rows > 0 ? &keep : NULL);
+    if (len <= 0 || ls->rows <= 0) return;
+    if (len == LINE_STRIP_BYTES) {
+        line_segs[0].col = 0;
+        line_segs[0].row = ls->row;
+        line_segs[0].pBuf = line_strip;
+        line_segs[0].len = ls->rows * LINE_STRIP_BYTES;
+        display_segments(line_segs, 1);
+    } else {
+        for (int r = 0; r < ls->rows; r++) {
+            line_segs[r].col = ls->col;
+            line_segs[r].row = ls->row + r;
+            line_segs[r].pBuf = &line_strip[r * LINE_STRIP_BYTES];
+            line_segs[r].len = len;
+        }
+        display_segments(line_segs, ls->rows);
+    }
+    ls->end = ls->col;
+}
+
 /**
- * @brief 在指定位置写入一个字符（优化版）
- * @param x 起始X坐标
- * @param y 起始Y坐标
+ * @brief 把一个字符合成到当前行的长条
+ * @param x 字符框的起始行
+ * @param y 字符框的起始列
  * @param font 使用的字体
  * @param c 要显示的Unicode字符
  * @param adv_x 字符的水平步进值
  * @param adv_y 字符的垂直步进值
- * @param last_char 是否是字符串中的最后一个字符
  * @return 成功返回0，失败返回-1
  */
-int write_char(int x, int y, const lv_font_t* font, uint32_t c, int adv_x, int adv_y, bool last_char) {
-    lv_font_glyph_dsc_t g;
-    const uint8_t* bmp = lv_font_get_glyph_bitmap(font, c);
+static int compose_char(line_strip_t* ls, int x, int y, const lv_font_t* font, uint32_t c, int adv_x, int adv_y) {
+    const glyph_entry_t* e = glyph_atlas_get(font, c);
 
     // 特殊字符垂直位置调整
     const char* chars1 = "abcdefhiklmnorstuvwxz,。.．_";
     const char* chars2 = "gjpqy";
     const char* chars3 = "^\"'~";
 
-    if (lv_font_get_glyph_dsc(font, &g, c, '\0')) {
-        if (bmp == NULL) {
-            fprintf(stderr, "Null Font!\n");
-            return -1;
-        }
+    if (e == NULL) return -1;
 
-        int width = g.box_w;
-        int height = g.box_h;
-
-        // 计算字符绘制起始位置
-        int row = x + ((adv_y - height) / 2);
-        int col = y + ((adv_x - width) / 2);
-
-        // 特殊字符垂直位置调整
-        if (check_chars(c, chars1)) {
-            row = x + adv_y * 0.85 - height;
-        }
-        if (check_chars(c, chars2)) {
-            row = x + adv_y - height;
-        }
-        if (check_chars(c, chars3)) {
-            row = x + adv_y * 0.15;
-        }
+    int width = e->box_w;
+    int height = e->box_h;
 
-        // 预分配缓冲区
-        uint8_t pBuf[(width + 1) / 2 + 1];  // 足够容纳所有情况
-        memset(pBuf, 0, sizeof(pBuf));
+    // 计算字符绘制起始位置
+    int row = x + ((adv_y - height) / 2);
+    int col = y + ((adv_x - width) / 2);
 
-        if (width % 2 == 0) {    // 宽度为偶数
-            for (int row_add = 0; row_add < height; row_add++) {
-                memcpy(pBuf, bmp + row_add * width / 2, width / 2);
-                display_image_sync(row + row_add, col, pBuf, width / 2, 
-                            (row_add == height-1) && last_char);
-            }
-        } else {                 // 宽度为奇数
-            for (int row_add = 0, j = 0; row_add < height; row_add += 2, j += width) {
-                // 处理奇数行
-                memcpy(pBuf, bmp + j, (width + 1) / 2);
-                pBuf[(width - 1) / 2] &= 0xF0;
-                display_image_sync(row + row_add, col, pBuf, (width + 1) / 2, false);
-
-                // 处理偶数行（如果有）
-                if (row_add + 1 < height) {
-                    uint8_t last_pixel = bmp[j + ((width - 1) / 2)] & 0x0F;
-                    memset(pBuf, 0, sizeof(pBuf));
-                    
-                    // 复制剩余数据
-                    if ((width - 1) / 2 > 0) {
-                        memcpy(pBuf + 1, bmp + j + ((width + 1) / 2), (width - 1) / 2);
-                    }
-                    
-                    // 移位处理
-                    for (int k = 0; k < (width - 1) / 2; ++k) {
-                        pBuf[k + 1] = (pBuf[k + 1] << 4) & 0xF0;
-                        pBuf[k] |= pBuf[k + 1] >> 4;
-                    }
-                    pBuf[0] |= (last_pixel << 4);
-                    
-                    // 只在最后一行和最后一个字符时同步
-                    bool sync = (row_add + 1 == height - 1) && last_char;
-                    display_image_sync(row + row_add + 1, col, pBuf, (width + 1) / 2, sync);
-                }
-            }
-        }
+    // 特殊字符垂直位置调整
+    if (check_chars(c, chars1)) {
+        row = x + adv_y * 0.85 - height;
+    }
+    if (check_chars(c, chars2)) {
+        row = x + adv_y - height;
+    }
+    if (check_chars(c, chars3)) {
+        row = x + adv_y * 0.15;
     }
+
+    line_put(ls, e, row, col);
+    if (y + adv_x > ls->end) ls->end = y + adv_x;
     return 0;
 }
+// ================== 行合成结束 ==================
 /*//旧版本
 int write_char(int x, int y, const lv_font_t* font, uint32_t c, int adv_x, int adv_y) {
     lv_font_glyph_dsc_t g;
@@ -371,11 +610,12 @@ int write_char(int x, int y, const lv_font_t* font, uint32_t c, int adv_x, int a
     return 0;
 }*/
 
-//新增指定位置显示
-int display_string_at(int x, int y, const char* text) {
+//新增指定位置显示：逐字合成到行长条，换行和结束时整行发送
+static int draw_string_at(int x, int y, const char* text) {
     const lv_font_t* font = &Font;
     const char* p = text;
     int adv_y = lv_font_get_line_height(font);
+    line_strip_t ls;
 
     // 使 adv_y 能整除 480
     while (480 % adv_y != 0) {
@@ -384,11 +624,9 @@ int display_string_at(int x, int y, const char* text) {
 
     int cur_x = x;
     int cur_y = y;
-    int char_count = strlen(text);
-    int current_char = 0;
 
+    line_begin(&ls, cur_x, cur_y, adv_y);
     while (*p) {
-        current_char++;
         uint32_t unicode = utf8_to_unicode(&p);
         int adv_x = lv_font_get_glyph_width(font, unicode, 0);
 
@@ -398,38 +636,41 @@ int display_string_at(int x, int y, const char* text) {
             adv_x *= 1.5;
         }
 
-        // 清除原区域 - 可以优化为批量清除
-        for (int n = 0; n < adv_x + adv_y; n++) {
-            find_remove_area(cur_x + (adv_y / 2), cur_y + n);
-        }
-
-        // 添加新区域
+        // 添加新区域（被覆盖的旧区域在整行发送时一次清除）
         area new_area1 = { cur_x, cur_x + adv_y, cur_y, cur_y + adv_x };
         if (add_area(new_area1) != 0) {
             perror("Failed to add area");
             return -1;
         }
 
-        // 只在最后一个字符时同步
-        bool is_last_char = (current_char == char_count);
-        if (write_char(cur_x, cur_y, font, unicode, adv_x, adv_y, is_last_char) == 0) {
+        if (compose_char(&ls, cur_x, cur_y, font, unicode, adv_x, adv_y) == 0) {
             cur_y += adv_x;
             // 自动换行
             if (cur_y + adv_x >= 640) {
+                line_flush(&ls);
                 cur_x += adv_y;
                 cur_y = y;
                 if (cur_x + adv_y >= 480) {
                     cur_x = x;
                 }
-                // 换行时同步一次
-                send_cmd(SPI_SYNC);
-                usleep(1 * 1000);
+                line_begin(&ls, cur_x, cur_y, adv_y);
             }
         }
     }
+    line_flush(&ls);
 
     return 0;
 }
+
+// 整个字符串作为一帧，清除和绘制完成后只同步一次
+int display_string_at(int x, int y, const char* text) {
+    int ret;
+
+    panel_frame_begin();
+    ret = draw_string_at(x, y, text);
+    panel_frame_end();
+    return ret;
+}
 /*
 int display_string_at(int x, int y, const char* text) {
     const lv_font_t* font = &Font;
@@ -490,21 +731,3 @@ int display_string_at(int x, int y, const char* text) {
 
     return 0;
 }*/
-
-//系统时钟函数
-uint32_t custom_tick_get(void) {
-    static uint64_t start_ms = 0;
-    if (start_ms == 0) {
-        struct timeval tv_start;
-        gettimeofday(&tv_start, NULL);
-        start_ms = (tv_start.tv_sec * 1000000 + tv_start.tv_usec) / 1000;
-    }
-
-    struct timeval tv_now;
-    gettimeofday(&tv_now, NULL);
-    uint64_t now_ms;
-    now_ms = (tv_now.tv_sec * 1000000 + tv_now.tv_usec) / 1000;
-
-    uint32_t time_ms = now_ms - start_ms;
-    return time_ms;
-}
\ No newline at end of file
@@ -5,4 +5,3 @@
 int clr_char(void);
 //int display_string(const char* text);
 int display_string_at(int x, int y, const char* text);
-uint32_t custom_tick_get(void);
\ No newline at end of file
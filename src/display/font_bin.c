@@ -0,0 +1,347 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "font_bin.h"
+
+// ================== 位图压缩 ==================
+// 像素按LVGL格式连续存放（不按行对齐），每像素bpp位，高位在前
+static inline uint8_t px_get(const uint8_t *buf, uint32_t i, uint8_t bpp) {
+    uint32_t bit = i * bpp;
+
+    return (buf[bit >> 3] >> (8 - bpp - (bit & 7))) & ((1u << bpp) - 1);
+}
+
+static inline void px_set(uint8_t *buf, uint32_t i, uint8_t bpp, uint8_t v) {
+    uint32_t bit = i * bpp;
+    uint8_t shift = 8 - bpp - (bit & 7);
+    uint8_t mask = (uint8_t)(((1u << bpp) - 1) << shift);
+
+    buf[bit >> 3] = (buf[bit >> 3] & ~mask) | (uint8_t)(v << shift);
+}
+
+size_t font_bin_comp_bound(uint8_t w, uint8_t h, uint8_t bpp) {
+    // 最坏每个像素单独成段：值bpp位加长度1位
+    return ((size_t)w * h * (bpp + 1) + 7) / 8 + 1;
+}
+
+typedef struct {
+    uint8_t *buf;
+    const uint8_t *src;
+    size_t len;         // 字节数（读时为上限）
+    size_t bit;
+} bit_stream_t;
+
+static void bits_put(bit_stream_t *bs, uint32_t v, uint8_t n) {
+    while (n--) {
+        if ((bs->bit & 7) == 0) bs->buf[bs->bit >> 3] = 0;
+        if ((v >> n) & 1) bs->buf[bs->bit >> 3] |= 0x80 >> (bs->bit & 7);
+        bs->bit++;
+    }
+}
+
+// 读n位，数据不够返回-1
+static int32_t bits_get(bit_stream_t *bs, uint8_t n) {
+    uint32_t v = 0;
+
+    if (bs->bit + n > bs->len * 8) return -1;
+    while (n--) {
+        v = (v << 1) | ((bs->src[bs->bit >> 3] >> (7 - (bs->bit & 7))) & 1);
+        bs->bit++;
+    }
+    return (int32_t)v;
+}
+
+// 0阶指数哥伦布码：x+1的位数减一个0，再写x+1
+static void bits_put_eg(bit_stream_t *bs, uint32_t x) {
+    uint8_t n = 0;
+
+    while ((x + 1) >> (n + 1)) n++;
+    bits_put(bs, 0, n);
+    bits_put(bs, x + 1, n + 1);
+}
+
+static int32_t bits_get_eg(bit_stream_t *bs) {
+    uint8_t n = 0;
+    int32_t v;
+
+    while ((v = bits_get(bs, 1)) == 0) {
+        if (++n > 24) return -1;
+    }
+    if (v < 0) return -1;
+    v = bits_get(bs, n);
+    return v < 0 ? -1 : (int32_t)((1u << n) + (uint32_t)v - 1);
+}
+
+// 每个像素先与上一行同一列的像素异或（竖直笔画大片变成0），
+// 再按游程编码：每段先写像素值（bpp位，1bpp时相邻两段必然不同，只写第一段），再写段长减一（指数哥伦布码）
+size_t font_bin_compress(const uint8_t *bmp, uint8_t w, uint8_t h, uint8_t bpp, uint8_t *out) {
+    uint32_t n = (uint32_t)w * h;
+    bit_stream_t bs = { out, NULL, 0, 0 };
+    uint32_t p = 0;
+
+#define FILTERED(i) (px_get(bmp, (i), bpp) ^ ((i) >= w ? px_get(bmp, (i) - w, bpp) : 0))
+    while (p < n) {
+        uint8_t v = FILTERED(p);
+        uint32_t run = 1;
+
+        while (p + run < n && FILTERED(p + run) == v) run++;
+        if (bpp != 1 || p == 0) bits_put(&bs, v, bpp);
+        bits_put_eg(&bs, run - 1);
+        p += run;
+    }
+#undef FILTERED
+    return (bs.bit + 7) / 8;
+}
+
+int font_bin_decompress(const uint8_t *src, size_t src_len, uint8_t w, uint8_t h, uint8_t bpp, uint8_t *out) {
+    uint32_t n = (uint32_t)w * h;
+    bit_stream_t bs = { NULL, src, src_len, 0 };
+    int32_t v = 0, run;
+    uint32_t p = 0;
+
+    memset(out, 0, ((size_t)n * bpp + 7) / 8);
+    while (p < n) {
+        if (bpp != 1 || p == 0) {
+            v = bits_get(&bs, bpp);
+        } else {
+            v ^= 1;
+        }
+        run = bits_get_eg(&bs);
+        if (v < 0 || run < 0 || p + (uint32_t)run + 1 > n) return -1;
+        for (uint32_t end = p + (uint32_t)run + 1; p < end; p++) {
+            // 上一行已经还原，异或回去
+            px_set(out, p, bpp, (uint8_t)v ^ (p >= w ? px_get(out, p - w, bpp) : 0));
+        }
+    }
+    return 0;
+}
+// ================== 位图压缩结束 ==================
+
+// ================== 文件映射 ==================
+static bool section_ok(size_t file_len, uint32_t off, size_t count, size_t elem) {
+    return (off & 3) == 0 && off <= file_len && count <= (file_len - off) / elem;
+}
+
+int font_bin_open(font_bin_t *fb) {
+    const font_bin_header_t *hdr;
+    struct stat st;
+    void *map;
+    int fd;
+
+    fd = open(fb->path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        perror("font_bin: open");
+        return -1;
+    }
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(font_bin_header_t)) {
+        printf("font_bin: %s 不是字体文件\n", fb->path);
+        close(fd);
+        return -1;
+    }
+    map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);      // 映射建立后不再需要fd
+    if (map == MAP_FAILED) {
+        perror("font_bin: mmap");
+        return -1;
+    }
+
+    hdr = map;
+    if (hdr->magic != FONT_BIN_MAGIC || hdr->version != FONT_BIN_VERSION ||
+        (hdr->bpp != 1 && hdr->bpp != 2 && hdr->bpp != 4 && hdr->bpp != 8) ||
+        !section_ok(st.st_size, hdr->cmap_off, hdr->glyph_count, sizeof(uint32_t)) ||
+        !section_ok(st.st_size, hdr->glyph_off, hdr->glyph_count, sizeof(font_bin_glyph_t)) ||
+        !section_ok(st.st_size, hdr->kern_off, hdr->kern_count, sizeof(font_bin_kern_t)) ||
+        !section_ok(st.st_size, hdr->bitmap_off, hdr->bitmap_size, 1)) {
+        printf("font_bin: %s 格式或版本不对\n", fb->path);
+        munmap(map, (size_t)st.st_size);
+        return -1;
+    }
+
+    fb->map = map;
+    fb->map_len = (size_t)st.st_size;
+    fb->hdr = hdr;
+    fb->cmap = (const uint32_t *)(fb->map + hdr->cmap_off);
+    fb->glyphs = (const font_bin_glyph_t *)(fb->map + hdr->glyph_off);
+    fb->kerns = (const font_bin_kern_t *)(fb->map + hdr->kern_off);
+    fb->bitmaps = fb->map + hdr->bitmap_off;
+    return 0;
+}
+
+void font_bin_close(font_bin_t *fb) {
+    glyph_cache_clear(&fb->cache);
+    if (fb->map != NULL) {
+        munmap((void *)fb->map, fb->map_len);
+        fb->map = NULL;
+    }
+}
+
+// 第一次用到时打开；编译期写死的行高等与文件不一致时提示（以编译期的为准排版）
+static bool font_bin_ready(const lv_font_t *font, font_bin_t *fb) {
+    if (fb->map != NULL) return true;
+    if (fb->failed) return false;
+    if (font_bin_open(fb) < 0) {
+        fb->failed = true;
+        return false;
+    }
+    if (fb->hdr->line_height != font->line_height || fb->hdr->base_line != font->base_line) {
+        printf("font_bin: %s 的行高/基线(%d/%d)与编译期(%d/%d)不一致\n", fb->path,
+               fb->hdr->line_height, fb->hdr->base_line, font->line_height, font->base_line);
+    }
+    return true;
+}
+// ================== 文件映射结束 ==================
+
+// ================== 查表 ==================
+static int32_t find_glyph(const font_bin_t *fb, uint32_t letter) {
+    uint32_t lo = 0, hi = fb->hdr->glyph_count;
+
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        if (fb->cmap[mid] < letter) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return (lo < fb->hdr->glyph_count && fb->cmap[lo] == letter) ? (int32_t)lo : -1;
+}
+
+static int32_t kern_value(const font_bin_t *fb, uint32_t left, uint32_t right) {
+    uint32_t key = left << 16 | right;
+    uint32_t lo = 0, hi = fb->hdr->kern_count;
+
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        if (fb->kerns[mid].pair < key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return (lo < fb->hdr->kern_count && fb->kerns[lo].pair == key) ? fb->kerns[lo].value : 0;
+}
+
+// 与lv_font_get_glyph_dsc_fmt_txt的规则一致：制表符按两个空格，步进按1/16像素加字距后四舍五入
+bool font_bin_get_glyph_dsc(const lv_font_t *font, lv_font_glyph_dsc_t *dsc_out, uint32_t letter, uint32_t letter_next) {
+    font_bin_t *fb = (font_bin_t *)font->dsc;
+    const font_bin_glyph_t *g;
+    bool is_tab = false;
+    int32_t gid, gid_next, adv;
+    int r;
+
+    if (!font_bin_ready(font, fb)) return false;
+    r = glyph_cache_dsc_get(&fb->cache, letter, letter_next, dsc_out);
+    if (r >= 0) return r == 1;
+
+    gid = find_glyph(fb, letter == '\t' ? ' ' : letter);
+    if (gid < 0) {
+        glyph_cache_dsc_put(&fb->cache, letter, letter_next, NULL);
+        return false;
+    }
+    is_tab = letter == '\t';
+    g = &fb->glyphs[gid];
+    adv = g->adv_w;
+    if (is_tab) adv *= 2;
+    if (fb->hdr->kern_count > 0 && (gid_next = find_glyph(fb, letter_next)) >= 0) {
+        adv += kern_value(fb, (uint32_t)gid, (uint32_t)gid_next);
+    }
+    dsc_out->adv_w = (uint16_t)((adv + (1 << 3)) >> 4);
+    dsc_out->box_w = g->box_w;
+    dsc_out->box_h = g->box_h;
+    dsc_out->ofs_x = g->ofs_x;
+    dsc_out->ofs_y = g->ofs_y;
+    dsc_out->bpp = fb->hdr->bpp;
+    dsc_out->is_placeholder = false;
+    if (is_tab) dsc_out->box_w = dsc_out->box_w * 2;
+    glyph_cache_dsc_put(&fb->cache, letter, letter_next, dsc_out);
+    return true;
+}
+// ================== 查表结束 ==================
+
+// ================== 解压 ==================
+// 返回的位图在下一次取位图之前有效（LVGL取到位图后立即绘制）
+const uint8_t *font_bin_get_glyph_bitmap(const lv_font_t *font, uint32_t letter) {
+    font_bin_t *fb = (font_bin_t *)font->dsc;
+    const font_bin_glyph_t *g;
+    const uint8_t *cached;
+    uint8_t *out;
+    int32_t gid;
+    size_t size;
+
+    if (!font_bin_ready(font, fb)) return NULL;
+    if (letter == '\t') letter = ' ';
+    cached = glyph_cache_bitmap_get(&fb->cache, letter);
+    if (cached != NULL) return cached;
+
+    gid = find_glyph(fb, letter);
+    if (gid < 0) return NULL;
+    g = &fb->glyphs[gid];
+    if ((uint64_t)g->bitmap + g->comp_len > fb->hdr->bitmap_size) return NULL;
+
+    // 空白字形也占一个槽（0字节），下次不用再查码点表
+    size = ((size_t)g->box_w * g->box_h * fb->hdr->bpp + 7) / 8;
+    out = glyph_cache_bitmap_alloc(&fb->cache, letter, size);
+    if (out == NULL) return NULL;
+    if (font_bin_decompress(fb->bitmaps + g->bitmap, g->comp_len, g->box_w, g->box_h, fb->hdr->bpp, out) < 0) {
+        printf("font_bin: %s 字形U+%04X数据损坏\n", fb->path, (unsigned)letter);
+        glyph_cache_bitmap_drop(&fb->cache, letter);
+        return NULL;
+    }
+    return out;
+}
+// ================== 解压结束 ==================
+
+// ================== 运行时加载 ==================
+typedef struct {
+    lv_font_t font;
+    font_bin_t fb;
+    char path[];
+} font_bin_loaded_t;
+
+lv_font_t *font_bin_load(const char *path) {
+    size_t len = strlen(path) + 1;
+    font_bin_loaded_t *f = calloc(1, sizeof(font_bin_loaded_t) + len);
+
+    if (f == NULL) {
+        perror("font_bin: calloc");
+        return NULL;
+    }
+    memcpy(f->path, path, len);
+    f->fb.path = f->path;
+    f->fb.cache.cap_bytes = FONT_BIN_CACHE_BYTES;
+    if (font_bin_open(&f->fb) < 0) {
+        free(f);
+        return NULL;
+    }
+    f->font.get_glyph_dsc = font_bin_get_glyph_dsc;
+    f->font.get_glyph_bitmap = font_bin_get_glyph_bitmap;
+    f->font.line_height = f->fb.hdr->line_height;
+    f->font.base_line = f->fb.hdr->base_line;
+    f->font.subpx = LV_FONT_SUBPX_NONE;
+    f->font.underline_position = f->fb.hdr->underline_position;
+    f->font.underline_thickness = f->fb.hdr->underline_thickness;
+    f->font.dsc = &f->fb;
+    return &f->font;
+}
+
+void font_bin_free(lv_font_t *font) {
+    font_bin_loaded_t *f = (font_bin_loaded_t *)font;
+
+    if (font == NULL) return;
+    font_bin_close(&f->fb);
+    free(f);
+}
+// ================== 运行时加载结束 ==================
+
+// FONT_BIN=1编译时ui/fonts下的字体源文件不再编进程序，同名字体改从.gfnt文件加载
+// （文件由make fonts生成，度量取自font_pack的输出）
+#ifdef FONT_BIN
+FONT_BIN_DEFINE(ui_font_alibaba_30, 35, 6, -2, 2);
+FONT_BIN_DEFINE(ui_font_Font1, 16, 3, -1, 1);
+FONT_BIN_DEFINE(ui_font_Font2, 31, 6, -2, 2);
+#endif
@@ -0,0 +1,107 @@
+#ifndef FONT_BIN_H_
+#define FONT_BIN_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "lvgl/lvgl.h"
+#include "glyph_cache.h"
+
+// 二进制字体文件（.gfnt）：由tools/font_pack.c从LVGL字体源文件转换
+// - 码点表：升序的码点数组，下标即字形序号，二分查找
+// - 字形表：每个字形的尺寸、偏移、步进和压缩位图的位置
+// - 字距表：按(左字形, 右字形)升序，二分查找
+// - 位图：每个字形单独压缩（像素与上一行异或后按像素游程编码），解开后与LVGL未压缩位图格式相同
+// 运行时整个文件mmap，只读用到的页；字形第一次显示时才解压，放进有大小上限的字形缓存（glyph_cache.h）
+// 所有多字节字段为小端，偏移都从文件开头算
+#define FONT_BIN_MAGIC 0x544E4647u      // "GFNT"
+#define FONT_BIN_VERSION 1
+#define FONT_BIN_CACHE_BYTES GLYPH_CACHE_BYTES   // 每个字体解压后位图的缓存上限
+#ifndef FONT_BIN_DIR
+#define FONT_BIN_DIR "/usr/share/fonts"
+#endif
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint8_t bpp;
+    uint8_t reserved0;
+    int16_t line_height;
+    int16_t base_line;
+    int8_t underline_position;
+    int8_t underline_thickness;
+    uint16_t reserved1;
+    uint32_t glyph_count;
+    uint32_t kern_count;
+    uint32_t cmap_off;          // uint32_t[glyph_count]
+    uint32_t glyph_off;         // font_bin_glyph_t[glyph_count]
+    uint32_t kern_off;          // font_bin_kern_t[kern_count]
+    uint32_t bitmap_off;        // 压缩位图区
+    uint32_t bitmap_size;
+} font_bin_header_t;
+
+typedef struct {
+    uint32_t bitmap;            // 压缩数据在位图区内的偏移
+    uint16_t adv_w;             // 步进，1/16像素
+    uint16_t comp_len;          // 压缩数据的字节数
+    uint8_t box_w;
+    uint8_t box_h;
+    int8_t ofs_x;
+    int8_t ofs_y;
+} font_bin_glyph_t;
+
+typedef struct {
+    uint32_t pair;              // 左字形序号 << 16 | 右字形序号
+    int16_t value;              // 字距调整，1/16像素（已乘kern_scale）
+    uint16_t reserved;
+} font_bin_kern_t;
+
+// 运行时状态：path之外的字段由font_bin_open填写
+typedef struct {
+    const char *path;
+    const uint8_t *map;
+    size_t map_len;
+    const font_bin_header_t *hdr;
+    const uint32_t *cmap;
+    const font_bin_glyph_t *glyphs;
+    const font_bin_kern_t *kerns;
+    const uint8_t *bitmaps;
+    bool failed;                // 打开失败过，不再重试
+    glyph_cache_t cache;        // 字形描述和解压后的位图
+} font_bin_t;
+
+// lv_font_t的回调，dsc指向font_bin_t；第一次调用时打开文件
+bool font_bin_get_glyph_dsc(const lv_font_t *font, lv_font_glyph_dsc_t *dsc_out, uint32_t letter, uint32_t letter_next);
+const uint8_t *font_bin_get_glyph_bitmap(const lv_font_t *font, uint32_t letter);
+
+// 映射并校验字体文件；成功返回0
+int font_bin_open(font_bin_t *fb);
+void font_bin_close(font_bin_t *fb);
+// 运行时加载一个字体文件（例如更大的中文字库），行高等取自文件；失败返回NULL
+lv_font_t *font_bin_load(const char *path);
+void font_bin_free(lv_font_t *font);
+
+// 编译期定义一个从文件加载的字体，可直接替换LVGL字体源文件里的同名字体
+// （行高等度量在编译期就要用到，打开文件时核对）
+#define FONT_BIN_DEFINE(name, lh, bl, ul_pos, ul_thick)                         \
+    static font_bin_t name##_bin = {                                            \
+        .path = FONT_BIN_DIR "/" #name ".gfnt",                                 \
+        .cache = { .cap_bytes = FONT_BIN_CACHE_BYTES },                         \
+    };                                                                          \
+    const lv_font_t name = {                                                    \
+        .get_glyph_dsc = font_bin_get_glyph_dsc,                                \
+        .get_glyph_bitmap = font_bin_get_glyph_bitmap,                          \
+        .line_height = lh,                                                      \
+        .base_line = bl,                                                        \
+        .subpx = LV_FONT_SUBPX_NONE,                                            \
+        .underline_position = ul_pos,                                           \
+        .underline_thickness = ul_thick,                                        \
+        .dsc = &name##_bin,                                                     \
+    }
+
+// 位图压缩（转换工具和运行时共用）：out至少要有font_bin_comp_bound字节，返回压缩后的字节数
+size_t font_bin_compress(const uint8_t *bmp, uint8_t w, uint8_t h, uint8_t bpp, uint8_t *out);
+size_t font_bin_comp_bound(uint8_t w, uint8_t h, uint8_t bpp);
+// 解压成LVGL未压缩位图格式，out为(w*h*bpp+7)/8字节；数据损坏返回-1
+int font_bin_decompress(const uint8_t *src, size_t src_len, uint8_t w, uint8_t h, uint8_t bpp, uint8_t *out);
+#endif
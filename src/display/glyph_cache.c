@@ -0,0 +1,237 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "glyph_cache.h"
+
+struct glyph_cache_slot {
+    uint32_t letter;
+    glyph_cache_slot_t *hnext;  // 同一哈希桶的下一个
+    glyph_cache_slot_t *prev;   // LRU链表
+    glyph_cache_slot_t *next;
+    size_t size;
+    uint8_t data[];
+};
+
+// ================== 字形描述 ==================
+static inline glyph_cache_dsc_t *dsc_entry(glyph_cache_t *gc, uint32_t letter, uint32_t letter_next) {
+    uint32_t h = (letter * 31u + letter_next) * 2654435761u;
+
+    return &gc->dsc[h >> (32 - GLYPH_CACHE_DSC_BITS)];
+}
+
+int glyph_cache_dsc_get(glyph_cache_t *gc, uint32_t letter, uint32_t letter_next, lv_font_glyph_dsc_t *dsc_out) {
+    glyph_cache_dsc_t *e = dsc_entry(gc, letter, letter_next);
+
+    if (!e->valid || e->letter != letter || e->letter_next != letter_next) {
+        gc->dsc_misses++;
+        return -1;
+    }
+    gc->dsc_hits++;
+    if (!e->found) return 0;
+    *dsc_out = e->dsc;
+    return 1;
+}
+
+void glyph_cache_dsc_put(glyph_cache_t *gc, uint32_t letter, uint32_t letter_next, const lv_font_glyph_dsc_t *dsc) {
+    glyph_cache_dsc_t *e = dsc_entry(gc, letter, letter_next);
+
+    e->letter = letter;
+    e->letter_next = letter_next;
+    e->valid = true;
+    e->found = dsc != NULL;
+    if (dsc != NULL) e->dsc = *dsc;
+}
+// ================== 字形描述结束 ==================
+
+// ================== 位图LRU ==================
+static inline glyph_cache_slot_t **bucket(glyph_cache_t *gc, uint32_t letter) {
+    return &gc->hash[letter & (GLYPH_CACHE_HASH_SIZE - 1)];
+}
+
+static void lru_unlink(glyph_cache_t *gc, glyph_cache_slot_t *slot) {
+    if (slot->prev != NULL) slot->prev->next = slot->next; else gc->lru_head = slot->next;
+    if (slot->next != NULL) slot->next->prev = slot->prev; else gc->lru_tail = slot->prev;
+}
+
+static void lru_push_head(glyph_cache_t *gc, glyph_cache_slot_t *slot) {
+    slot->prev = NULL;
+    slot->next = gc->lru_head;
+    if (gc->lru_head != NULL) gc->lru_head->prev = slot; else gc->lru_tail = slot;
+    gc->lru_head = slot;
+}
+
+static void slot_remove(glyph_cache_t *gc, glyph_cache_slot_t *slot) {
+    glyph_cache_slot_t **pp = bucket(gc, slot->letter);
+
+    while (*pp != slot) pp = &(*pp)->hnext;
+    *pp = slot->hnext;
+    lru_unlink(gc, slot);
+    gc->bytes -= sizeof(glyph_cache_slot_t) + slot->size;
+    free(slot);
+}
+
+const uint8_t *glyph_cache_bitmap_get(glyph_cache_t *gc, uint32_t letter) {
+    glyph_cache_slot_t *slot;
+
+    for (slot = *bucket(gc, letter); slot != NULL; slot = slot->hnext) {
+        if (slot->letter == letter) {
+            if (slot != gc->lru_head) {
+                lru_unlink(gc, slot);
+                lru_push_head(gc, slot);
+            }
+            gc->bitmap_hits++;
+            return slot->data;
+        }
+    }
+    gc->bitmap_misses++;
+    return NULL;
+}
+
+uint8_t *glyph_cache_bitmap_alloc(glyph_cache_t *gc, uint32_t letter, size_t size) {
+    size_t cap = gc->cap_bytes ? gc->cap_bytes : GLYPH_CACHE_BYTES;
+    size_t need = sizeof(glyph_cache_slot_t) + size;
+    glyph_cache_slot_t *slot;
+
+    if (need > cap) return NULL;
+    while (gc->lru_tail != NULL && gc->bytes + need > cap) {
+        slot_remove(gc, gc->lru_tail);
+    }
+    slot = malloc(need);
+    if (slot == NULL) {
+        perror("glyph_cache: malloc");
+        return NULL;
+    }
+    slot->letter = letter;
+    slot->size = size;
+    slot->hnext = *bucket(gc, letter);
+    *bucket(gc, letter) = slot;
+    lru_push_head(gc, slot);
+    gc->bytes += need;
+    return slot->data;
+}
+
+void glyph_cache_bitmap_drop(glyph_cache_t *gc, uint32_t letter) {
+    glyph_cache_slot_t *slot;
+
+    for (slot = *bucket(gc, letter); slot != NULL; slot = slot->hnext) {
+        if (slot->letter == letter) {
+            slot_remove(gc, slot);
+            return;
+        }
+    }
+}
+
+void glyph_cache_clear(glyph_cache_t *gc) {
+    while (gc->lru_tail != NULL) {
+        slot_remove(gc, gc->lru_tail);
+    }
+    memset(gc->dsc, 0, sizeof(gc->dsc));
+}
+
+void glyph_cache_get_stats(const glyph_cache_t *gc, glyph_cache_stats_t *out) {
+    out->dsc_hits = gc->dsc_hits;
+    out->dsc_misses = gc->dsc_misses;
+    out->bitmap_hits = gc->bitmap_hits;
+    out->bitmap_misses = gc->bitmap_misses;
+    out->bytes = gc->bytes;
+    out->cap_bytes = gc->cap_bytes ? gc->cap_bytes : GLYPH_CACHE_BYTES;
+}
+
+size_t glyph_cache_bitmap_size(const lv_font_glyph_dsc_t *dsc) {
+    // 与lv_font_fmt_txt一致，3bpp按4bpp存放
+    uint32_t bpp = dsc->bpp == 3 ? 4 : dsc->bpp;
+
+    return ((size_t)dsc->box_w * dsc->box_h * bpp + 7) / 8;
+}
+// ================== 位图LRU结束 ==================
+
+// ================== 包装字体 ==================
+typedef struct {
+    lv_font_t font;             // font.dsc指回本结构
+    const lv_font_t *base;
+    glyph_cache_t cache;
+} cached_font_t;
+
+static cached_font_t *cached_fonts[GLYPH_CACHE_FONTS];
+
+static bool cached_get_glyph_dsc(const lv_font_t *font, lv_font_glyph_dsc_t *dsc_out, uint32_t letter, uint32_t letter_next) {
+    cached_font_t *cf = (cached_font_t *)font->dsc;
+    int r = glyph_cache_dsc_get(&cf->cache, letter, letter_next, dsc_out);
+    bool found;
+
+    if (r >= 0) return r == 1;
+    found = cf->base->get_glyph_dsc(cf->base, dsc_out, letter, letter_next);
+    glyph_cache_dsc_put(&cf->cache, letter, letter_next, found ? dsc_out : NULL);
+    return found;
+}
+
+// 原字体返回的位图可能在它自己的解压缓冲区里（压缩格式），所以拷一份
+static const uint8_t *cached_get_glyph_bitmap(const lv_font_t *font, uint32_t letter) {
+    cached_font_t *cf = (cached_font_t *)font->dsc;
+    const uint8_t *src = glyph_cache_bitmap_get(&cf->cache, letter);
+    lv_font_glyph_dsc_t dsc;
+    uint8_t *dst;
+    size_t size;
+
+    if (src != NULL) return src;
+    // 尺寸只和字符有关，下一个字符取0；制表符的描述宽度加倍了，位图是空格的
+    if (!cached_get_glyph_dsc(font, &dsc, letter == '\t' ? ' ' : letter, 0)) return NULL;
+    src = cf->base->get_glyph_bitmap(cf->base, letter);
+    if (src == NULL) return NULL;
+
+    size = glyph_cache_bitmap_size(&dsc);
+    dst = glyph_cache_bitmap_alloc(&cf->cache, letter, size);
+    if (dst == NULL) return src;
+    memcpy(dst, src, size);
+    return dst;
+}
+
+static cached_font_t *find_cached(const lv_font_t *font) {
+    for (uint32_t i = 0; i < GLYPH_CACHE_FONTS; i++) {
+        cached_font_t *cf = cached_fonts[i];
+        if (cf != NULL && (cf->base == font || &cf->font == font)) return cf;
+    }
+    return NULL;
+}
+
+const lv_font_t *glyph_cache_font(const lv_font_t *base, size_t cap_bytes) {
+    cached_font_t *cf = find_cached(base);
+    uint32_t i;
+
+    if (cf != NULL) return &cf->font;
+    for (i = 0; i < GLYPH_CACHE_FONTS; i++) {
+        if (cached_fonts[i] == NULL) break;
+    }
+    if (i == GLYPH_CACHE_FONTS) {
+        printf("glyph_cache: 最多包装%d个字体\n", GLYPH_CACHE_FONTS);
+        return base;
+    }
+    cf = calloc(1, sizeof(cached_font_t));
+    if (cf == NULL) {
+        perror("glyph_cache: calloc");
+        return base;
+    }
+    cf->font = *base;
+    cf->font.get_glyph_dsc = cached_get_glyph_dsc;
+    cf->font.get_glyph_bitmap = cached_get_glyph_bitmap;
+    cf->font.dsc = cf;
+    cf->base = base;
+    cf->cache.cap_bytes = cap_bytes;
+    cached_fonts[i] = cf;
+    return &cf->font;
+}
+
+const lv_font_t *glyph_cache_resolve(const lv_font_t *font) {
+    cached_font_t *cf = find_cached(font);
+
+    return cf != NULL ? &cf->font : font;
+}
+
+bool glyph_cache_font_stats(const lv_font_t *font, glyph_cache_stats_t *out) {
+    cached_font_t *cf = find_cached(font);
+
+    if (cf == NULL) return false;
+    glyph_cache_get_stats(&cf->cache, out);
+    return true;
+}
+// ================== 包装字体结束 ==================
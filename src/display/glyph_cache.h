@@ -0,0 +1,76 @@
+#ifndef GLYPH_CACHE_H_
+#define GLYPH_CACHE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "lvgl/lvgl.h"
+
+// 字形缓存（LVGL线程）：记住字体回调的结果，重绘内容基本不变的中文文本时不再查码点表、取位图
+// - 字形描述按(字符, 下一个字符)直接映射，字距随下一个字符变化，所以整对作键；查不到的结果也记
+// - 位图按字符放进LRU，总字节数（含槽头）不超过cap_bytes
+// 两种用法：
+// - glyph_cache_font包装任意字体（如lv_font_fmt_txt的中文字体），回调先查缓存，未命中再调原字体
+// - 自己实现回调的字体（font_bin.c）内嵌glyph_cache_t，解码结果直接放进缓存
+#define GLYPH_CACHE_BYTES (64 * 1024)   // 默认位图缓存上限
+#define GLYPH_CACHE_HASH_SIZE 256       // 位图哈希桶数（2的幂）
+#define GLYPH_CACHE_DSC_BITS 9          // 字形描述表2^9项，约一屏字幕的两倍
+#define GLYPH_CACHE_FONTS 4             // glyph_cache_font最多包装的字体数
+
+typedef struct glyph_cache_slot glyph_cache_slot_t;
+
+typedef struct {
+    uint32_t letter;
+    uint32_t letter_next;
+    bool valid;
+    bool found;
+    lv_font_glyph_dsc_t dsc;
+} glyph_cache_dsc_t;
+
+typedef struct {
+    uint32_t dsc_hits;
+    uint32_t dsc_misses;
+    uint32_t bitmap_hits;
+    uint32_t bitmap_misses;
+    size_t bytes;               // 位图缓存当前占用
+    size_t cap_bytes;
+} glyph_cache_stats_t;
+
+// 零初始化即可使用，cap_bytes为0时取GLYPH_CACHE_BYTES
+typedef struct {
+    size_t cap_bytes;
+    size_t bytes;
+    glyph_cache_slot_t *hash[GLYPH_CACHE_HASH_SIZE];
+    glyph_cache_slot_t *lru_head;   // 最近用过的
+    glyph_cache_slot_t *lru_tail;
+    glyph_cache_dsc_t dsc[1u << GLYPH_CACHE_DSC_BITS];
+    uint32_t dsc_hits;
+    uint32_t dsc_misses;
+    uint32_t bitmap_hits;
+    uint32_t bitmap_misses;
+} glyph_cache_t;
+
+// 查字形描述：命中返回1（找到）或0（字体里没有），未命中返回-1
+int glyph_cache_dsc_get(glyph_cache_t *gc, uint32_t letter, uint32_t letter_next, lv_font_glyph_dsc_t *dsc_out);
+// 记下查找结果，dsc为NULL表示字体里没有
+void glyph_cache_dsc_put(glyph_cache_t *gc, uint32_t letter, uint32_t letter_next, const lv_font_glyph_dsc_t *dsc);
+// 查位图，未命中返回NULL；返回的位图在下一次glyph_cache_bitmap_alloc之前有效
+const uint8_t *glyph_cache_bitmap_get(glyph_cache_t *gc, uint32_t letter);
+// 为letter分配size字节的位图槽（必要时淘汰最久没用的），由调用者填写；内存不足返回NULL
+uint8_t *glyph_cache_bitmap_alloc(glyph_cache_t *gc, uint32_t letter, size_t size);
+// 放弃刚分配的槽（例如解码失败）
+void glyph_cache_bitmap_drop(glyph_cache_t *gc, uint32_t letter);
+// 清空缓存（统计保留）
+void glyph_cache_clear(glyph_cache_t *gc);
+void glyph_cache_get_stats(const glyph_cache_t *gc, glyph_cache_stats_t *out);
+// LVGL未压缩位图的字节数
+size_t glyph_cache_bitmap_size(const lv_font_glyph_dsc_t *dsc);
+
+// 包装base：返回带缓存的字体，可以替代base使用；同一个base重复包装返回同一个字体
+// cap_bytes为0时取GLYPH_CACHE_BYTES；包装数已满或内存不足时返回base
+const lv_font_t *glyph_cache_font(const lv_font_t *base, size_t cap_bytes);
+// font被包装过时返回包装后的字体，否则原样返回（界面代码直接引用字体变量时用它换成包装字体）
+const lv_font_t *glyph_cache_resolve(const lv_font_t *font);
+// 包装后字体的统计，font不是包装字体返回false
+bool glyph_cache_font_stats(const lv_font_t *font, glyph_cache_stats_t *out);
+#endif
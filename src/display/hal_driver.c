@@ -1,22 +1,154 @@
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <time.h>
 #include <sys/ioctl.h>
 #include <linux/spi/spidev.h>
 #include "hal_driver.h"
 
 extern int spi_file; // 声明外部变量
 
+#define SPIDEV_BUFSIZ_PATH "/sys/module/spidev/parameters/bufsiz"
+#define SPIDEV_BUFSIZ_DEFAULT 4096      // spidev驱动默认的单次消息上限
+#define WR_CACHE_CHUNK_SIZE 4090        // 每段写缓存的最大像素字节数
+#define WR_CACHE_OVERHEAD 6             // 0x02 + 24位地址 + Dummy + 尾部Dummy
+#define SPI_BATCH_MAX_XFERS 16          // 单次SPI_IOC_MESSAGE最多拼接的段数
+#define SPI_SG_MAX_CHUNKS 16            // 零拷贝模式下单次消息最多拼接的段数（每段3个transfer）
+#define SPI_CMD_MAX_XFERS 32            // 单次消息最多拼接的寄存器指令数
+
+static uint8_t spi_wr_mode = SPI_WR_MODE_SG;
+static spi_wr_stats_t spi_wr_stats[SPI_WR_STAT_NUM];
+static uint8_t spi_1bit_tx_nbits = 1;   // 1bit写缓存数据段的线宽（1/2/4），需与spi_init设置的模式匹配
+
+// spidev后端：直接对/dev/spidev0.0发ioctl（设备由spi_init打开并配置）
+static int spidev_message(struct spi_ioc_transfer* transfer, uint32_t n) {
+    return ioctl(spi_file, SPI_IOC_MESSAGE(n), transfer);
+}
+
+const panel_transport_t spidev_transport = {
+    .name = "spidev",
+    .message = spidev_message,
+};
+
+static const panel_transport_t* spi_transport = &spidev_transport;
+
+// 发送一个SPI消息（n个transfer），写缓存、读缓存、指令和同步都经由当前后端
+static int spi_message(struct spi_ioc_transfer* transfer, uint32_t n) {
+    return spi_transport->message(transfer, n);
+}
+
+// 切换面板后端（spidev_transport或模拟面板panel_sim_transport）
+void spi_set_transport(const panel_transport_t* transport) {
+    if (transport != NULL) {
+        spi_transport = transport;
+        if (transport->reset != NULL) {
+            transport->reset();
+        }
+    }
+}
+
+const panel_transport_t* spi_get_transport(void) {
+    return spi_transport;
+}
+
+// 设置1bit写缓存数据段的线宽：1为单线，4为四线（spi_init需打开SPI_TX_QUAD）
+void spi_set_1bit_tx_nbits(uint8_t nbits) {
+    if (nbits == 1 || nbits == 2 || nbits == 4) {
+        spi_1bit_tx_nbits = nbits;
+    }
+}
+
+static uint64_t spi_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static void spi_wr_stats_add(uint8_t mode, uint32_t bytes, uint32_t ioctls, uint64_t ns) {
+    spi_wr_stats[mode].bytes += bytes;
+    spi_wr_stats[mode].ioctls += ioctls;
+    spi_wr_stats[mode].ns += ns;
+}
+
+// 读取spidev的bufsiz参数（单个SPI_IOC_MESSAGE所有段的总长度上限），只读一次
+uint32_t spi_get_bufsiz(void) {
+    static uint32_t bufsiz = 0;
+    if (bufsiz == 0) {
+        FILE *fp = fopen(SPIDEV_BUFSIZ_PATH, "r");
+        unsigned long val = 0;
+        if (fp != NULL) {
+            if (fscanf(fp, "%lu", &val) != 1) {
+                val = 0;
+            }
+            fclose(fp);
+        }
+        bufsiz = (val >= WR_CACHE_OVERHEAD + 2) ? (uint32_t)val : SPIDEV_BUFSIZ_DEFAULT;
+    }
+    return bufsiz;
+}
+
+// 选择写缓存路径，SPI_WR_MODE_CHUNKED为逐段ioctl，SPI_WR_MODE_BATCH为多段合并提交
+void spi_set_wr_mode(uint8_t mode) {
+    if (mode < SPI_WR_MODE_NUM) {
+        spi_wr_mode = mode;
+    }
+}
+
+void spi_wr_stats_get(uint8_t mode, spi_wr_stats_t* stats) {
+    if (mode < SPI_WR_STAT_NUM && stats != NULL) {
+        *stats = spi_wr_stats[mode];
+    }
+}
+
+void spi_wr_stats_reset(void) {
+    memset(spi_wr_stats, 0, sizeof(spi_wr_stats));
+}
+
+// 打印各写缓存路径的吞吐统计，便于对比
+void spi_wr_stats_print(void) {
+    static const char* names[SPI_WR_STAT_NUM] = { "chunked", "batch", "sg", "1bit" };
+    for (uint8_t i = 0; i < SPI_WR_STAT_NUM; i++) {
+        const spi_wr_stats_t* st = &spi_wr_stats[i];
+        if (st->bytes == 0) {
+            continue;
+        }
+        double sec = st->ns / 1e9;
+        printf("SPI写缓存[%s]: %llu字节, %llu次ioctl, %.1fms, %.1fKB/s\n", names[i],
+               (unsigned long long)st->bytes, (unsigned long long)st->ioctls, st->ns / 1e6,
+               sec > 0 ? st->bytes / sec / 1024.0 : 0.0);
+    }
+}
+
+// 填充一段写缓存指令头（指令+24位地址+Dummy，共5字节）
+static void wr_cache_header(uint8_t* hdr, uint8_t cmd, uint16_t col, uint16_t row) {
+    uint32_t addr = ((row & 0x1ff) << 10) | (col & 0x3ff);
+
+    hdr[0] = cmd;                              // 写缓存指令
+    hdr[1] = (uint8_t)(addr >> 16);            // 24位地址
+    hdr[2] = (uint8_t)(addr >> 8);
+    hdr[3] = (uint8_t)(addr);
+    hdr[4] = 0xFF;                             // Dummy
+}
+
+// 按写入的字节数推进行列地址（4bpp每字节2像素，1bit每字节8像素，超过640列换行）
+static void wr_cache_advance(uint16_t* col, uint16_t* row, uint32_t bytes, uint32_t px_per_byte) {
+    uint32_t next_col = *col + bytes * px_per_byte;
+    *row += next_col / 640;
+    *col = next_col % 640;
+}
+
 // 发送一帧数据
-int spi_tx_frame(uint8_t* param) {
+int spi_tx_frame(uint8_t* param, uint32_t len) {
     struct spi_ioc_transfer transfer[1];
     memset(transfer, 0, sizeof(transfer));
 
     transfer[0].tx_buf = (unsigned long)param;
-    transfer[0].len = sizeof(param);
+    transfer[0].len = len;
 
-    if (ioctl(spi_file, SPI_IOC_MESSAGE(1), transfer) < 0) {
+    if (spi_message(transfer, 1) < 0) {
         perror("Failed to perform SPI transfer");
         close(spi_file);
         return -1;
@@ -25,6 +157,30 @@ int spi_tx_frame(uint8_t* param) {
     return 0;
 }
 
+// 按顺序发送多条指令，每条指令之间释放片选，合并为尽量少的ioctl
+int spi_tx_cmds(const spi_cmd_t* cmds, uint32_t count) {
+    struct spi_ioc_transfer transfer[SPI_CMD_MAX_XFERS];
+
+    while (count > 0) {
+        uint32_t n = count < SPI_CMD_MAX_XFERS ? count : SPI_CMD_MAX_XFERS;
+
+        memset(transfer, 0, n * sizeof(transfer[0]));
+        for (uint32_t i = 0; i < n; i++) {
+            transfer[i].tx_buf = (unsigned long)cmds[i].buf;
+            transfer[i].len = cmds[i].len;
+            transfer[i].cs_change = (i + 1 < n) ? 1 : 0;
+        }
+        if (spi_message(transfer, n) < 0) {
+            perror("Failed to perform SPI transfer");
+            return -1;
+        }
+        cmds += n;
+        count -= n;
+    }
+
+    return 0;
+}
+
 // 接收一帧数据
 int spi_rx_frame(uint8_t cmd, uint8_t* param, uint32_t len) {
     struct spi_ioc_transfer transfer[2];
@@ -39,7 +195,7 @@ int spi_rx_frame(uint8_t cmd, uint8_t* param, uint32_t len) {
     transfer[1].rx_buf = (unsigned long)(buf + 1);
     transfer[1].len = len;
 
-    if (ioctl(spi_file, SPI_IOC_MESSAGE(2), transfer) < 0) {
+    if (spi_message(transfer, 2) < 0) {
         perror("Failed to perform SPI transfer");
         close(spi_file);
         return -1;
@@ -74,7 +230,7 @@ int spi_rd_buffer(uint16_t row, uint16_t col, uint32_t len) {
     transfer[1].rx_buf = (unsigned long)(buf + 5);
     transfer[1].len = len;
 
-    if (ioctl(spi_file, SPI_IOC_MESSAGE(2), transfer) < 0) {
+    if (spi_message(transfer, 2) < 0) {
         perror("Failed to perform SPI transfer");
         close(spi_file);
         return -1;
@@ -91,12 +247,14 @@ int spi_rd_buffer(uint16_t row, uint16_t col, uint32_t len) {
 
 // 写缓存数据,列地址col（0~639）,行地址row（0~479）,存储指针*pBuf,读取数据长度len（Max153600）
 // 优化版本：支持大数据分块传输，避免栈溢出
-int spi_wr_buffer(uint16_t col, uint16_t row, uint8_t* pBuf, uint32_t len) {
+int spi_wr_buffer_chunked(uint16_t col, uint16_t row, uint8_t* pBuf, uint32_t len) {
     const uint32_t MAX_CHUNK_SIZE = 4090;  // 每块最大数据大小
     uint32_t remaining = len;
     uint32_t offset = 0;
     uint16_t current_row = row;
     uint16_t current_col = col;
+    uint32_t ioctls = 0;
+    uint64_t t0 = spi_now_ns();
     
     while (remaining > 0) {
         // 计算当前块的大小
@@ -125,11 +283,12 @@ int spi_wr_buffer(uint16_t col, uint16_t row, uint8_t* pBuf, uint32_t len) {
         transfer[0].tx_buf = (unsigned long)buf;
         transfer[0].len = chunk_size + 6;
 
-        if (ioctl(spi_file, SPI_IOC_MESSAGE(1), transfer) < 0) {
+        if (spi_message(transfer, 1) < 0) {
             perror("Failed to perform SPI transfer");
             close(spi_file);
             return -1;
         }
+        ioctls++;
 
         // 更新位置和剩余数据
         remaining -= chunk_size;
@@ -146,9 +305,186 @@ int spi_wr_buffer(uint16_t col, uint16_t row, uint8_t* pBuf, uint32_t len) {
         }
     }
 
+    spi_wr_stats_add(SPI_WR_MODE_CHUNKED, len, ioctls, spi_now_ns() - t0);
     return 0;
 }
 
+// 写缓存数据（批量版本）：把多段"指令头+数据+Dummy"拼进同一个SPI_IOC_MESSAGE(N)，
+// 段与段之间用cs_change拉高片选，单次消息总长不超过spidev的bufsiz
+int spi_wr_buffer_batch(uint16_t col, uint16_t row, uint8_t* pBuf, uint32_t len) {
+    static uint8_t* stage = NULL;
+    static uint32_t stage_size = 0;
+    struct spi_ioc_transfer transfer[SPI_BATCH_MAX_XFERS];
+    uint32_t bufsiz = spi_get_bufsiz();
+    uint32_t chunk_max = bufsiz - WR_CACHE_OVERHEAD;
+    uint32_t offset = 0;
+    uint32_t ioctls = 0;
+    uint64_t t0 = spi_now_ns();
+
+    if (chunk_max > WR_CACHE_CHUNK_SIZE) {
+        chunk_max = WR_CACHE_CHUNK_SIZE;
+    }
+    if (stage_size < bufsiz) {
+        uint8_t* p = realloc(stage, bufsiz);
+        if (p == NULL) {
+            perror("Failed to allocate SPI batch buffer");
+            return -1;
+        }
+        stage = p;
+        stage_size = bufsiz;
+    }
+
+    while (offset < len) {
+        uint32_t used = 0;
+        uint32_t n = 0;
+
+        memset(transfer, 0, sizeof(transfer));
+        while (offset < len && n < SPI_BATCH_MAX_XFERS) {
+            uint32_t chunk_size = len - offset;
+            if (chunk_size > chunk_max) {
+                chunk_size = chunk_max;
+            }
+            if (used + chunk_size + WR_CACHE_OVERHEAD > bufsiz) {
+                break;
+            }
+
+            uint8_t* rec = stage + used;
+            wr_cache_header(rec, SPI_WR_CACHE, col, row);
+            memcpy(rec + 5, pBuf + offset, chunk_size);
+            rec[chunk_size + 5] = 0x0F;               // Dummy
+
+            transfer[n].tx_buf = (unsigned long)rec;
+            transfer[n].len = chunk_size + WR_CACHE_OVERHEAD;
+            transfer[n].cs_change = 1;                // 每段独立片选
+            n++;
+
+            used += chunk_size + WR_CACHE_OVERHEAD;
+            offset += chunk_size;
+            wr_cache_advance(&col, &row, chunk_size, 2);
+        }
+        if (n == 0) {
+            break;
+        }
+        transfer[n - 1].cs_change = 0;                // 最后一段结束后正常释放片选
+
+        if (spi_message(transfer, n) < 0) {
+            perror("Failed to perform SPI transfer");
+            return -1;
+        }
+        ioctls++;
+    }
+
+    spi_wr_stats_add(SPI_WR_MODE_BATCH, len, ioctls, spi_now_ns() - t0);
+    return 0;
+}
+
+// 写缓存数据（零拷贝版本）：每段拆成"指令头/调用者的像素内存/尾部Dummy"三个transfer，
+// 段内不切换片选，段间cs_change，像素数据不再复制到中转缓冲区。
+// 多个段（可以是不连续的区域）尽量合并到同一个SPI_IOC_MESSAGE(N)
+// cmd为写缓存指令，px_per_byte为每字节像素数，nbits为数据段线宽
+static int spi_wr_segments_cmd(uint8_t cmd, uint32_t px_per_byte, uint8_t nbits, uint8_t stat,
+                               const spi_wr_seg_t* segs, uint32_t count) {
+    static const uint8_t trailer = 0x0F;       // Dummy
+    uint8_t hdr[SPI_SG_MAX_CHUNKS][5];
+    struct spi_ioc_transfer transfer[SPI_SG_MAX_CHUNKS * 3];
+    uint32_t bufsiz = spi_get_bufsiz();
+    uint32_t chunk_max = bufsiz - WR_CACHE_OVERHEAD;
+    uint32_t seg_idx = 0;
+    uint32_t offset = 0;
+    uint16_t col = 0, row = 0;
+    uint32_t bytes = 0;
+    uint32_t ioctls = 0;
+    uint64_t t0 = spi_now_ns();
+
+    if (chunk_max > WR_CACHE_CHUNK_SIZE) {
+        chunk_max = WR_CACHE_CHUNK_SIZE;
+    }
+    if (count > 0) {
+        col = segs[0].col;
+        row = segs[0].row;
+    }
+
+    while (seg_idx < count) {
+        uint32_t used = 0;
+        uint32_t n = 0;
+
+        memset(transfer, 0, sizeof(transfer));
+        while (seg_idx < count && n < SPI_SG_MAX_CHUNKS) {
+            const spi_wr_seg_t* seg = &segs[seg_idx];
+            uint32_t chunk_size = seg->len - offset;
+            if (chunk_size > chunk_max) {
+                chunk_size = chunk_max;
+            }
+            if (chunk_size > 0) {
+                if (used + chunk_size + WR_CACHE_OVERHEAD > bufsiz) {
+                    break;
+                }
+
+                struct spi_ioc_transfer* t = &transfer[n * 3];
+                wr_cache_header(hdr[n], cmd, col, row);
+                t[0].tx_buf = (unsigned long)hdr[n];
+                t[0].len = 5;
+                t[1].tx_buf = (unsigned long)(seg->pBuf + offset);
+                t[1].len = chunk_size;
+                t[1].tx_nbits = nbits;
+                t[2].tx_buf = (unsigned long)&trailer;
+                t[2].len = 1;
+                t[2].cs_change = 1;                   // 段间拉高片选
+                n++;
+
+                used += chunk_size + WR_CACHE_OVERHEAD;
+                offset += chunk_size;
+                bytes += chunk_size;
+                wr_cache_advance(&col, &row, chunk_size, px_per_byte);
+            }
+
+            if (offset >= seg->len) {
+                seg_idx++;
+                offset = 0;
+                if (seg_idx < count) {
+                    col = segs[seg_idx].col;
+                    row = segs[seg_idx].row;
+                }
+            }
+        }
+        if (n == 0) {
+            continue;
+        }
+        transfer[n * 3 - 1].cs_change = 0;
+
+        if (spi_message(transfer, n * 3) < 0) {
+            perror("Failed to perform SPI transfer");
+            return -1;
+        }
+        ioctls++;
+    }
+
+    spi_wr_stats_add(stat, bytes, ioctls, spi_now_ns() - t0);
+    return 0;
+}
+
+// 4bpp写缓存（指令0x02），每字节2像素
+int spi_wr_segments(const spi_wr_seg_t* segs, uint32_t count) {
+    return spi_wr_segments_cmd(SPI_WR_CACHE, 2, 1, SPI_WR_MODE_SG, segs, count);
+}
+
+// 1bit写缓存（指令0x52），每字节8像素，高位在前，1为最亮
+int spi_wr_segments_1bit(const spi_wr_seg_t* segs, uint32_t count) {
+    return spi_wr_segments_cmd(SPI_WR_CACHE_1BIT_QSPI, 8, spi_1bit_tx_nbits, SPI_WR_STAT_1BIT, segs, count);
+}
+
+// 写缓存数据,列地址col（0~639）,行地址row（0~479）,存储指针*pBuf,读取数据长度len（Max153600）
+int spi_wr_buffer(uint16_t col, uint16_t row, uint8_t* pBuf, uint32_t len) {
+    if (spi_wr_mode == SPI_WR_MODE_CHUNKED) {
+        return spi_wr_buffer_chunked(col, row, pBuf, len);
+    }
+    if (spi_wr_mode == SPI_WR_MODE_BATCH) {
+        return spi_wr_buffer_batch(col, row, pBuf, len);
+    }
+    spi_wr_seg_t seg = { col, row, pBuf, len };
+    return spi_wr_segments(&seg, 1);
+}
+
 // 读温度传感器数据，返回温度（℃）,温度传感器的ID sensorId（0~3）
 float get_temperature_sensor_data(void) {
     uint8_t buf[2004];
@@ -172,7 +508,7 @@ float get_temperature_sensor_data(void) {
     transfer[1].rx_buf = (unsigned long)(buf + 4);
     transfer[1].len = 2000;
 
-    if (ioctl(spi_file, SPI_IOC_MESSAGE(2), transfer) < 0) {
+    if (spi_message(transfer, 2) < 0) {
         perror("Failed to perform SPI transfer");
         close(spi_file);
         return -1;
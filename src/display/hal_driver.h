@@ -1,11 +1,67 @@
 #ifndef HAL_DRIVER_H_
 #define HAL_DRIVER_H_
 
+#include <stdint.h>
+
+// 写缓存路径及吞吐统计
+#define SPI_WR_MODE_CHUNKED 0   // 每段一次ioctl（原实现）
+#define SPI_WR_MODE_BATCH 1     // 多段合并为一次SPI_IOC_MESSAGE(N)
+#define SPI_WR_MODE_SG 2        // 零拷贝分散写，直接从调用者内存发送（默认）
+#define SPI_WR_MODE_NUM 3
+#define SPI_WR_STAT_1BIT 3      // 1bit写缓存只参与统计，不作为spi_wr_buffer的模式
+#define SPI_WR_STAT_NUM 4
+
+typedef struct {
+    uint64_t bytes;     // 写入的像素数据字节数
+    uint64_t ioctls;    // ioctl调用次数
+    uint64_t ns;        // 累计耗时（纳秒）
+} spi_wr_stats_t;
+
+// 一段写缓存区域，地址按行优先线性递增（4bpp每字节2像素，1bit每字节8像素）
+typedef struct {
+    uint16_t col;           // 起始列（0~639）
+    uint16_t row;           // 起始行（0~479）
+    const uint8_t* pBuf;    // 打包的像素数据
+    uint32_t len;           // 数据字节数
+} spi_wr_seg_t;
+
+// 一条寄存器指令（指令字节+参数），按实际长度发送
+#define SPI_CMD_MAX_LEN 4
+typedef struct {
+    uint8_t buf[SPI_CMD_MAX_LEN];
+    uint8_t len;
+} spi_cmd_t;
+
+// 面板后端：所有写缓存/读缓存/指令/同步最终都是一个SPI消息（若干transfer，
+// cs_change分隔片选帧），后端负责把消息送到spidev或模拟面板
+struct spi_ioc_transfer;
+typedef struct {
+    const char* name;
+    int (*message)(struct spi_ioc_transfer* transfer, uint32_t n);
+    void (*reset)(void);        // 切换到该后端时调用，可为NULL
+} panel_transport_t;
+
+extern const panel_transport_t spidev_transport;
+
 #include "jbd013_api.h"
 
-int spi_tx_frame(uint8_t* param);
+int spi_tx_frame(uint8_t* param, uint32_t len);
+int spi_tx_cmds(const spi_cmd_t* cmds, uint32_t count);
 int spi_rx_frame(uint8_t cmd, uint8_t* param, uint32_t len);
 int spi_rd_buffer(uint16_t row, uint16_t col, uint32_t len);
 int spi_wr_buffer(uint16_t col, uint16_t row, uint8_t* pBuf, uint32_t len);
+int spi_wr_buffer_chunked(uint16_t col, uint16_t row, uint8_t* pBuf, uint32_t len);
+int spi_wr_buffer_batch(uint16_t col, uint16_t row, uint8_t* pBuf, uint32_t len);
+int spi_wr_segments(const spi_wr_seg_t* segs, uint32_t count);
+int spi_wr_segments_1bit(const spi_wr_seg_t* segs, uint32_t count);
+void spi_set_1bit_tx_nbits(uint8_t nbits);
+void spi_set_transport(const panel_transport_t* transport);
+const panel_transport_t* spi_get_transport(void);
+
+uint32_t spi_get_bufsiz(void);
+void spi_set_wr_mode(uint8_t mode);
+void spi_wr_stats_get(uint8_t mode, spi_wr_stats_t* stats);
+void spi_wr_stats_reset(void);
+void spi_wr_stats_print(void);
 float get_temperature_sensor_data(void);
-#endif
\ No newline at end of file
+#endif
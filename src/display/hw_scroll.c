@@ -0,0 +1,90 @@
+#include "hw_scroll.h"
+
+static lv_timer_t *auto_timer = NULL;
+static lv_obj_t *auto_obj = NULL;
+static hw_scroll_end_cb_t auto_end_cb = NULL;
+static uint16_t auto_speed = 0;
+static uint32_t auto_last_tick = 0;
+static uint32_t auto_acc = 0;       // 不足1像素的部分（像素*1000）
+static bool hw_enabled = false;     // 面板偏移回绕未核实前默认关闭（见hw_scroll.h）
+
+void hw_scroll_set_enabled(bool enable) {
+    hw_enabled = enable;
+}
+
+bool hw_scroll_enabled(void) {
+    return hw_enabled;
+}
+
+void hw_scroll_shift(lv_obj_t *obj, lv_coord_t dy) {
+    lv_disp_t *disp = lv_obj_get_disp(obj);
+    lv_area_t area;
+
+    lv_obj_invalidate(obj);
+    if (dy == 0 || !hw_enabled) return;
+
+    // 与lv_obj_invalidate一样按父对象和屏幕裁剪，得到LVGL实际会重绘的区域
+    lv_obj_get_coords(obj, &area);
+    if (!lv_obj_area_is_visible(obj, &area)) return;
+    if (area.x1 > 0 || area.x2 < lv_disp_get_hor_res(disp) - 1) return;
+    disp_flush_scroll(&area, dy);
+}
+
+lv_coord_t hw_scroll_by(lv_obj_t *obj, lv_coord_t dy) {
+    lv_coord_t room;
+
+    if (dy > 0) {
+        room = lv_obj_get_scroll_bottom(obj);
+        if (dy > room) dy = room > 0 ? room : 0;
+    } else {
+        room = lv_obj_get_scroll_top(obj);
+        if (-dy > room) dy = room > 0 ? -room : 0;
+    }
+    if (dy == 0) return 0;
+
+    lv_obj_scroll_by(obj, 0, -dy, LV_ANIM_OFF);
+    hw_scroll_shift(obj, dy);
+    return dy;
+}
+
+static void auto_scroll_tick(lv_timer_t *timer) {
+    lv_coord_t dy;
+
+    // 按实际经过的时间累计，定时器迟到时一步多走几行
+    auto_acc += (uint32_t)auto_speed * lv_tick_elaps(auto_last_tick);
+    auto_last_tick = lv_tick_get();
+    dy = (lv_coord_t)(auto_acc / 1000);
+    auto_acc %= 1000;
+    if (dy == 0) return;
+
+    if (hw_scroll_by(auto_obj, dy) == 0) {
+        if (auto_end_cb == NULL || !auto_end_cb(auto_obj)) {
+            hw_scroll_auto_stop();
+        }
+    }
+}
+
+void hw_scroll_auto_start(lv_obj_t *obj, uint16_t px_per_s, hw_scroll_end_cb_t end_cb) {
+    hw_scroll_auto_stop();
+    auto_obj = obj;
+    auto_end_cb = end_cb;
+    auto_speed = px_per_s;
+    auto_acc = 0;
+    auto_last_tick = lv_tick_get();
+    // 滚动条每步都会变，关掉，避免它单独占用带宽
+    lv_obj_set_scrollbar_mode(obj, LV_SCROLLBAR_MODE_OFF);
+    auto_timer = lv_timer_create(auto_scroll_tick, HW_SCROLL_PERIOD_MS, NULL);
+}
+
+void hw_scroll_auto_stop(void) {
+    if (auto_timer != NULL) {
+        lv_timer_del(auto_timer);
+        auto_timer = NULL;
+    }
+    auto_obj = NULL;
+    auto_end_cb = NULL;
+}
+
+bool hw_scroll_auto_running(void) {
+    return auto_timer != NULL;
+}
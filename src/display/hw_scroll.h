@@ -0,0 +1,34 @@
+#ifndef HW_SCROLL_H_
+#define HW_SCROLL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lvgl/lvgl.h"
+
+// 硬件平滑滚动（LVGL线程）：对象内容上移时，面板的行原点跟着移动（jbd013_api.c: panel_scroll_rows），
+// LVGL照常重绘整个对象，经影子缓冲比较后只有新露出的行（和区域外被搬移的非黑行）上线，
+// 不再每步重发整个文字区，可以按像素连续滚动
+// 只有占满整行宽度的对象（提词器容器、字幕容器）能跟着行原点移动，其他对象只按普通失效处理
+// 依赖面板按偏移取行时对480回绕（行原点靠近两端时要用到），这一点只在panel_sim.c里按假设建模，
+// 还没有在面板上核实；核实之前默认关闭，滚动时按普通失效整区重绘，DISPLAY_HW_SCROLL=1打开
+#define HW_SCROLL_PERIOD_MS 20      // 自动滚动的步进周期
+
+// 自动滚动到底时调用：补充了内容（可以调整滚动位置）返回true，否则自动滚动停止
+typedef bool (*hw_scroll_end_cb_t)(lv_obj_t *obj);
+
+// 显示驱动提供（main.c）：把面板行原点的移动按顺序插入刷新队列，
+// 与随后重绘的区域在同一次SYNC生效
+void disp_flush_scroll(const lv_area_t *area, lv_coord_t dy);
+
+// 打开/关闭面板行原点移动（关闭时hw_scroll_shift只失效对象）
+void hw_scroll_set_enabled(bool enable);
+bool hw_scroll_enabled(void);
+// obj的内容已上移dy像素（dy<0为下移）：失效obj，并排队面板行原点的移动
+void hw_scroll_shift(lv_obj_t *obj, lv_coord_t dy);
+// 把可滚动对象的内容上移dy像素（不超出滚动范围），返回实际移动的像素
+lv_coord_t hw_scroll_by(lv_obj_t *obj, lv_coord_t dy);
+// 按px_per_s像素/秒自动滚动obj
+void hw_scroll_auto_start(lv_obj_t *obj, uint16_t px_per_s, hw_scroll_end_cb_t end_cb);
+void hw_scroll_auto_stop(void);
+bool hw_scroll_auto_running(void);
+#endif
@@ -1,15 +1,61 @@
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdint.h>
 #include <unistd.h>
+#include <time.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <pthread.h>
 #include "jbd013_api.h"
 #include "string.h"
 
+// 影子帧缓冲：记录已写入面板缓存的4bpp内容，写入前逐行比较，只发送变化的区间
+#define SHADOW_ROWS 480
+#define SHADOW_ROW_BYTES 320
+#define SHADOW_MERGE_GAP 16     // 相隔不超过16字节的变化区间合并发送（每段额外开销约6字节+一次片选）
+#define SHADOW_SEG_MAX 64
+
+static uint8_t shadow_fb[SHADOW_ROWS * SHADOW_ROW_BYTES];
+static uint8_t shadow_row_valid[SHADOW_ROWS];   // 整行内容已知才为1
+static bool panel_sync_pending = false;         // 有已发送但未同步的数据或寄存器修改
+static shadow_stats_t shadow_stats;
+static spi_wr_seg_t shadow_segs[SHADOW_SEG_MAX];
+static uint32_t shadow_seg_count = 0;
+static pthread_mutex_t shadow_mutex = PTHREAD_MUTEX_INITIALIZER;
+static const uint8_t zero_row[SHADOW_ROW_BYTES];
+
+// 1bit快速通道：单色区间（每个像素为0或15）按8像素/字节打包，用1bit写缓存指令发送
+static uint8_t mono_mode = PANEL_1BIT_OFF;
+static uint8_t mono_fb[SHADOW_ROWS * SHADOW_ROW_BYTES / 4];    // 影子缓冲的1bit镜像，按相同位置打包
+static spi_wr_seg_t mono_segs[SHADOW_SEG_MAX];
+static uint8_t mono_pack_lut[256];      // 4bpp字节 -> 2位；非单色为0xFF
+static uint8_t mono_thr_lut[256];       // 4bpp字节 -> 阈值化后的字节（>=8为15，否则为0）
+
+// 帧提交：一帧内的缓存写入和寄存器修改只发一次SYNC；
+// SYNC后面板需要约1ms (8MHz) 或 0.5ms (16MHz) 完成同步，记为截止时间，
+// 只有下次访问来得太早时才睡到截止时间
+#define PANEL_SETTLE_NS 1000000L
+static struct timespec settle_deadline;         // 上次SYNC后可再次写面板的时间
+static int frame_depth = 0;                     // panel_frame_begin嵌套深度
+
+// 行原点：逻辑行y存放在面板缓存的第(y + row_origin) % 480行，行偏移寄存器同时设为
+// PANEL_ROW_OFFSET_BASE + row_origin，面板按偏移从缓存取行，看到的画面与原点无关
+// 影子缓冲按缓存行存放，写入时换算
+// 注意：原点不为0时要求面板取行时(行号+偏移)对480回绕。这只是假设，面板资料没有写明，
+// panel_sim.c照此建模，所以模拟测试验证不了；若面板实际是截断，靠近边缘的行会显示错位。
+// 在面板上核实之前hw_scroll.c默认不调用panel_scroll_rows（DISPLAY_HW_SCROLL=1才打开）
+static int row_origin = 0;
+
+static inline uint16_t cache_row(uint16_t row) {
+    return (uint16_t)((row + row_origin + SHADOW_ROWS) % SHADOW_ROWS);
+}
+
 // 发送JBD013VGA面板的SPI指令给面板
 void send_cmd(uint8_t cmd) {
     uint8_t pBuf[1];
 
     pBuf[0] = cmd;
-    spi_tx_frame(pBuf);
+    spi_tx_frame(pBuf, sizeof(pBuf));
 }
 
 // 读取面板ID，返回面板ID
@@ -35,7 +81,7 @@ void wr_status_reg(uint8_t regAddr, uint8_t data) {
     pBuf[0] = regAddr;
     pBuf[1] = data;
 
-    spi_tx_frame(pBuf);
+    spi_tx_frame(pBuf, sizeof(pBuf));
 }
 
 // 读状态寄存器，寄存器地址regAddr，返回寄存器数据
@@ -48,15 +94,11 @@ void rd_status_reg(uint8_t regAddr) {
 
 // 写偏移寄存器，行偏移地址row（0~31），列偏移地址col（0~31）
 void wr_offset_reg(uint8_t row, uint8_t col) {
-    uint8_t pBuf[3];
-
-    pBuf[0] = 0xc0;
-    pBuf[1] = row;
-    pBuf[2] = col;
+    panel_cmd_batch_t batch;
 
-    spi_tx_frame(pBuf);
-    send_cmd(SPI_SYNC); //发送命令，数据同步
-    usleep(1 * 1000);   //1ms (8MHz) 或 0.5ms (16MHz)
+    cmd_batch_init(&batch);
+    batch_wr_offset_reg(&batch, row, col);
+    cmd_batch_send(&batch, 1);  //连同数据同步一次发出
 }
 
 // 读偏移寄存器，返回寄存器数据
@@ -73,7 +115,7 @@ void wr_cur_reg(uint8_t param) {
 
     pBuf[0] = 0x46;
     pBuf[1] = param;
-    spi_tx_frame(pBuf);
+    spi_tx_frame(pBuf, sizeof(pBuf));
 }
 
 // 读电流寄存器，返回寄存器数据
@@ -93,7 +135,7 @@ void wr_lum_reg(uint16_t param) {
     pBuf[0] = 0x36;
     pBuf[1] = param >> 8;
     pBuf[2] = param;
-    spi_tx_frame(pBuf);
+    spi_tx_frame(pBuf, sizeof(pBuf));
 }
 
 // 读亮度寄存器,返回寄存器数据
@@ -107,41 +149,462 @@ void rd_lum_reg(void) {
 // 设置镜像模式，[param = 0：正常显示], [param = 1：仅左右镜像]
 // [param = 2：只镜像上下], [param = 3：同时镜像上、下、左、右]
 void set_mirror_mode(uint8_t param) {
-    send_cmd(SPI_DISPLAY_DEFAULT_MODE);
-    if (param == 1 || param == 3) {
-        send_cmd(SPI_DISPLAY_RL);
+    panel_cmd_batch_t batch;
+
+    cmd_batch_init(&batch);
+    batch_mirror_mode(&batch, param);
+    cmd_batch_send(&batch, 1);
+}
+
+// 上次SYNC的同步时间未到则睡到截止时间（调用者持有shadow_mutex）
+static void panel_settle_wait(void) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (now.tv_sec > settle_deadline.tv_sec ||
+        (now.tv_sec == settle_deadline.tv_sec && now.tv_nsec >= settle_deadline.tv_nsec)) {
+        return;
     }
-    if (param == 2 || param == 3) {
-        send_cmd(SPI_DISPLAY_UD);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &settle_deadline, NULL) == EINTR) {
     }
+}
+
+// 刚发送过SYNC：记下同步完成的截止时间
+static void panel_settle_start(void) {
+    clock_gettime(CLOCK_MONOTONIC, &settle_deadline);
+    settle_deadline.tv_nsec += PANEL_SETTLE_NS;
+    if (settle_deadline.tv_nsec >= 1000000000L) {
+        settle_deadline.tv_sec++;
+        settle_deadline.tv_nsec -= 1000000000L;
+    }
+    panel_sync_pending = false;
+}
+
+// 不在帧内且有待同步内容时发送SYNC，并记下同步完成的截止时间（调用者持有shadow_mutex）
+static void panel_commit_locked(void) {
+    if (!panel_sync_pending || frame_depth > 0) {
+        return;
+    }
+    panel_settle_wait();
     send_cmd(SPI_SYNC);
-    usleep(1 * 1000);
+    panel_settle_start();
+}
+
+// 开始一帧：此后的同步请求推迟到对应的panel_frame_end，可嵌套
+void panel_frame_begin(void) {
+    pthread_mutex_lock(&shadow_mutex);
+    frame_depth++;
+    pthread_mutex_unlock(&shadow_mutex);
+}
+
+// 结束一帧：最外层结束时统一提交一次
+void panel_frame_end(void) {
+    pthread_mutex_lock(&shadow_mutex);
+    if (frame_depth > 0) {
+        frame_depth--;
+    }
+    panel_commit_locked();
+    pthread_mutex_unlock(&shadow_mutex);
+}
+
+// 请求同步（寄存器修改后调用），帧内推迟到帧结束
+void panel_sync(void) {
+    pthread_mutex_lock(&shadow_mutex);
+    panel_sync_pending = true;
+    panel_commit_locked();
+    pthread_mutex_unlock(&shadow_mutex);
+}
+
+// 指令批量发送：按顺序记录多条寄存器指令，一次ioctl发出
+void cmd_batch_init(panel_cmd_batch_t* batch) {
+    batch->count = 0;
+}
+
+// 追加一条指令，data为指令字节加参数，len为实际长度
+int cmd_batch_add(panel_cmd_batch_t* batch, const uint8_t* data, uint8_t len) {
+    if (batch->count >= PANEL_CMD_BATCH_MAX || len == 0 || len > SPI_CMD_MAX_LEN) {
+        printf("错误：指令批量已满或长度无效 (%u)\n", len);
+        return -1;
+    }
+    memcpy(batch->cmds[batch->count].buf, data, len);
+    batch->cmds[batch->count].len = len;
+    batch->count++;
+    return 0;
+}
+
+int batch_cmd(panel_cmd_batch_t* batch, uint8_t cmd) {
+    return cmd_batch_add(batch, &cmd, 1);
+}
+
+int batch_wr_status_reg(panel_cmd_batch_t* batch, uint8_t regAddr, uint8_t data) {
+    uint8_t pBuf[2] = { regAddr, data };
+    return cmd_batch_add(batch, pBuf, sizeof(pBuf));
+}
+
+int batch_wr_offset_reg(panel_cmd_batch_t* batch, uint8_t row, uint8_t col) {
+    uint8_t pBuf[3] = { SPI_WR_OFFSET_REG, row, col };
+    return cmd_batch_add(batch, pBuf, sizeof(pBuf));
+}
+
+int batch_wr_cur_reg(panel_cmd_batch_t* batch, uint8_t param) {
+    uint8_t pBuf[2] = { SPI_WR_CURRENT_REG, param };
+    return cmd_batch_add(batch, pBuf, sizeof(pBuf));
+}
+
+int batch_wr_lum_reg(panel_cmd_batch_t* batch, uint16_t param) {
+    uint8_t pBuf[3] = { SPI_WR_LUM_REG, (uint8_t)(param >> 8), (uint8_t)param };
+    return cmd_batch_add(batch, pBuf, sizeof(pBuf));
+}
+
+// 镜像模式参数同set_mirror_mode
+int batch_mirror_mode(panel_cmd_batch_t* batch, uint8_t param) {
+    int ret = batch_cmd(batch, SPI_DISPLAY_DEFAULT_MODE);
+    if (ret == 0 && (param == 1 || param == 3)) {
+        ret = batch_cmd(batch, SPI_DISPLAY_RL);
+    }
+    if (ret == 0 && (param == 2 || param == 3)) {
+        ret = batch_cmd(batch, SPI_DISPLAY_UD);
+    }
+    return ret;
+}
+
+// 发送批量指令；sync非0时请求同步：不在帧内则把SYNC拼在同一次ioctl末尾，帧内推迟到帧结束
+// （调用者持有shadow_mutex）
+static int cmd_batch_send_locked(panel_cmd_batch_t* batch, uint8_t sync) {
+    bool with_sync = false;
+    int ret;
+
+    if (sync) {
+        panel_sync_pending = true;
+        if (frame_depth == 0 && batch_cmd(batch, SPI_SYNC) == 0) {
+            with_sync = true;
+            panel_settle_wait();
+        }
+    }
+    ret = spi_tx_cmds(batch->cmds, batch->count);
+    if (with_sync) {
+        panel_settle_start();
+    } else {
+        panel_commit_locked();
+    }
+    batch->count = 0;
+    return ret;
+}
+
+int cmd_batch_send(panel_cmd_batch_t* batch, uint8_t sync) {
+    int ret;
+
+    pthread_mutex_lock(&shadow_mutex);
+    ret = cmd_batch_send_locked(batch, sync);
+    pthread_mutex_unlock(&shadow_mutex);
+    return ret;
+}
+
+// 设置1bit通道：PANEL_1BIT_OFF全部按4bpp发送；PANEL_1BIT_AUTO自动识别单色区间；
+// PANEL_1BIT_FORCE声明整屏为单色，写入时按阈值二值化，全部按1bit发送
+void panel_set_1bit_mode(uint8_t mode) {
+    uint32_t b;
+
+    if (mode > PANEL_1BIT_FORCE) {
+        return;
+    }
+    pthread_mutex_lock(&shadow_mutex);
+    if (mono_pack_lut[0x0F] == 0) {
+        for (b = 0; b < 256; b++) {
+            uint8_t hi = b >> 4, lo = b & 0x0F;
+            bool mono = (hi == 0 || hi == 0x0F) && (lo == 0 || lo == 0x0F);
+            mono_pack_lut[b] = mono ? (uint8_t)(((hi >> 3) << 1) | (lo >> 3)) : 0xFF;
+            mono_thr_lut[b] = ((hi >= 8) ? 0xF0 : 0) | ((lo >= 8) ? 0x0F : 0);
+        }
+    }
+    mono_mode = mode;
+    pthread_mutex_unlock(&shadow_mutex);
+}
+
+// 尝试把一段影子缓冲转换为1bit段：首尾扩展到8像素对齐（扩展部分取自影子缓冲，内容不变），
+// 全部为单色时打包到mono_fb并返回true
+static bool shadow_span_to_1bit(uint32_t offset, uint32_t len, spi_wr_seg_t* seg) {
+    uint32_t o0 = offset & ~3u;
+    uint32_t o1 = (offset + len + 3) & ~3u;
+    uint32_t o;
+
+    // 对齐到8像素时会带上区间外的字节，所在行内容未知（复位、失效后）时那些字节不可信，改走4bpp
+    if ((o0 < offset && !shadow_row_valid[o0 / SHADOW_ROW_BYTES]) ||
+        (o1 > offset + len && !shadow_row_valid[(o1 - 1) / SHADOW_ROW_BYTES])) {
+        return false;
+    }
+    for (o = o0; o < o1; o += 4) {
+        uint8_t p0 = mono_pack_lut[shadow_fb[o]];
+        uint8_t p1 = mono_pack_lut[shadow_fb[o + 1]];
+        uint8_t p2 = mono_pack_lut[shadow_fb[o + 2]];
+        uint8_t p3 = mono_pack_lut[shadow_fb[o + 3]];
+        if ((p0 | p1 | p2 | p3) == 0xFF) {
+            return false;
+        }
+        mono_fb[o / 4] = (uint8_t)((p0 << 6) | (p1 << 4) | (p2 << 2) | p3);
+    }
+    seg->col = (o0 % SHADOW_ROW_BYTES) * 2;
+    seg->row = o0 / SHADOW_ROW_BYTES;
+    seg->pBuf = &mono_fb[o0 / 4];
+    seg->len = (o1 - o0) / 4;
+    return true;
+}
+
+// 发送已收集的变化区间（1bit通道打开时单色区间改用1bit指令）
+static void shadow_flush_segs(void) {
+    uint32_t i, n4 = 0, n1 = 0;
+
+    if (shadow_seg_count == 0) {
+        return;
+    }
+    for (i = 0; i < shadow_seg_count; i++) {
+        uint32_t offset = shadow_segs[i].pBuf - shadow_fb;
+        if (mono_mode != PANEL_1BIT_OFF &&
+            shadow_span_to_1bit(offset, shadow_segs[i].len, &mono_segs[n1])) {
+            shadow_stats.bytes_sent += mono_segs[n1].len;
+            shadow_stats.bytes_1bit += mono_segs[n1].len;
+            n1++;
+        } else {
+            shadow_stats.bytes_sent += shadow_segs[i].len;
+            shadow_segs[n4++] = shadow_segs[i];
+        }
+    }
+    shadow_stats.spans += shadow_seg_count;
+    shadow_stats.spans_1bit += n1;
+    panel_settle_wait();
+    if (n4 > 0) {
+        spi_wr_segments(shadow_segs, n4);
+    }
+    if (n1 > 0) {
+        spi_wr_segments_1bit(mono_segs, n1);
+    }
+    shadow_seg_count = 0;
+    panel_sync_pending = true;
+}
+
+// 添加一个变化区间（数据指向影子缓冲），与上一段线性相邻时直接延长
+static void shadow_add_span(uint32_t offset, uint32_t len) {
+    if (shadow_seg_count > 0) {
+        spi_wr_seg_t* last = &shadow_segs[shadow_seg_count - 1];
+        if (last->pBuf + last->len == &shadow_fb[offset]) {
+            last->len += len;
+            return;
+        }
+    }
+    if (shadow_seg_count == SHADOW_SEG_MAX) {
+        shadow_flush_segs();
+    }
+    shadow_segs[shadow_seg_count].col = (offset % SHADOW_ROW_BYTES) * 2;
+    shadow_segs[shadow_seg_count].row = offset / SHADOW_ROW_BYTES;
+    shadow_segs[shadow_seg_count].pBuf = &shadow_fb[offset];
+    shadow_segs[shadow_seg_count].len = len;
+    shadow_seg_count++;
+}
+
+static inline uint32_t load32(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+// 比较一行中的一段数据，更新影子缓冲并记录变化区间
+static void shadow_diff_row(uint16_t row, uint16_t colByte, const uint8_t* src, uint32_t n) {
+    uint32_t offset = row * SHADOW_ROW_BYTES + colByte;
+    uint8_t* dst = &shadow_fb[offset];
+    uint8_t thr[SHADOW_ROW_BYTES];
+    uint32_t i = 0;
+
+    shadow_stats.bytes_in += n;
+    if (mono_mode == PANEL_1BIT_FORCE) {
+        // 整屏声明为单色：先二值化，影子缓冲与面板内容保持一致
+        for (i = 0; i < n; i++) {
+            thr[i] = mono_thr_lut[src[i]];
+        }
+        src = thr;
+        i = 0;
+    }
+    if (!shadow_row_valid[row]) {
+        // 行内容未知，整段发送；写满整行后该行变为已知
+        memcpy(dst, src, n);
+        shadow_add_span(offset, n);
+        if (colByte == 0 && n == SHADOW_ROW_BYTES) {
+            shadow_row_valid[row] = 1;
+        }
+        return;
+    }
+    if (memcmp(dst, src, n) == 0) {
+        return;
+    }
+    while (i < n) {
+        uint32_t start, last, j;
+
+        // 按字跳过相同部分
+        while (i + 4 <= n && load32(dst + i) == load32(src + i)) {
+            i += 4;
+        }
+        while (i < n && dst[i] == src[i]) {
+            i++;
+        }
+        if (i >= n) {
+            break;
+        }
+        // 向后扩展，直到连续相同字节超过合并间隔
+        start = i;
+        last = i;
+        for (j = i + 1; j < n && j - last <= SHADOW_MERGE_GAP; j++) {
+            if (dst[j] != src[j]) {
+                last = j;
+            }
+        }
+        memcpy(dst + start, src + start, last - start + 1);
+        shadow_add_span(offset + start, last - start + 1);
+        i = last + 1;
+    }
+}
+
+// 把一段按行优先线性递增的数据拆成行，逐行比较
+static void shadow_diff_seg(uint16_t col, uint16_t row, const uint8_t* pBuf, uint32_t len) {
+    if (col & 1) {
+        // 奇数列与字节不对齐，直接发送，并把涉及的行标记为未知；
+        // 跨过缓存最后一行时在那里拆成两段，第二段从缓存第0行接着写
+        spi_wr_seg_t seg[2] = { { col, cache_row(row), pBuf, len } };
+        uint32_t nseg = 1;
+        uint32_t rows = (col / 2 + len + SHADOW_ROW_BYTES - 1) / SHADOW_ROW_BYTES;
+        uint32_t room = (SHADOW_ROWS - seg[0].row) * SHADOW_ROW_BYTES - col / 2;
+        uint32_t i;
+
+        if (len > room) {
+            seg[0].len = room;
+            seg[1].col = 1;
+            seg[1].row = 0;
+            seg[1].pBuf = pBuf + room;
+            seg[1].len = len - room;
+            nseg = 2;
+        }
+        shadow_flush_segs();
+        panel_settle_wait();
+        spi_wr_segments(seg, nseg);
+        shadow_stats.bytes_in += len;
+        shadow_stats.bytes_sent += len;
+        shadow_stats.spans += nseg;
+        panel_sync_pending = true;
+        for (i = 0; i < rows && row + i < SHADOW_ROWS; i++) {
+            shadow_row_valid[cache_row(row + i)] = 0;
+        }
+        return;
+    }
+    col /= 2;
+    while (len > 0 && row < SHADOW_ROWS && col < SHADOW_ROW_BYTES) {
+        uint32_t n = SHADOW_ROW_BYTES - col;
+        if (n > len) {
+            n = len;
+        }
+        shadow_diff_row(cache_row(row), col, pBuf, n);
+        pBuf += n;
+        len -= n;
+        col = 0;
+        row++;
+    }
+}
+
+// 影子缓冲失效（面板复位后缓存内容未知）
+void shadow_invalidate(void) {
+    pthread_mutex_lock(&shadow_mutex);
+    memset(shadow_row_valid, 0, sizeof(shadow_row_valid));
+    pthread_mutex_unlock(&shadow_mutex);
+}
+
+// 获取影子缓冲统计
+void shadow_stats_get(shadow_stats_t* stats) {
+    pthread_mutex_lock(&shadow_mutex);
+    *stats = shadow_stats;
+    pthread_mutex_unlock(&shadow_mutex);
+}
+
+void shadow_stats_reset(void) {
+    pthread_mutex_lock(&shadow_mutex);
+    memset(&shadow_stats, 0, sizeof(shadow_stats));
+    pthread_mutex_unlock(&shadow_mutex);
+}
+
+// 打印影子缓冲统计：请求写入字节、实际发送字节、节省比例
+void shadow_stats_print(void) {
+    shadow_stats_t st;
+
+    shadow_stats_get(&st);
+    printf("影子缓冲: 请求 %llu 字节, 发送 %llu 字节 (%llu 段, 其中1bit %llu 段 %llu 字节), 节省 %llu 字节",
+           (unsigned long long)st.bytes_in, (unsigned long long)st.bytes_sent,
+           (unsigned long long)st.spans, (unsigned long long)st.spans_1bit,
+           (unsigned long long)st.bytes_1bit, (unsigned long long)(st.bytes_in - st.bytes_sent));
+    if (st.bytes_in > 0) {
+        printf(" (%.1f%%)", 100.0 * (st.bytes_in - st.bytes_sent) / st.bytes_in);
+    }
+    printf("\n");
+}
+
+// 用固定灰度（0~15）填充矩形区域，col/row为左上角像素坐标，width/height为像素宽高
+// 整行相同的数据取自共享的填充页，全宽矩形经影子缓冲合并成一次突发写；
+// 奇数边界只改写对应的半字节，另一半取自影子缓冲
+void fill_rect(uint16_t col, uint16_t row, uint16_t width, uint16_t height, uint8_t gray, uint8_t sync) {
+    static uint8_t fill_page[SHADOW_ROW_BYTES];
+    const uint8_t* page = zero_row;
+    uint8_t pix = (gray & 0x0F) | ((gray & 0x0F) << 4);
+    uint16_t rowEnd, colEnd, c0, c1;
+
+    if (col >= 640 || row >= SHADOW_ROWS || width == 0 || height == 0) {
+        return;
+    }
+    colEnd = (col + width > 640) ? 640 : col + width;           // 不含
+    rowEnd = (row + height > SHADOW_ROWS) ? SHADOW_ROWS : row + height;
+    c0 = (col + 1) / 2;         // 第一个整字节
+    c1 = colEnd / 2;            // 最后一个整字节之后
+
+    pthread_mutex_lock(&shadow_mutex);
+    if (pix != 0) {
+        memset(fill_page, pix, sizeof(fill_page));
+        page = fill_page;
+    }
+    for (; row < rowEnd; row++) {
+        uint16_t crow = cache_row(row);
+        const uint8_t* old = &shadow_fb[crow * SHADOW_ROW_BYTES];
+        // 行内容未知（复位、失效后）时影子里的相邻像素不可信，边界字节整个写填充值
+        uint8_t known = shadow_row_valid[crow];
+        uint8_t edge;
+
+        if (col & 1) {
+            // 左边界为奇数列：只改写低4位
+            edge = known ? (old[col / 2] & 0xF0) | (pix & 0x0F) : pix;
+            shadow_diff_row(crow, col / 2, &edge, 1);
+        }
+        if (c1 > c0) {
+            shadow_diff_row(crow, c0, page, c1 - c0);
+        }
+        if ((colEnd & 1) && colEnd / 2 >= c0) {
+            // 右边界止于偶数列：只改写高4位
+            edge = known ? (pix & 0xF0) | (old[colEnd / 2] & 0x0F) : pix;
+            shadow_diff_row(crow, colEnd / 2, &edge, 1);
+        }
+    }
+    shadow_flush_segs();
+    if (sync) {
+        panel_commit_locked();
+    }
+    pthread_mutex_unlock(&shadow_mutex);
+}
+
+// 清除矩形区域（填充黑色）
+void clear_rect(uint16_t col, uint16_t row, uint16_t width, uint16_t height, uint8_t sync) {
+    fill_rect(col, row, width, height, 0, sync);
 }
 
 // 清空缓存
 void clr_cache(void) {
-    uint8_t pBuf[10];
-    uint32_t pBufLen = sizeof(pBuf);
-    uint8_t addrStep = pBufLen * 2;
-    uint16_t rowCnt, colCnt;
-
-    memset(pBuf, 0, pBufLen);
-    spi_wr_buffer(0,0,pBuf,pBufLen);
-     for (rowCnt = 0; rowCnt < 480; rowCnt++) {
-         for (colCnt = 0; colCnt < 640; colCnt += addrStep) {
-             spi_wr_buffer(colCnt, rowCnt, pBuf, pBufLen);
-         }
-        if (640 % addrStep != 0) {
-             spi_wr_buffer((640 - 640 % addrStep), rowCnt, pBuf, 640 % addrStep);
-         }
-     }
+    fill_rect(0, 0, 640, SHADOW_ROWS, 0, 0);
 }
 
 // 显示图像，指向图像数据的指针pBuf，图片数据的长度len（0~153600）
 void display_image(uint16_t row, uint16_t col, uint8_t *pBuf, uint32_t len) {
-    spi_wr_buffer(col, row, pBuf, len);
-    send_cmd(SPI_SYNC);            //同步缓存数据
-    usleep(1 * 1000);              //1ms (8MHz) 或 0.5ms (16MHz)
+    display_image_sync(row, col, pBuf, len, 1);
 }
 
 /**
@@ -153,11 +616,86 @@ void display_image(uint16_t row, uint16_t col, uint8_t *pBuf, uint32_t len) {
  * @param sync 是否立即同步
  */
 void display_image_sync(uint16_t row, uint16_t col, uint8_t *pBuf, uint32_t len, uint8_t sync) {
-    spi_wr_buffer(col, row, pBuf, len);
+    pthread_mutex_lock(&shadow_mutex);
+    shadow_diff_seg(col, row, pBuf, len);
+    shadow_flush_segs();
     if (sync) {
-        send_cmd(SPI_SYNC);            // 同步缓存数据
-        usleep(1 * 1000);             // 1ms (8MHz) 或 0.5ms (16MHz)
+        panel_commit_locked();
+    }
+    pthread_mutex_unlock(&shadow_mutex);
+}
+
+// 显示多段图像数据（可以是不连续的行片段），只发送变化部分，全部写完后同步一次
+void display_segments(const spi_wr_seg_t* segs, uint32_t count) {
+    uint32_t i;
+
+    pthread_mutex_lock(&shadow_mutex);
+    for (i = 0; i < count; i++) {
+        shadow_diff_seg(segs[i].col, segs[i].row, segs[i].pBuf, segs[i].len);
     }
+    shadow_flush_segs();
+    panel_commit_locked();
+    pthread_mutex_unlock(&shadow_mutex);
+}
+
+// 硬件滚动：逻辑行[y0, y0+h)（整行宽）的内容将上移dy行（dy<0为下移），调用者随后重新写入这些行
+// （例如LVGL重绘整个区域，经影子缓冲比较后只发送对不上的部分）。
+// 行原点随之移动dy：区域内的旧内容在缓存中原地不动就到了新位置，只有新露出的|dy|行要发送；
+// 区域外的行内容不变，但缓存位置随原点移动，从影子缓冲取出写到新位置（黑色等没变的字节不发送）。
+// 偏移寄存器范围不够时原点跳到另一端，这一步区域内容对不上、要整体重发，之后又能连续滚动约30行。
+// 偏移寄存器和数据在同一次SYNC生效，帧内推迟到panel_frame_end
+void panel_scroll_rows(uint16_t y0, uint16_t h, int16_t dy) {
+    static uint8_t snap[SHADOW_ROWS * SHADOW_ROW_BYTES];    // 移动前的影子缓冲（源行和目标行有重叠）
+    static uint8_t snap_valid[SHADOW_ROWS];
+    panel_cmd_batch_t batch;
+    int old, origin;
+    uint16_t y;
+
+    if (dy == 0 || y0 >= SHADOW_ROWS) {
+        return;
+    }
+    pthread_mutex_lock(&shadow_mutex);
+    old = row_origin;
+    origin = old + dy;
+    if (origin < PANEL_ROW_ORIGIN_MIN || origin > PANEL_ROW_ORIGIN_MAX) {
+        origin = (dy > 0) ? PANEL_ROW_ORIGIN_MIN : PANEL_ROW_ORIGIN_MAX;
+    }
+    if (origin == old) {
+        pthread_mutex_unlock(&shadow_mutex);
+        return;
+    }
+    memcpy(snap, shadow_fb, sizeof(snap));
+    memcpy(snap_valid, shadow_row_valid, sizeof(snap_valid));
+    row_origin = origin;
+
+    for (y = 0; y < SHADOW_ROWS; y++) {
+        uint16_t src = (uint16_t)((y + old + SHADOW_ROWS) % SHADOW_ROWS);
+        uint16_t dst = cache_row(y);
+
+        if (y >= y0 && y - y0 < h) {
+            continue;           // 区域内由调用者重写
+        }
+        if (!snap_valid[src]) {
+            shadow_row_valid[dst] = 0;      // 原内容未知，搬过去也未知
+            continue;
+        }
+        shadow_diff_row(dst, 0, &snap[src * SHADOW_ROW_BYTES], SHADOW_ROW_BYTES);
+    }
+    shadow_flush_segs();
+
+    cmd_batch_init(&batch);
+    batch_wr_offset_reg(&batch, (uint8_t)(PANEL_ROW_OFFSET_BASE + origin), PANEL_COL_OFFSET_BASE);
+    cmd_batch_send_locked(&batch, 1);
+    pthread_mutex_unlock(&shadow_mutex);
+}
+
+int panel_get_row_origin(void) {
+    int origin;
+
+    pthread_mutex_lock(&shadow_mutex);
+    origin = row_origin;
+    pthread_mutex_unlock(&shadow_mutex);
+    return origin;
 }
 
 // 复位面板
@@ -165,26 +703,33 @@ void panel_rst(void) {
     send_cmd(SPI_RST_EN);
     send_cmd(SPI_RST);
     usleep(50 * 1000);
+    shadow_invalidate();
 }
 
-// 初始化面板
+// 初始化面板：复位后先清缓存，寄存器设置和最后的同步合并为一次ioctl
 void panel_init(void) {
-    panel_rst();                            //复位面板
-    send_cmd(SPI_WR_ENABLE);                //写入使能
-    wr_cur_reg(30);                          //设置电流寄存器
-    wr_status_reg(SPI_WR_STATUS_REG1, 0x10);//写状态寄存器1，关闭demura
-    wr_lum_reg(3000);                       //写亮度寄存器
-    wr_status_reg(SPI_WR_STATUS_REG2, 0x05);//写状态寄存器2
-    clr_cache();                            //清除缓存
-    wr_offset_reg(0, 0);                    //设置左上角偏移量
-    wr_offset_reg(0, 20);                   //设置右上角的偏移量
-    wr_offset_reg(24, 0);                   //设置左下角的偏移量
-    wr_offset_reg(24, 20);                  //设置右下角的偏移量
-    wr_offset_reg(12, 10);                  //设置实际偏移量，屏幕居中
-    wr_lum_reg(3000);                       //写亮度寄存器原本1000
-    wr_cur_reg(30);                          //设置电流寄存器
-    set_mirror_mode(1);                     //默认镜像模式
-    send_cmd(SPI_DISPLAY_ENABLE);           //设置显示启用
-    send_cmd(SPI_SYNC);                     //同步设置
-    usleep(1 * 1000);
-}
\ No newline at end of file
+    panel_cmd_batch_t batch;
+
+    pthread_mutex_lock(&shadow_mutex);
+    row_origin = 0;                                 //偏移寄存器回到居中值，逻辑行与缓存行一致
+    pthread_mutex_unlock(&shadow_mutex);
+    panel_rst();                                    //复位面板
+    clr_cache();                                    //清除缓存
+
+    cmd_batch_init(&batch);
+    batch_cmd(&batch, SPI_WR_ENABLE);               //写入使能
+    batch_wr_cur_reg(&batch, 30);                   //设置电流寄存器
+    batch_wr_status_reg(&batch, SPI_WR_STATUS_REG1, 0x10);//写状态寄存器1，关闭demura
+    batch_wr_lum_reg(&batch, 3000);                 //写亮度寄存器
+    batch_wr_status_reg(&batch, SPI_WR_STATUS_REG2, 0x05);//写状态寄存器2
+    batch_wr_offset_reg(&batch, 0, 0);              //设置左上角偏移量
+    batch_wr_offset_reg(&batch, 0, 20);             //设置右上角的偏移量
+    batch_wr_offset_reg(&batch, 24, 0);             //设置左下角的偏移量
+    batch_wr_offset_reg(&batch, 24, 20);            //设置右下角的偏移量
+    batch_wr_offset_reg(&batch, PANEL_ROW_OFFSET_BASE, PANEL_COL_OFFSET_BASE);//设置实际偏移量，屏幕居中
+    batch_wr_lum_reg(&batch, 3000);                 //写亮度寄存器原本1000
+    batch_wr_cur_reg(&batch, 30);                   //设置电流寄存器
+    batch_mirror_mode(&batch, 1);                   //默认镜像模式
+    batch_cmd(&batch, SPI_DISPLAY_ENABLE);          //设置显示启用
+    cmd_batch_send(&batch, 1);                      //同步设置
+}
@@ -45,6 +45,35 @@
 #define SPI_SELF_TEST_CHK_II 0x16
 #define SPI_RD_TEMP_SENSOR 0x26
 
+// 影子帧缓冲统计
+typedef struct {
+    uint64_t bytes_in;      // 调用者请求写入的字节数
+    uint64_t bytes_sent;    // 比较后实际发送的字节数
+    uint64_t spans;         // 发送的区间数
+    uint64_t spans_1bit;    // 其中按1bit发送的区间数
+    uint64_t bytes_1bit;    // 按1bit发送的字节数
+} shadow_stats_t;
+
+// 1bit快速通道模式
+#define PANEL_1BIT_OFF 0        // 全部按4bpp发送
+#define PANEL_1BIT_AUTO 1       // 自动识别单色区间按1bit发送
+#define PANEL_1BIT_FORCE 2      // 整屏声明为单色，阈值二值化后全部按1bit发送
+
+// 偏移寄存器：行、列偏移范围0~31，平时为居中值；
+// 硬件滚动（panel_scroll_rows）时行偏移在基准值上加行原点，行原点的范围由寄存器范围决定
+#define PANEL_OFFSET_MAX 31
+#define PANEL_ROW_OFFSET_BASE 12
+#define PANEL_COL_OFFSET_BASE 10
+#define PANEL_ROW_ORIGIN_MIN (-PANEL_ROW_OFFSET_BASE)
+#define PANEL_ROW_ORIGIN_MAX (PANEL_OFFSET_MAX - PANEL_ROW_OFFSET_BASE)
+
+// 寄存器指令批量
+#define PANEL_CMD_BATCH_MAX 32
+typedef struct {
+    spi_cmd_t cmds[PANEL_CMD_BATCH_MAX];
+    uint32_t count;
+} panel_cmd_batch_t;
+
 //***************** JBD013VGA api *****************//
 void send_cmd(uint8_t cmd);
 void read_id(void);
@@ -59,9 +88,31 @@ void wr_lum_reg(uint16_t param);
 void rd_lum_reg(void);
 void set_mirror_mode(uint8_t param);
 void clr_cache(void);
+void fill_rect(uint16_t col, uint16_t row, uint16_t width, uint16_t height, uint8_t gray, uint8_t sync);
+void clear_rect(uint16_t col, uint16_t row, uint16_t width, uint16_t height, uint8_t sync);
 void display_image(uint16_t row, uint16_t col, uint8_t* pBuf, uint32_t len);
 void panel_rst(void);
 void panel_init(void);
 void pixel_test(void);
 void display_image_sync(uint16_t row, uint16_t col, uint8_t *pBuf, uint32_t len, uint8_t sync) ;
+void display_segments(const spi_wr_seg_t* segs, uint32_t count);
+void panel_frame_begin(void);
+void panel_frame_end(void);
+void panel_sync(void);
+void cmd_batch_init(panel_cmd_batch_t* batch);
+int cmd_batch_add(panel_cmd_batch_t* batch, const uint8_t* data, uint8_t len);
+int batch_cmd(panel_cmd_batch_t* batch, uint8_t cmd);
+int batch_wr_status_reg(panel_cmd_batch_t* batch, uint8_t regAddr, uint8_t data);
+int batch_wr_offset_reg(panel_cmd_batch_t* batch, uint8_t row, uint8_t col);
+int batch_wr_cur_reg(panel_cmd_batch_t* batch, uint8_t param);
+int batch_wr_lum_reg(panel_cmd_batch_t* batch, uint16_t param);
+int batch_mirror_mode(panel_cmd_batch_t* batch, uint8_t param);
+int cmd_batch_send(panel_cmd_batch_t* batch, uint8_t sync);
+void panel_set_1bit_mode(uint8_t mode);
+void shadow_invalidate(void);
+void panel_scroll_rows(uint16_t y0, uint16_t h, int16_t dy);
+int panel_get_row_origin(void);
+void shadow_stats_get(shadow_stats_t* stats);
+void shadow_stats_reset(void);
+void shadow_stats_print(void);
 #endif
\ No newline at end of file
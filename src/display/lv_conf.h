@@ -71,9 +71,9 @@
 
 /*Use a custom tick source that tells the elapsed time in milliseconds.
  *It removes the need to manually update the tick with `lv_tick_inc()`)*/
-#define LV_TICK_CUSTOM 0
+#define LV_TICK_CUSTOM 1
 #if LV_TICK_CUSTOM
-	#define LV_TICK_CUSTOM_INCLUDE "stdint.h"         /*Header for the system time function*/
+	#define LV_TICK_CUSTOM_INCLUDE "reactor.h"        /*custom_tick_get(): CLOCK_MONOTONIC毫秒*/
 	#define LV_TICK_CUSTOM_SYS_TIME_EXPR (custom_tick_get())    /*Expression evaluating to current system time in ms*/
 #endif   /*LV_TICK_CUSTOM*/
 
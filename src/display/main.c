@@ -27,13 +27,24 @@
 #include "ui.h"
 #include "lvgl/lvgl.h"
 #include "bat_capacity.h"
+#include "panel_sim.h"
+#include "pix_kernels.h"
+#include "pix_scale.h"
+#include "disp_l4.h"
+#include "ui_queue.h"
+#include "reactor.h"
+#include "msg_bus.h"
+#include "display_cmds.h"
+#include "caption_log.h"
+#include "doc_pager.h"
+#include "hw_scroll.h"
+#include "glyph_cache.h"
 // #include "ui.h"       // 如果你用的是 SquareLine 的 ui_init()
 #define SPI_DEVICE_PATH "/dev/spidev0.0"
 #define IMU_ACCEL_Y_PATH "/sys/bus/iio/devices/iio:device2/in_accel_y_raw"
 #define SHM_NAME "/display_shm"       // 共享内存名称
 #define SEM_NAME "/display_sem"       // 信号量名称
 #define BUFFER_SIZE 128               // 消息缓冲区大小
-#define ACCUMULATED_TEXT_SIZE 1024    // 累积文本缓冲区大小
 
 // 在main.c的全局变量区域添加
 extern lv_obj_t *ui_Label2;  // 声明外部变量，指向"微笑"标签
@@ -74,31 +85,32 @@ extern lv_obj_t *ui_SubMenu_Personalize;
 extern lv_obj_t *ui_SubMenu_Attitude;
 extern lv_obj_t *ui_SubMenu_Exit;
 extern lv_obj_t *ui_SubMenu_Rect;
-volatile bool hide_smile_flag = false;  // 线程安全标志位
 static int image_saved = 0;
 int spi_file;
-#define DISP_BUF_SIZE   (640 * 480) 
+#define DISP_BUF_PX     (640 * 480)
 static lv_disp_drv_t disp_drv;        // 显示驱动
 static lv_disp_draw_buf_t draw_buf;    // 显示绘制缓冲区
-static uint8_t disp_buf[DISP_BUF_SIZE]; 
+// LVGL直接渲染打包的4bpp（disp_l4.c），每个缓冲区150KB，内容即面板写缓存格式
+static uint8_t disp_buf[DISP_L4_BUF_SIZE(DISP_BUF_PX)];
+static uint8_t disp_buf2[DISP_L4_BUF_SIZE(DISP_BUF_PX)];  // 第二绘制缓冲区：LVGL渲染下一帧时上一帧仍在SPI发送
 
 int display_inited = 0;  // 显示状态标记
 int running = 1;         // 程序运行标记
 sem_t *semaphore;        // 信号量指针
-char *shared_memory;     // 共享内存指针
+char *shared_memory;     // 共享内存指针（旧协议，由legacy_bridge_thread转发到消息总线）
+static msg_bus_t display_bus;  // 消息总线：display_update_thread订阅，旧协议桥接发布
 
-// 累积文本显示相关变量
-static char accumulated_text[ACCUMULATED_TEXT_SIZE] = {0};  // 累积文本缓冲区
-static size_t accumulated_text_len = 0;  // 当前累积文本长度
+// 累积文本显示相关变量（文本本身存在字幕日志控件ui_Label2的行记录环里）
 static char last_displayed_message[BUFFER_SIZE] = {0};  // 上次显示的消息，用于检测新消息
 
-// 提词器相关变量
-static int teleprompter_read_position = 0;  // 当前读取位置（已读字符数）
-static char teleprompter_buffer[301] = {0};  // 存储读取的文本（100个汉字 + 1个结束符）
-
-// 备忘录相关变量
-static int memo_read_position = 0;  // 当前读取位置（已读字符数）
-static char memo_buffer[301] = {0};  // 存储读取的文本（100个汉字 + 1个结束符）
+// 提词器、电话本、备忘录：在ui_TeleprompTerContainer里分页显示的文档（doc_sources的序号）
+// 文件的映射、页索引和当前页都由LVGL线程的doc_pager管理，各文档各自记录翻到哪一页
+enum {
+    DOC_TELEPROMPTER,
+    DOC_PHONE,
+    DOC_MEMO,
+    DOC_COUNT
+};
 
 // 省电功能相关变量
 volatile bool display_power_save_mode = false;  // 省电模式标志
@@ -106,10 +118,15 @@ volatile time_t last_activity_time = 0;         // 最后活动时间
 volatile time_t power_save_start_time = 0;      // 省电模式开始时间
 #define POWER_SAVE_TIMEOUT 30                   // 30秒后进入省电模式
 
+// RGB图片转4bpp时的抖动方式（DISPLAY_DITHER=bayer|fs），默认直接截断
+static uint8_t rgb_dither_mode = PIX_DITHER_NONE;
+
 // 添加camera图像对象全局变量
 //static lv_obj_t *camera_img_obj = NULL;  // camera图像对象指针
 
 bool Not_Add_To_TextContainer = false;//一个标志位 防止有一些命令文本被加入到显示 
+static bool msg_refresh = false;  // 本条消息处理完后让LVGL线程累加文本并刷新（只在display_update_thread使用）
+static uint8_t Brightness_display = 30;  // 当前电流寄存器值（Bright++循环调节）
 
 //Ai、Brightness、Bright++、CamerA、
 
@@ -130,6 +147,7 @@ void bit4_to_rgb(uint8_t gray4, uint8_t* r, uint8_t* g, uint8_t* b);
 int save_4bit_to_bmp(const char* filename, uint8_t* image_data, uint16_t width, uint16_t height);
 int display_rgb_image(uint8_t* rgb_data, uint16_t width, uint16_t height);
 int display_image_fast(uint8_t* image_data, uint16_t width, uint16_t height);
+int display_camera_preview(const uint8_t* y_plane, uint16_t width, uint16_t height, uint32_t stride);
 void display_checkerboard_instant(uint16_t square_size);
 void display_gradient_instant(void);
 void display_circles_instant(void);
@@ -147,9 +165,22 @@ void demo_image_sequence(const char* directory);
 void free_image_sequence(char** filenames, int count);
 void cleanup(int signum);
 void* display_update_thread(void* arg);
+void* legacy_bridge_thread(void* arg);
 
 // SPI初始化（保持不变）
 int spi_init() {
+    // DISPLAY_TRANSPORT=sim 使用模拟面板（不访问spidev），DISPLAY_SIM_DUMP=目录 每次同步保存PGM
+    const char* transport = getenv("DISPLAY_TRANSPORT");
+#ifdef DISPLAY_HOST
+    transport = "sim";      // 主机构建没有spidev
+#endif
+    if (transport != NULL && strcmp(transport, "sim") == 0) {
+        spi_set_transport(&panel_sim_transport);
+        panel_sim_set_dump_dir(getenv("DISPLAY_SIM_DUMP"));
+        printf("使用模拟面板\n");
+        return 0;
+    }
+
     if ((spi_file = open(SPI_DEVICE_PATH, O_RDWR)) < 0) {
         perror("Failed to open SPI device");
         return -1;
@@ -183,24 +214,46 @@ int spi_init() {
         return -1;
     }
 
+    // bufsiz决定批量写缓存时单次ioctl能合并多少段，默认4096时退化为每段一次
+    printf("spidev bufsiz: %u\n", spi_get_bufsiz());
+
     return 0;
 }
 // 放在 src5/main.c 顶部的函数声明区或 display_update_thread 之前
-static inline void wake_display_and_touch_activity(void) {
+// 省电模式下把开显示指令加入批量，与后续寄存器设置一起发出
+static inline void wake_display_batch(panel_cmd_batch_t* batch) {
     if (display_power_save_mode) {
-        send_cmd(SPI_DISPLAY_ENABLE);
-        send_cmd(SPI_SYNC);
-        usleep(1 * 1000);
+        batch_cmd(batch, SPI_DISPLAY_ENABLE);
         display_power_save_mode = false;
     }
     last_activity_time = time(NULL);  // 统一更新最后活动时间
 }
 
+static inline void wake_display_and_touch_activity(void) {
+    panel_cmd_batch_t batch;
+
+    cmd_batch_init(&batch);
+    wake_display_batch(&batch);
+    if (batch.count > 0) {
+        cmd_batch_send(&batch, 1);  // 开显示+同步，一次ioctl
+    }
+}
+
+// 关闭显示+同步，一次ioctl
+static void display_disable(void) {
+    panel_cmd_batch_t batch;
+
+    cmd_batch_init(&batch);
+    batch_cmd(&batch, SPI_DISPLAY_DISABLE);
+    cmd_batch_send(&batch, 1);
+}
+
 // ================== IMU HUD 服务（仅在 IMUtest-ON 时读取并判断） ==================
-static pthread_t g_imu_hud_thread;
-static volatile bool g_imu_hud_thread_running = false;
-static volatile bool g_imu_hud_enabled = false;
-static volatile bool g_imu_hud_triggered = false;
+// 由主循环的reactor驱动：启用时timerfd每100ms触发一次读取，未启用时定时器停止，不再占用线程轮询
+#define IMU_HUD_PERIOD_MS 100
+
+static int g_imu_fd_ay = -1;
+static int g_imu_timer_fd = -1;
 
 static int read_sysfs_int_fd_simple(int fd, int *out) {
     char buf[64];
@@ -212,42 +265,52 @@ static int read_sysfs_int_fd_simple(int fd, int *out) {
     return 0;
 }
 
-static void* imu_hud_thread(void* arg) {
-    (void)arg;
-    int fd_ay = open(IMU_ACCEL_Y_PATH, O_RDONLY);
-    if (fd_ay < 0) {
-        perror("IMU HUD: open aY failed");
-        return NULL;
+// 抬头触发显示（在LVGL线程执行）
+static void imu_hud_trigger(void) {
+    wake_display_and_touch_activity();
+    if (ui_subMenu != NULL) {
+        lv_obj_clear_flag(ui_subMenu, LV_OBJ_FLAG_HIDDEN);
     }
-    while (g_imu_hud_thread_running) {
-        if (g_imu_hud_enabled) {
-            int ay = 0;
-            if (read_sysfs_int_fd_simple(fd_ay, &ay) == 0) {
-                if (ay < -7300) {
-                    g_imu_hud_triggered = true;
-                    printf("IMU HUD: ay > 7300\n");
-                }
-            }
-            usleep(100 * 1000); // 100ms 仅在启用时轮询
-            //printf("IMU HUD: %d\n", ay);
-        } else {
-            usleep(150 * 1000); // 未启用时降低占用
-        }
+    lv_label_set_text(ui_StatusLabel, "抬头触发");
+    printf("TAITOU");
+    lv_obj_invalidate(lv_scr_act());  // 关键修改： invalidate整个屏幕
+    lv_refr_now(lv_disp_get_default()); // 强制刷新
+}
+
+static void imu_hud_on_timer(int fd, void* arg) {
+    int ay = 0;
+
+    (void)arg;
+    reactor_timer_ack(fd);
+    if (read_sysfs_int_fd_simple(g_imu_fd_ay, &ay) == 0 && ay < -7300) {
+        printf("IMU HUD: ay > 7300\n");
+        imu_hud_trigger();
     }
-    close(fd_ay);
-    return NULL;
 }
 
+// display_update_thread调用：timerfd_settime本身线程安全
 static void imu_hud_set_enabled(bool enable) {
-    g_imu_hud_enabled = enable;
+    if (g_imu_timer_fd < 0) return;
+    if (enable) {
+        reactor_timer_arm_periodic(g_imu_timer_fd, IMU_HUD_PERIOD_MS);
+    } else {
+        reactor_timer_arm(g_imu_timer_fd, REACTOR_TIMER_OFF);
+    }
 }
 
+// 需在reactor_init之后调用
 static void imu_hud_init(void) {
-    if (g_imu_hud_thread_running) return;
-    g_imu_hud_thread_running = true;
-    if (pthread_create(&g_imu_hud_thread, NULL, imu_hud_thread, NULL) != 0) {
-        perror("IMU HUD: thread create failed");
-        g_imu_hud_thread_running = false;
+    if (g_imu_timer_fd >= 0) return;
+    g_imu_fd_ay = open(IMU_ACCEL_Y_PATH, O_RDONLY);
+    if (g_imu_fd_ay < 0) {
+        perror("IMU HUD: open aY failed");
+        return;
+    }
+    g_imu_timer_fd = reactor_timer_create();
+    if (g_imu_timer_fd < 0 || reactor_add(g_imu_timer_fd, imu_hud_on_timer, NULL) != 0) {
+        printf("IMU HUD: 定时器创建失败\n");
+        close(g_imu_fd_ay);
+        g_imu_fd_ay = -1;
     }
 }
 // ================== IMU HUD 服务结束 ==================
@@ -268,735 +331,656 @@ void update_battery_display(void) {
     printf("电池电量: %d%%\n", battery_capacity);
     
     // 先隐藏所有电池格子
-    if (ui_LineA != NULL) lv_obj_add_flag(ui_LineA, LV_OBJ_FLAG_HIDDEN);
-    if (ui_LineB != NULL) lv_obj_add_flag(ui_LineB, LV_OBJ_FLAG_HIDDEN);
-    if (ui_LineC != NULL) lv_obj_add_flag(ui_LineC, LV_OBJ_FLAG_HIDDEN);
-    if (ui_LineD != NULL) lv_obj_add_flag(ui_LineD, LV_OBJ_FLAG_HIDDEN);
+    ui_post_add_flag(&ui_LineA, LV_OBJ_FLAG_HIDDEN);
+    ui_post_add_flag(&ui_LineB, LV_OBJ_FLAG_HIDDEN);
+    ui_post_add_flag(&ui_LineC, LV_OBJ_FLAG_HIDDEN);
+    ui_post_add_flag(&ui_LineD, LV_OBJ_FLAG_HIDDEN);
     
     // 根据电量显示相应的格子
     if (battery_capacity > 80) {
         // >80%: 显示 A、B、C、D 全部
-        if (ui_LineA != NULL) lv_obj_clear_flag(ui_LineA, LV_OBJ_FLAG_HIDDEN);
-        if (ui_LineB != NULL) lv_obj_clear_flag(ui_LineB, LV_OBJ_FLAG_HIDDEN);
-        if (ui_LineC != NULL) lv_obj_clear_flag(ui_LineC, LV_OBJ_FLAG_HIDDEN);
-        if (ui_LineD != NULL) lv_obj_clear_flag(ui_LineD, LV_OBJ_FLAG_HIDDEN);
+        ui_post_clear_flag(&ui_LineA, LV_OBJ_FLAG_HIDDEN);
+        ui_post_clear_flag(&ui_LineB, LV_OBJ_FLAG_HIDDEN);
+        ui_post_clear_flag(&ui_LineC, LV_OBJ_FLAG_HIDDEN);
+        ui_post_clear_flag(&ui_LineD, LV_OBJ_FLAG_HIDDEN);
     } else if (battery_capacity > 60) {
         // >60%: 显示 B、C、D
-        if (ui_LineB != NULL) lv_obj_clear_flag(ui_LineB, LV_OBJ_FLAG_HIDDEN);
-        if (ui_LineC != NULL) lv_obj_clear_flag(ui_LineC, LV_OBJ_FLAG_HIDDEN);
-        if (ui_LineD != NULL) lv_obj_clear_flag(ui_LineD, LV_OBJ_FLAG_HIDDEN);
+        ui_post_clear_flag(&ui_LineB, LV_OBJ_FLAG_HIDDEN);
+        ui_post_clear_flag(&ui_LineC, LV_OBJ_FLAG_HIDDEN);
+        ui_post_clear_flag(&ui_LineD, LV_OBJ_FLAG_HIDDEN);
     } else if (battery_capacity > 40) {
         // >40%: 显示 C、D
-        if (ui_LineC != NULL) lv_obj_clear_flag(ui_LineC, LV_OBJ_FLAG_HIDDEN);
-        if (ui_LineD != NULL) lv_obj_clear_flag(ui_LineD, LV_OBJ_FLAG_HIDDEN);
+        ui_post_clear_flag(&ui_LineC, LV_OBJ_FLAG_HIDDEN);
+        ui_post_clear_flag(&ui_LineD, LV_OBJ_FLAG_HIDDEN);
     } else if (battery_capacity > 20) {
         // >20%: 显示 D
-        if (ui_LineD != NULL) lv_obj_clear_flag(ui_LineD, LV_OBJ_FLAG_HIDDEN);
+        ui_post_clear_flag(&ui_LineD, LV_OBJ_FLAG_HIDDEN);
     } else {
         // <=20%: 只显示 D（低电量警告）
-        if (ui_LineD != NULL) lv_obj_clear_flag(ui_LineD, LV_OBJ_FLAG_HIDDEN);
+        ui_post_clear_flag(&ui_LineD, LV_OBJ_FLAG_HIDDEN);
     }
 }
 // ================== 电池显示更新函数结束 ==================
 
-// 读取文件并显示到容器的通用函数
-static void read_and_display_file(const char* filepath, int* read_position, char* buffer, const char* error_msg) {
-    // 先清空控件之前的文本
-    if (ui_TeleprompTerTxT != NULL) {
-        lv_label_set_text(ui_TeleprompTerTxT, "");
+// 在提词器容器里显示文档的下一页（step>0）或上一页（step<0）
+// 打开、排版和翻页都在LVGL线程（ui_apply_page），这里只投递文档序号
+static void show_document(int doc, int step) {
+    Not_Add_To_TextContainer = false;
+    msg_refresh = true;
+    ui_post_add_flag(&ui_VideoContainer, LV_OBJ_FLAG_HIDDEN);
+    ui_post_page(doc, step);
+}
+
+// 命令处理函数：display_cmds.h 的命令表中每个命令对应一个，在display_update_thread中调用
+// 只通过ui_post_*投递UI修改，最后由display_update_thread统一投递消息文本
+
+// 导航相关命令（MeTeR、TurnLefT等）和"init"暂不处理
+static void cmd_ignore(const char* message) {
+}
+
+// 不在命令表里的文本：作为字幕显示
+static void cmd_text(const char* message) {
+    // 如果有新内容显示，重新开启显示并更新活动时间
+    wake_display_and_touch_activity();
+    Not_Add_To_TextContainer = true;
+    msg_refresh = true;  // 设置标志位，不直接操作UI
+    printf("Display updated to: %s\n", message);
+
+    // 显示普通文本内容时，确保文本容器可见并隐藏其它图标
+    ui_post_clear_flag(&ui_TextContainer, LV_OBJ_FLAG_HIDDEN);
+    ui_post_add_flag(&ui_TeleprompTerContainer, LV_OBJ_FLAG_HIDDEN);//设置提词器隐藏
+    ui_post_add_flag(&ui_subMenu, LV_OBJ_FLAG_HIDDEN);//设置子菜单隐藏
+    // 隐藏录像机容器（包含所有录像机组件）
+    ui_post_add_flag(&ui_VideoContainer, LV_OBJ_FLAG_HIDDEN);
+    //隐藏Menu3容器
+    ui_post_add_flag(&ui_Menu3, LV_OBJ_FLAG_HIDDEN);
+    // 隐藏这些元素
+    ui_post_add_flag(&ui_Menu1, LV_OBJ_FLAG_HIDDEN);
+    // 取消隐藏 ui_Label2（字幕日志总是显示最新的行，不需要滚动容器）
+    ui_post_clear_flag(&ui_Label2, LV_OBJ_FLAG_HIDDEN);
+}
+
+// 状态指令：映射成中文提示显示在状态栏，不放进 ui_Label2
+static void show_status(const char* message, const char* status) {
+    wake_display_and_touch_activity();
+    Not_Add_To_TextContainer = false;
+    msg_refresh = true;
+    printf("Display updated to: %s\n", message);
+    ui_post_set_text(&ui_StatusLabel, status);
+}
+
+static void cmd_finished(const char* message) {
+    show_status(message, "触摸镜腿 开始对话");
+}
+
+static void cmd_recording(const char* message) {
+    show_status(message, "录音中 松手发送");
+}
+
+static void cmd_upload(const char* message) {
+    show_status(message, "上传中");
+}
+
+static void cmd_processing(const char* message) {
+    show_status(message, "处理中");
+}
+
+// "GPIOA"：显示初始化完成；已初始化后再收到按普通文本处理
+static void cmd_gpioa(const char* message) {
+    if (display_inited) {
+        cmd_text(message);
+        return;
     }
+    display_inited = 1;
+    printf("Display updated to: Inited\n");
+}
+
+// "Bright++"
+static void cmd_bright_up(const char* message) {
+    // 亮度调节也视为活动，重新开启显示；开显示、电流寄存器和同步一次发出
+    panel_cmd_batch_t batch;
+    cmd_batch_init(&batch);
+    wake_display_batch(&batch);
+    Not_Add_To_TextContainer = false;
+    Brightness_display = Brightness_display+10;
+    if(Brightness_display > 63){Brightness_display = 0;}
+    batch_wr_cur_reg(&batch, Brightness_display);            //设置电流寄存器
+    cmd_batch_send(&batch, 1);              //同步设置
+    msg_refresh = true;  // 设置标志位，不直接操作UI
+    //strncpy(last_message, "clean", 12);//这里可以控制是否能重复修改亮度
+    //strncpy(message, "亮度修改", 12);
+    printf("Brigt++\n");
+}
+
+// 处理"CamerA"指令 - 居中显示camera图标
+static void cmd_camera(const char* message) {
+    // 如果有新内容显示，重新开启显示并更新活动时间
+    wake_display_and_touch_activity();
+    Not_Add_To_TextContainer = false;
+    msg_refresh = true;  // 设置标志位，隐藏微笑标签
+    ui_post_add_flag(&ui_Menu1, LV_OBJ_FLAG_HIDDEN);//隐藏菜单页
+    // 隐藏文本容器
+    ui_post_add_flag(&ui_TextContainer, LV_OBJ_FLAG_HIDDEN);
+    // 显示录像机容器（包含所有录像机图标）
+    ui_post_clear_flag(&ui_VideoContainer, LV_OBJ_FLAG_HIDDEN);
+    // 设置ui_VideoText透明度为20%
+    ui_post_set_text_opa(&ui_VideoText, LV_OPA_20);
+    // 恢复ui_CameraText正常透明度
+    ui_post_set_text_opa(&ui_CameraText, LV_OPA_COVER);
+    ui_post_set_text_opa(&ui_TeleprompterText, LV_OPA_20);
+    ui_post_add_flag(&ui_TeleprompTerContainer, LV_OBJ_FLAG_HIDDEN);//设置提词器隐藏
+}
+
+// 处理"Record"指令 - 显示录像机图标
+static void cmd_record(const char* message) {
+    // 如果有新内容显示，重新开启显示并更新活动时间
+    wake_display_and_touch_activity();
+    Not_Add_To_TextContainer = false;
+    msg_refresh = true;  //
+    ui_post_add_flag(&ui_Menu1, LV_OBJ_FLAG_HIDDEN);//隐藏菜单页
+    // 隐藏文本容器
+    ui_post_add_flag(&ui_TextContainer, LV_OBJ_FLAG_HIDDEN);
+    // 显示录像机容器（包含所有录像机图标）
+    ui_post_clear_flag(&ui_VideoContainer, LV_OBJ_FLAG_HIDDEN);
+    // 恢复ui_VideoText正常透明度
+    ui_post_set_text_opa(&ui_VideoText, LV_OPA_COVER);
+    // 设置ui_CameraText透明度为20%
+    ui_post_set_text_opa(&ui_CameraText, LV_OPA_20);
+    // 设置ui_TeleprompterText透明度为20%
+    ui_post_set_text_opa(&ui_TeleprompterText, LV_OPA_20);
+    ui_post_add_flag(&ui_TeleprompTerContainer, LV_OBJ_FLAG_HIDDEN);//设置提词器隐藏
+}
+
+// "AiTalk"：控制对话气泡显示
+static void cmd_ai_talk(const char* message) {
+    wake_display_and_touch_activity();
+    Not_Add_To_TextContainer = false;
+    ui_post_clear_flag(&ui_Menu1, LV_OBJ_FLAG_HIDDEN);
+    ui_post_add_flag(&ui_TextContainer, LV_OBJ_FLAG_HIDDEN);
+    msg_refresh = true;
+
+    // 显示AiTalk指示线
+    ui_post_clear_flag(&ui_AiTalkLine, LV_OBJ_FLAG_HIDDEN);
+    // 隐藏亮度指示线
+    ui_post_add_flag(&ui_BrightnessLine, LV_OBJ_FLAG_HIDDEN);
+    // 隐藏录像机容器
+    ui_post_add_flag(&ui_VideoContainer, LV_OBJ_FLAG_HIDDEN);
+    //显示状态信息和亮度
+    ui_post_add_flag(&ui_TeleprompTerContainer, LV_OBJ_FLAG_HIDDEN);//设置提词器隐藏
+    ui_post_add_flag(&ui_Menu3, LV_OBJ_FLAG_HIDDEN);//隐藏Menu3容器
+
+    // 更新电池显示
+    update_battery_display();
+}
+
+// "BLE DissCon"
+static void cmd_ble_disconnected(const char* message) {
+    wake_display_and_touch_activity();
+    Not_Add_To_TextContainer = false;
+    // BLE断开时显示斜线（表示断开状态）
+    ui_post_clear_flag(&ui_SlantedLine, LV_OBJ_FLAG_HIDDEN);
+    ui_post_clear_flag(&ui_Menu1, LV_OBJ_FLAG_HIDDEN);
+    ui_post_add_flag(&ui_TextContainer, LV_OBJ_FLAG_HIDDEN);
+    ui_post_clear_flag(&ui_Menu1, LV_OBJ_FLAG_HIDDEN);
+    ui_post_add_flag(&ui_TextContainer, LV_OBJ_FLAG_HIDDEN);
+    msg_refresh = true;
+    system("hciconfig hci0 leadv");//蓝牙重启逻辑先放在这里了
+    system("btgatt-server &");
+}
+
+// "Phone ConnecTed"
+static void cmd_phone_connected(const char* message) {
+    wake_display_and_touch_activity();
+    Not_Add_To_TextContainer = false;
+    // 手机连接时隐藏斜线（表示连接状态）
+    ui_post_add_flag(&ui_SlantedLine, LV_OBJ_FLAG_HIDDEN);
+    ui_post_clear_flag(&ui_Menu1, LV_OBJ_FLAG_HIDDEN);
+    ui_post_add_flag(&ui_TextContainer, LV_OBJ_FLAG_HIDDEN);
+    ui_post_clear_flag(&ui_Menu1, LV_OBJ_FLAG_HIDDEN);
+    ui_post_add_flag(&ui_TextContainer, LV_OBJ_FLAG_HIDDEN);
+    msg_refresh = true;
+}
+
+// "RecorDeR"：录音
+static void cmd_recorder(const char* message) {
+    wake_display_and_touch_activity();
+    Not_Add_To_TextContainer = false;
+    ui_post_add_flag(&ui_VideoContainer, LV_OBJ_FLAG_HIDDEN);
+    ui_post_clear_flag(&ui_Menu3, LV_OBJ_FLAG_HIDDEN);
+    ui_post_add_flag(&ui_TextContainer, LV_OBJ_FLAG_HIDDEN);
+    ui_post_add_flag(&ui_Menu1, LV_OBJ_FLAG_HIDDEN); // 新增，避免层叠干扰
+    ui_post_add_flag(&ui_TextContainer, LV_OBJ_FLAG_HIDDEN);
+    msg_refresh = true;
+
+    // 调整文字标签位置：RecorDeR收到后变成227，另外两个变成239
+    ui_post_set_pos(&ui_RecordText, 60-10, 227);
+    ui_post_set_pos(&ui_MemoText, 508-32, 239);
+    ui_post_set_pos(&ui_MoreText, 280-10, 239);
+    ui_post_add_flag(&ui_TeleprompTerContainer, LV_OBJ_FLAG_HIDDEN);//设置提词器隐藏
+}
+
+// "Brightness"
+static void cmd_brightness(const char* message) {
+    wake_display_and_touch_activity();
+    Not_Add_To_TextContainer = false;
+    ui_post_clear_flag(&ui_Menu1, LV_OBJ_FLAG_HIDDEN);
+    ui_post_add_flag(&ui_TextContainer, LV_OBJ_FLAG_HIDDEN);
+    msg_refresh = true;
+
+    // 显示亮度指示线
+    ui_post_clear_flag(&ui_BrightnessLine, LV_OBJ_FLAG_HIDDEN);
+    // 隐藏AiTalk指示线
+    ui_post_add_flag(&ui_AiTalkLine, LV_OBJ_FLAG_HIDDEN);
+    // 隐藏录像机容器
+    ui_post_add_flag(&ui_VideoContainer, LV_OBJ_FLAG_HIDDEN);
+    ui_post_set_text(&ui_StatusLabel, "  ");
+}
+
+// "BLE:AlbumSync"
+static void cmd_album_sync(const char* message) {
+    wake_display_and_touch_activity();
+    Not_Add_To_TextContainer = false;
+    system("ai_media_service &");
+    ui_post_add_flag(&ui_TeleprompTerContainer, LV_OBJ_FLAG_HIDDEN);//设置提词器隐藏
+}
+
+// "Finish-Photo"
+static void cmd_photo_finished(const char* message) {
+    wake_display_and_touch_activity();
+    Not_Add_To_TextContainer = false;
+    msg_refresh = true;
+    ui_post_set_text(&ui_CameraText, "保存");
+}
+
+// "RecorDeRworking"
+static void cmd_recorder_working(const char* message) {
+    wake_display_and_touch_activity();
+    Not_Add_To_TextContainer = false;
+    msg_refresh = true;
+    ui_post_set_text(&ui_RecordText, "录音中");
+}
+
+// "RecorDeR-End"
+static void cmd_recorder_end(const char* message) {
+    wake_display_and_touch_activity();
+    Not_Add_To_TextContainer = false;
+    msg_refresh = true;
+    ui_post_set_text(&ui_RecordText, "录音");
+}
+
+// "TranslatE-ON"：位置
+static void cmd_translate_on(const char* message) {
+    wake_display_and_touch_activity();
+    Not_Add_To_TextContainer = false;
+    msg_refresh = true;
+    //lv_label_set_text(ui_StatusLabel, "请打开手机APP");
+
+    // 向上移动ui_subMenu 50个像素点
+    ui_post_move(&ui_subMenu, 0, -50);
+}
+
+// "NavigaT-ON"：电话
+static void cmd_navigate_on(const char* message) {
+    wake_display_and_touch_activity();
+    Not_Add_To_TextContainer = false;
+    msg_refresh = true;
+    //需要打开电话簿
+    ui_post_set_text(&ui_StatusLabel, " ");
+    ui_post_add_flag(&ui_subMenu, LV_OBJ_FLAG_HIDDEN);
+    ui_post_add_flag(&ui_Menu3, LV_OBJ_FLAG_HIDDEN);
+    show_document(DOC_PHONE, 1);
+}
+
+// "IMUtest-ON"：姿态
+static void cmd_imu_test_on(const char* message) {
+    wake_display_and_touch_activity();
+    Not_Add_To_TextContainer = false;
+    msg_refresh = true;
+    // 进入IMU HUD模式：隐藏子菜单，仅在本模式下轮询aZ
+    ui_post_add_flag(&ui_subMenu, LV_OBJ_FLAG_HIDDEN);
+    imu_hud_set_enabled(true);
+}
+
+// "TelePrompTer"
+static void cmd_teleprompter(const char* message) {
+    wake_display_and_touch_activity();
+    Not_Add_To_TextContainer = false;
+    msg_refresh = true;  // 设置标志位，隐藏微笑标签
+    ui_post_add_flag(&ui_Menu1, LV_OBJ_FLAG_HIDDEN);//隐藏菜单页
+    // 恢复ui_VideoText正常透明度
+    ui_post_set_text_opa(&ui_TeleprompterText, LV_OPA_COVER);
+    ui_post_set_text_opa(&ui_VideoText, LV_OPA_20);//设置录像机透明度
+    // 设置ui_CameraText透明度为20%
+    ui_post_set_text_opa(&ui_CameraText, LV_OPA_20);
+}
+
+// "TelePrompTerNextParagraph"：提词器下一页
+static void cmd_teleprompter_next(const char* message) {
+    wake_display_and_touch_activity();
+    show_document(DOC_TELEPROMPTER, 1);
+}
+
+// "TelePrompTerPrevParagraph"：提词器上一页
+static void cmd_teleprompter_prev(const char* message) {
+    wake_display_and_touch_activity();
+    show_document(DOC_TELEPROMPTER, -1);
+}
+
+// "TelePrompTerScroll"：提词器从当前页开始自动滚动，再发一次停止
+static void cmd_teleprompter_scroll(const char* message) {
+    wake_display_and_touch_activity();
+    Not_Add_To_TextContainer = false;
+    msg_refresh = true;
+    ui_post_add_flag(&ui_VideoContainer, LV_OBJ_FLAG_HIDDEN);
+    ui_post_auto_scroll(DOC_TELEPROMPTER);
+}
+
+// "FFmFinished"
+static void cmd_ffm_finished(const char* message) {
+    wake_display_and_touch_activity();
+    Not_Add_To_TextContainer = false;
+    msg_refresh = true;
+    ui_post_set_text(&ui_CameraText, "拍照");
+}
+
+// "VideoRecing"
+static void cmd_video_recording(const char* message) {
+    wake_display_and_touch_activity();
+    Not_Add_To_TextContainer = false;
+    msg_refresh = true;
+    ui_post_clear_flag(&ui_VideoRecordingContainer, LV_OBJ_FLAG_HIDDEN);
+    ui_post_add_flag(&ui_VideoContainer, LV_OBJ_FLAG_HIDDEN);
+}
+
+// "Finish-Video"
+static void cmd_video_finished(const char* message) {
+    wake_display_and_touch_activity();
+    Not_Add_To_TextContainer = false;
+    msg_refresh = true;
+    ui_post_add_flag(&ui_VideoRecordingContainer, LV_OBJ_FLAG_HIDDEN);
+    ui_post_clear_flag(&ui_VideoContainer, LV_OBJ_FLAG_HIDDEN);
+}
+
+// "MeMo"：备忘录被选定
+static void cmd_memo(const char* message) {
+    wake_display_and_touch_activity();
+    Not_Add_To_TextContainer = false;
+    msg_refresh = true;
+
+    // 隐藏ui_Label2
+    ui_post_add_flag(&ui_Label2, LV_OBJ_FLAG_HIDDEN);
+    ui_post_add_flag(&ui_subMenu, LV_OBJ_FLAG_HIDDEN);
+    // 调整文字标签位置：MeMo收到后变成227，另外两个变成239
+    ui_post_set_pos(&ui_MemoText, 508-32, 227);
+    ui_post_set_pos(&ui_RecordText, 60-10, 239);
+    ui_post_set_pos(&ui_MoreText, 280-10, 239);
+}
+
+// "MeMoDisplay"：备忘录显示出来
+static void cmd_memo_display(const char* message) {
+    wake_display_and_touch_activity();
+    Not_Add_To_TextContainer = false;
+    msg_refresh = true;
+
+    // 隐藏ui_Label2
+    ui_post_add_flag(&ui_Label2, LV_OBJ_FLAG_HIDDEN);
+    ui_post_add_flag(&ui_Menu3, LV_OBJ_FLAG_HIDDEN);
+    show_document(DOC_MEMO, 1);
+}
+
+// "MoRe"：子菜单被选定
+static void cmd_more(const char* message) {
+    wake_display_and_touch_activity();
+    Not_Add_To_TextContainer = false;
+    msg_refresh = true;
+
+    // 隐藏ui_Label2
+    ui_post_add_flag(&ui_Label2, LV_OBJ_FLAG_HIDDEN);
+
+    // 调整文字标签位置：MoRe收到后变成227，另外两个变成239
+    ui_post_set_pos(&ui_MoreText, 280-10, 227);
+    ui_post_set_pos(&ui_MemoText, 508-32, 239);
+    ui_post_set_pos(&ui_RecordText, 60-10, 239);
+}
+
+// subMenu相关命令处理
+// "TranslatE"：翻译被选定
+static void cmd_translate(const char* message) {
+    wake_display_and_touch_activity();
+    Not_Add_To_TextContainer = false;
+    msg_refresh = true;
+
+    // 隐藏ui_Label2和ui_Menu3
+    ui_post_add_flag(&ui_Label2, LV_OBJ_FLAG_HIDDEN);
+    ui_post_add_flag(&ui_Menu3, LV_OBJ_FLAG_HIDDEN);
+    // 显示ui_subMenu
+    ui_post_clear_flag(&ui_subMenu, LV_OBJ_FLAG_HIDDEN);
+
+    // 调整ui_SubMenu_Rect位置：X=69, Y=289
+    ui_post_set_pos(&ui_SubMenu_Rect, 69, 289);
+}
+
+// "NavigaT"：导航被选定
+static void cmd_navigate(const char* message) {
+    wake_display_and_touch_activity();
+    Not_Add_To_TextContainer = false;
+    msg_refresh = true;
+
+    // 隐藏ui_Label2和ui_Menu3
+    ui_post_add_flag(&ui_Label2, LV_OBJ_FLAG_HIDDEN);
+    ui_post_add_flag(&ui_Menu3, LV_OBJ_FLAG_HIDDEN);
+    // 显示ui_subMenu
+    ui_post_clear_flag(&ui_subMenu, LV_OBJ_FLAG_HIDDEN);
+
+    // 调整ui_SubMenu_Rect位置：X=269, Y=289
+    ui_post_set_pos(&ui_SubMenu_Rect, 269, 289);
+}
+
+// "DisplayPhoto"：显示图被选定
+static void cmd_display_photo(const char* message) {
+    wake_display_and_touch_activity();
+    Not_Add_To_TextContainer = false;
+    msg_refresh = true;
+
+    // 隐藏ui_Label2和ui_Menu3
+    ui_post_add_flag(&ui_Label2, LV_OBJ_FLAG_HIDDEN);
+    ui_post_add_flag(&ui_Menu3, LV_OBJ_FLAG_HIDDEN);
+    // 显示ui_subMenu
+    ui_post_clear_flag(&ui_subMenu, LV_OBJ_FLAG_HIDDEN);
+
+    // 调整ui_SubMenu_Rect位置：X=471, Y=289
+    ui_post_set_pos(&ui_SubMenu_Rect, 471, 289);
+}
+
+// "DisplayPhoto-ON"：显示图被选定
+static void cmd_display_photo_on(const char* message) {
+    wake_display_and_touch_activity();
+    Not_Add_To_TextContainer = false;
+    msg_refresh = true;
+
+    // 隐藏ui_Label2和ui_Menu3
+    ui_post_add_flag(&ui_subMenu, LV_OBJ_FLAG_HIDDEN);
+    load_and_display_image(NULL);//显示图片
+}
+
+// "FontSize-ON"：大小字
+static void cmd_font_size_on(const char* message) {
+    wake_display_and_touch_activity();
+    Not_Add_To_TextContainer = false;
+    msg_refresh = true;
+
+    // 将所有SubMenu标签的字体改为ui_font_alibaba_30
+    ui_post_set_text_font(&ui_SubMenu_Translate, &ui_font_alibaba_30);
+    ui_post_set_text_font(&ui_SubMenu_Navigation, &ui_font_alibaba_30);
+    ui_post_set_text_font(&ui_SubMenu_DisplayImage, &ui_font_alibaba_30);
+    ui_post_set_text_font(&ui_SubMenu_ASR, &ui_font_alibaba_30);
+    ui_post_set_text_font(&ui_SubMenu_Sleep, &ui_font_alibaba_30);
+    ui_post_set_text_font(&ui_SubMenu_Personalize, &ui_font_alibaba_30);
+    ui_post_set_text_font(&ui_SubMenu_Attitude, &ui_font_alibaba_30);
+    ui_post_set_text_font(&ui_SubMenu_Exit, &ui_font_alibaba_30);
+
+    // 强制刷新屏幕，让用户看得到效果
+    ui_post_refresh();
+}
+
+// "bd_ASR"：ASR被选定
+static void cmd_asr(const char* message) {
+    wake_display_and_touch_activity();
+    Not_Add_To_TextContainer = false;
+    msg_refresh = true;
+
+    // 隐藏ui_Label2和ui_Menu3
+    ui_post_add_flag(&ui_Label2, LV_OBJ_FLAG_HIDDEN);
+    ui_post_add_flag(&ui_Menu3, LV_OBJ_FLAG_HIDDEN);
+    // 显示ui_subMenu
+    ui_post_clear_flag(&ui_subMenu, LV_OBJ_FLAG_HIDDEN);
+
+    ui_post_set_pos(&ui_SubMenu_Rect, 69, 174);
+}
+
+// "SleeP"：休眠被选定
+static void cmd_sleep(const char* message) {
+    wake_display_and_touch_activity();
+    Not_Add_To_TextContainer = false;
+    msg_refresh = true;
+
+    // 调整ui_SubMenu_Rect位置：X轴变为269，Y轴不变
+    ui_post_set_pos(&ui_SubMenu_Rect, 269, 174);
+
+    ui_post_set_text(&ui_StatusLabel, "  ");//清空上一个
+
+    // 隐藏ui_Label2和ui_Menu3
+    ui_post_add_flag(&ui_Label2, LV_OBJ_FLAG_HIDDEN);
+    ui_post_add_flag(&ui_Menu3, LV_OBJ_FLAG_HIDDEN);
+    // 显示ui_subMenu
+    ui_post_clear_flag(&ui_subMenu, LV_OBJ_FLAG_HIDDEN);
+}
+
+// "FontSize"：个性化被选定
+static void cmd_font_size(const char* message) {
+    wake_display_and_touch_activity();
+    Not_Add_To_TextContainer = false;
+    msg_refresh = true;
+
+    // 隐藏ui_Label2和ui_Menu3
+    ui_post_add_flag(&ui_Label2, LV_OBJ_FLAG_HIDDEN);
+    ui_post_add_flag(&ui_Menu3, LV_OBJ_FLAG_HIDDEN);
+    // 显示ui_subMenu
+    ui_post_clear_flag(&ui_subMenu, LV_OBJ_FLAG_HIDDEN);
+
+    // 调整ui_SubMenu_Rect位置：Y轴变为471，X轴保持不变
+    ui_post_set_pos(&ui_SubMenu_Rect, 471, 174);
+}
+
+// "QuiT"：退出子菜单
+static void cmd_quit(const char* message) {
+    wake_display_and_touch_activity();
+    Not_Add_To_TextContainer = false;
+    msg_refresh = true;
+
+
+
+    // 调整ui_SubMenu_Rect位置：X=269, Y=410
+    ui_post_set_pos(&ui_SubMenu_Rect, 269, 410-100+48+48);
+}
+
+// "QuiTed"：退出子菜单
+static void cmd_quited(const char* message) {
+    wake_display_and_touch_activity();
+    Not_Add_To_TextContainer = false;
+    msg_refresh = true;
+
+    // 隐藏ui_subMenu
+    ui_post_add_flag(&ui_subMenu, LV_OBJ_FLAG_HIDDEN);
+}
+
+// "IntoSleep"：关闭屏幕
+static void cmd_into_sleep(const char* message) {
+    display_disable();
+}
+
+// "IMUtest"：IMU测试被选定
+static void cmd_imu_test(const char* message) {
+    wake_display_and_touch_activity();
+    Not_Add_To_TextContainer = false;
+    msg_refresh = true;
+
+    // 隐藏ui_Label2和ui_Menu3
+    ui_post_add_flag(&ui_Label2, LV_OBJ_FLAG_HIDDEN);
+    ui_post_add_flag(&ui_Menu3, LV_OBJ_FLAG_HIDDEN);
+    // 显示ui_subMenu
+    ui_post_clear_flag(&ui_subMenu, LV_OBJ_FLAG_HIDDEN);
+
+    // 调整ui_SubMenu_Rect位置：X=69, Y=410
+    ui_post_set_pos(&ui_SubMenu_Rect, 69, 410);
+}
+
+typedef void (*display_cmd_handler_t)(const char* message);
+
+#define DISPLAY_CMD_HANDLER(id, handler, text) [id] = handler,
+static const display_cmd_handler_t cmd_handlers[DISPLAY_CMD_COUNT] = {
+    DISPLAY_CMD_LIST(DISPLAY_CMD_HANDLER)
+    DISPLAY_CMD_PREFIX_LIST(DISPLAY_CMD_HANDLER)
+};
+#undef DISPLAY_CMD_HANDLER
+
+// 显示更新线程：从消息总线接收文本命令
+void* display_update_thread(void* arg) {
+    char message[BUFFER_SIZE];
+    msg_bus_msg_t msg;
     
-    FILE *file = fopen(filepath, "r");
-    if (file != NULL) {
-        // 跳过已读的字符
-        Not_Add_To_TextContainer = false;
-        hide_smile_flag = true;
-        fseek(file, *read_position, SEEK_SET);
-        if (ui_VideoContainer) lv_obj_add_flag(ui_VideoContainer, LV_OBJ_FLAG_HIDDEN);
-        
-        // 读取100个汉字（300个字节，因为UTF-8编码下1个汉字占3个字节）
-        size_t bytes_read = fread(buffer, 1, 300, file);
-        buffer[bytes_read] = '\0';  // 确保字符串结束
-        
-        // 检查是否到达文件末尾
-        if (bytes_read < 300) {
-            // 文件读取完毕，重置读取位置到开头
-            *read_position = 0;
-        } else {
-            // 更新读取位置
-            *read_position += bytes_read;
+    while (running) {
+        // 等待总线上的下一条消息（每条都会收到，不会被后一条覆盖）
+        if (msg_bus_recv(&display_bus, &msg, -1) < 0) {
+            break;
         }
-        
-        fclose(file);
-        
-        // 显示读取的文本
-        if (ui_TeleprompTerTxT != NULL) {
-            lv_label_set_text(ui_TeleprompTerTxT, buffer);
+        if (msg.lost > 0) {
+            printf("display: 落后过多，丢失 %u 条消息\n", msg.lost);
         }
-        printf("\n\nbuffer: %s\n\n", buffer);
-        // 显示容器
-        if (ui_TeleprompTerContainer != NULL) {
-            lv_obj_clear_flag(ui_TeleprompTerContainer, LV_OBJ_FLAG_HIDDEN);
+        if (msg.type != MSG_TYPE_TEXT && msg.type != MSG_TYPE_TEXT_CONT) {
+            continue;
         }
-    } else {
-        // 文件打开失败，显示错误信息
-        if (ui_TeleprompTerTxT != NULL) {
-            lv_label_set_text(ui_TeleprompTerTxT, error_msg);
+        memcpy(message, msg.payload, msg.len);
+        message[msg.len < BUFFER_SIZE ? msg.len : BUFFER_SIZE - 1] = '\0';
+        
+        // 默认关闭IMU HUD，仅当收到 IMUtest-ON 时开启
+        imu_hud_set_enabled(false);
+
+        // 查命令表（完美哈希，一次比较），不是命令的文本按字幕显示
+        // 流式字幕的后续片段不查命令表（逐词输出的片段可能恰好是命令字）
+        int cmd = msg.type == MSG_TYPE_TEXT ? display_cmd_lookup(message) : -1;
+        if (cmd >= 0) {
+            cmd_handlers[cmd](message);
+        } else {
+            cmd_text(message);
         }
-        if (ui_TeleprompTerContainer != NULL) {
-            lv_obj_clear_flag(ui_TeleprompTerContainer, LV_OBJ_FLAG_HIDDEN);
+
+        // 消息连同是否累加一起拷贝进队列，LVGL线程不再读共享内存
+        if (msg_refresh) {
+            ui_post_message(message, BUFFER_SIZE - 1, Not_Add_To_TextContainer, msg.type == MSG_TYPE_TEXT_CONT);
+            msg_refresh = false;
         }
+        ui_queue_wake();
     }
+    
+    return NULL;
 }
 
-// 显示更新线程：监听共享内存变化
-void* display_update_thread(void* arg) {
-    //char last_message[BUFFER_SIZE] = {0};
-    uint8_t Brightness_display = 30;
-    
+// 旧协议桥接：还在写 /display_shm + sem_post 的程序（btgatt-server、ai-core）
+// 每次写入都转成一条MSG_TYPE_TEXT发布到总线
+void* legacy_bridge_thread(void* arg) {
+    char text[BUFFER_SIZE];
+
     while (running) {
-        // 等待信号量（有新消息）
         if (sem_wait(semaphore) == -1) {
             if (errno == EINTR) continue;  // 处理中断信号
             perror("sem_wait failed");
             break;
         }
-        
-        // 检查是否有新消息
-        //if (strcmp(shared_memory, last_message) != 0) {
-            //strncpy(last_message, shared_memory, BUFFER_SIZE - 1);
-            // 默认关闭IMU HUD，仅当收到 IMUtest-ON 时开启
-            imu_hud_set_enabled(false);
-            
-            // 处理"init"指令
-            if (strcmp(shared_memory, "GPIOA") == 0 && !display_inited) {
-                display_inited = 1;
-                printf("Display updated to: Inited\n");
-            } 
-            else if (strcmp(shared_memory, "Bright++") == 0) {
-                // 亮度调节也视为活动，重新开启显示
-                wake_display_and_touch_activity();
-                Not_Add_To_TextContainer = false;
-                Brightness_display = Brightness_display+10;
-                if(Brightness_display > 63){Brightness_display = 0;}
-                wr_cur_reg(Brightness_display);                          //设置电流寄存器
-                send_cmd(SPI_SYNC);                     //同步设置
-                hide_smile_flag = true;  // 设置标志位，不直接操作UI
-                //strncpy(last_message, "clean", 12);//这里可以控制是否能重复修改亮度
-                //strncpy(shared_memory, "亮度修改", 12);
-                printf("Brigt++\n");
-            }
-            // 处理"CamerA"指令 - 居中显示camera图标
-            else if (strcmp(shared_memory, "CamerA") == 0) {
-                // 如果有新内容显示，重新开启显示并更新活动时间
-                wake_display_and_touch_activity();
-                Not_Add_To_TextContainer = false;
-                hide_smile_flag = true;  // 设置标志位，隐藏微笑标签
-                lv_obj_add_flag(ui_Menu1, LV_OBJ_FLAG_HIDDEN);//隐藏菜单页
-                // 隐藏文本容器
-                if (ui_TextContainer) lv_obj_add_flag(ui_TextContainer, LV_OBJ_FLAG_HIDDEN);
-                // 显示录像机容器（包含所有录像机图标）
-                if (ui_VideoContainer != NULL) {
-                    lv_obj_clear_flag(ui_VideoContainer, LV_OBJ_FLAG_HIDDEN);
-                }
-                // 设置ui_VideoText透明度为20%
-                if (ui_VideoText != NULL) {
-                    lv_obj_set_style_text_opa(ui_VideoText, LV_OPA_20, LV_PART_MAIN | LV_STATE_DEFAULT);
-                }
-                // 恢复ui_CameraText正常透明度
-                if (ui_CameraText != NULL) {
-                    lv_obj_set_style_text_opa(ui_CameraText, LV_OPA_COVER, LV_PART_MAIN | LV_STATE_DEFAULT);
-                }
-                if (ui_TeleprompterText != NULL) {
-                    lv_obj_set_style_text_opa(ui_TeleprompterText, LV_OPA_20, LV_PART_MAIN | LV_STATE_DEFAULT);
-                }
-                lv_obj_add_flag(ui_TeleprompTerContainer, LV_OBJ_FLAG_HIDDEN);//设置提词器隐藏
-            }
-            // 处理"Record"指令 - 显示录像机图标
-            else if (strcmp(shared_memory, "Record") == 0) {
-                // 如果有新内容显示，重新开启显示并更新活动时间
-                wake_display_and_touch_activity();
-                Not_Add_To_TextContainer = false;
-                hide_smile_flag = true;  //
-                lv_obj_add_flag(ui_Menu1, LV_OBJ_FLAG_HIDDEN);//隐藏菜单页
-                // 隐藏文本容器
-                if (ui_TextContainer) lv_obj_add_flag(ui_TextContainer, LV_OBJ_FLAG_HIDDEN);
-                // 显示录像机容器（包含所有录像机图标）
-                if (ui_VideoContainer != NULL) {
-                    lv_obj_clear_flag(ui_VideoContainer, LV_OBJ_FLAG_HIDDEN);
-                }
-                // 恢复ui_VideoText正常透明度
-                if (ui_VideoText != NULL) {
-                    lv_obj_set_style_text_opa(ui_VideoText, LV_OPA_COVER, LV_PART_MAIN | LV_STATE_DEFAULT);
-                }
-                // 设置ui_CameraText透明度为20%
-                if (ui_CameraText != NULL) {
-                    lv_obj_set_style_text_opa(ui_CameraText, LV_OPA_20, LV_PART_MAIN | LV_STATE_DEFAULT);
-                }
-                // 设置ui_TeleprompterText透明度为20%
-                if (ui_TeleprompterText != NULL) {
-                    lv_obj_set_style_text_opa(ui_TeleprompterText, LV_OPA_20, LV_PART_MAIN | LV_STATE_DEFAULT);
-                }
-                lv_obj_add_flag(ui_TeleprompTerContainer, LV_OBJ_FLAG_HIDDEN);//设置提词器隐藏
-            }
-            // 检测是否包含"Ai"字符串，控制对话气泡显示
-            else if (strcmp(shared_memory, "AiTalk") == 0) {
-                wake_display_and_touch_activity();
-                Not_Add_To_TextContainer = false;
-                if (ui_Menu1) lv_obj_clear_flag(ui_Menu1, LV_OBJ_FLAG_HIDDEN);
-                lv_obj_add_flag(ui_TextContainer, LV_OBJ_FLAG_HIDDEN);
-                hide_smile_flag = true;
-                
-                // 显示AiTalk指示线
-                if (ui_AiTalkLine) lv_obj_clear_flag(ui_AiTalkLine, LV_OBJ_FLAG_HIDDEN);
-                // 隐藏亮度指示线
-                if (ui_BrightnessLine) lv_obj_add_flag(ui_BrightnessLine, LV_OBJ_FLAG_HIDDEN);
-                // 隐藏录像机容器
-                if (ui_VideoContainer) lv_obj_add_flag(ui_VideoContainer, LV_OBJ_FLAG_HIDDEN);
-                //显示状态信息和亮度
-                lv_obj_add_flag(ui_TeleprompTerContainer, LV_OBJ_FLAG_HIDDEN);//设置提词器隐藏
-                lv_obj_add_flag(ui_Menu3, LV_OBJ_FLAG_HIDDEN);//隐藏Menu3容器
-                
-                // 更新电池显示
-                update_battery_display();
-            }
-            else if (strcmp(shared_memory, "BLE DissCon") == 0){
-                wake_display_and_touch_activity();
-                Not_Add_To_TextContainer = false;
-                // BLE断开时显示斜线（表示断开状态）
-                if (ui_SlantedLine) lv_obj_clear_flag(ui_SlantedLine, LV_OBJ_FLAG_HIDDEN);
-                if (ui_Menu1) lv_obj_clear_flag(ui_Menu1, LV_OBJ_FLAG_HIDDEN);
-                lv_obj_add_flag(ui_TextContainer, LV_OBJ_FLAG_HIDDEN);
-                if (ui_Menu1) lv_obj_clear_flag(ui_Menu1, LV_OBJ_FLAG_HIDDEN);
-                lv_obj_add_flag(ui_TextContainer, LV_OBJ_FLAG_HIDDEN);
-                hide_smile_flag = true;
-                system("hciconfig hci0 leadv");//蓝牙重启逻辑先放在这里了
-                system("btgatt-server &");
-            }
-            else if (strcmp(shared_memory, "Phone ConnecTed") == 0){
-                wake_display_and_touch_activity();
-                Not_Add_To_TextContainer = false;
-                // 手机连接时隐藏斜线（表示连接状态）
-                if (ui_SlantedLine) lv_obj_add_flag(ui_SlantedLine, LV_OBJ_FLAG_HIDDEN);
-                if (ui_Menu1) lv_obj_clear_flag(ui_Menu1, LV_OBJ_FLAG_HIDDEN);
-                lv_obj_add_flag(ui_TextContainer, LV_OBJ_FLAG_HIDDEN);
-                if (ui_Menu1) lv_obj_clear_flag(ui_Menu1, LV_OBJ_FLAG_HIDDEN);
-                lv_obj_add_flag(ui_TextContainer, LV_OBJ_FLAG_HIDDEN);
-                hide_smile_flag = true;
-            }
-            else if (strcmp(shared_memory, "RecorDeR") == 0){//录音
-                wake_display_and_touch_activity();
-                Not_Add_To_TextContainer = false;
-                if (ui_VideoContainer) lv_obj_add_flag(ui_VideoContainer, LV_OBJ_FLAG_HIDDEN);
-                if (ui_Menu3) lv_obj_clear_flag(ui_Menu3, LV_OBJ_FLAG_HIDDEN);
-                if (ui_TextContainer) lv_obj_add_flag(ui_TextContainer, LV_OBJ_FLAG_HIDDEN);
-                if (ui_Menu1) lv_obj_add_flag(ui_Menu1, LV_OBJ_FLAG_HIDDEN); // 新增，避免层叠干扰
-                lv_obj_add_flag(ui_TextContainer, LV_OBJ_FLAG_HIDDEN);
-                hide_smile_flag = true;
-                
-                // 调整文字标签位置：RecorDeR收到后变成227，另外两个变成239
-                if (ui_RecordText != NULL) {
-                    lv_obj_set_pos(ui_RecordText, 60-10, 227);
-                }
-                if (ui_MemoText != NULL) {
-                    lv_obj_set_pos(ui_MemoText, 508-32, 239);
-                }
-                if (ui_MoreText != NULL) {
-                    lv_obj_set_pos(ui_MoreText, 280-10, 239);
-                }
-                lv_obj_add_flag(ui_TeleprompTerContainer, LV_OBJ_FLAG_HIDDEN);//设置提词器隐藏
-            }
-            //还要新增图片显示、议程、大小字个性化设置
-            
-            else if (strcmp(shared_memory, "Brightness") == 0) {
-                wake_display_and_touch_activity();
-                Not_Add_To_TextContainer = false;
-                if (ui_Menu1) lv_obj_clear_flag(ui_Menu1, LV_OBJ_FLAG_HIDDEN);
-                lv_obj_add_flag(ui_TextContainer, LV_OBJ_FLAG_HIDDEN);
-                hide_smile_flag = true;
-                
-                // 显示亮度指示线
-                if (ui_BrightnessLine) lv_obj_clear_flag(ui_BrightnessLine, LV_OBJ_FLAG_HIDDEN);
-                // 隐藏AiTalk指示线
-                if (ui_AiTalkLine) lv_obj_add_flag(ui_AiTalkLine, LV_OBJ_FLAG_HIDDEN);
-                // 隐藏录像机容器
-                if (ui_VideoContainer) lv_obj_add_flag(ui_VideoContainer, LV_OBJ_FLAG_HIDDEN);
-                lv_label_set_text(ui_StatusLabel,"  ");
-            }
-            else if (strcmp(shared_memory, "BLE:AlbumSync") == 0) {
-                wake_display_and_touch_activity();
-                Not_Add_To_TextContainer = false;
-                system("ai_media_service &");
-                lv_obj_add_flag(ui_TeleprompTerContainer, LV_OBJ_FLAG_HIDDEN);//设置提词器隐藏
-            }
-            else if (strcmp(shared_memory, "Finish-Photo") == 0) {
-                wake_display_and_touch_activity();
-                Not_Add_To_TextContainer = false;
-                hide_smile_flag = true;
-                //if (ui_CameraText) {
-                    lv_label_set_text(ui_CameraText, "保存");
-                //}
-            }    
-            else if (strcmp(shared_memory, "RecorDeRworking") == 0) {
-                wake_display_and_touch_activity();
-                Not_Add_To_TextContainer = false;
-                hide_smile_flag = true;
-                lv_label_set_text(ui_RecordText, "录音中");
-            }
-            else if (strcmp(shared_memory, "RecorDeR-End") == 0) {
-                wake_display_and_touch_activity();
-                Not_Add_To_TextContainer = false;
-                hide_smile_flag = true;
-                lv_label_set_text(ui_RecordText, "录音");
-            }
-            else if (strcmp(shared_memory, "TranslatE-ON") == 0) {//位置
-                wake_display_and_touch_activity();
-                Not_Add_To_TextContainer = false;
-                hide_smile_flag = true;
-                //lv_label_set_text(ui_StatusLabel, "请打开手机APP");
-                
-                // 向上移动ui_subMenu 50个像素点
-                if (ui_subMenu != NULL) {
-                    lv_coord_t current_x = lv_obj_get_x(ui_subMenu);
-                    lv_coord_t current_y = lv_obj_get_y(ui_subMenu);
-                    lv_obj_set_pos(ui_subMenu, current_x, current_y - 50);
-                }
-
-            }  
-            else if (strcmp(shared_memory, "NavigaT-ON") == 0) {//电话
-                wake_display_and_touch_activity();
-                Not_Add_To_TextContainer = false;
-                hide_smile_flag = true;
-                //需要打开电话簿
-                lv_label_set_text(ui_StatusLabel, " ");
-                lv_obj_add_flag(ui_subMenu, LV_OBJ_FLAG_HIDDEN);
-                lv_obj_add_flag(ui_Menu3, LV_OBJ_FLAG_HIDDEN);
-                read_and_display_file("/usr/bin/phone.txt", &memo_read_position, 
-                                      memo_buffer, "无法打开电话本");
-            }  
-            else if (strcmp(shared_memory, "IMUtest-ON") == 0) {//姿态
-                wake_display_and_touch_activity();
-                Not_Add_To_TextContainer = false;
-                hide_smile_flag = true;
-                // 进入IMU HUD模式：隐藏子菜单，仅在本模式下轮询aZ
-                if (ui_subMenu != NULL) {
-                    lv_obj_add_flag(ui_subMenu, LV_OBJ_FLAG_HIDDEN);
-                }
-                imu_hud_set_enabled(true);
-            }  
-            else if (strcmp(shared_memory, "TelePrompTer") == 0) {
-                wake_display_and_touch_activity();
-                Not_Add_To_TextContainer = false;
-                hide_smile_flag = true;  // 设置标志位，隐藏微笑标签
-                lv_obj_add_flag(ui_Menu1, LV_OBJ_FLAG_HIDDEN);//隐藏菜单页
-                // 恢复ui_VideoText正常透明度
-                if (ui_TeleprompterText != NULL) {
-                    lv_obj_set_style_text_opa(ui_TeleprompterText, LV_OPA_COVER, LV_PART_MAIN | LV_STATE_DEFAULT);
-                }
-                if (ui_VideoText != NULL) {//设置录像机透明度
-                    lv_obj_set_style_text_opa(ui_VideoText, LV_OPA_20, LV_PART_MAIN | LV_STATE_DEFAULT);
-                }
-                // 设置ui_CameraText透明度为20%
-                if (ui_CameraText != NULL) {
-                    lv_obj_set_style_text_opa(ui_CameraText, LV_OPA_20, LV_PART_MAIN | LV_STATE_DEFAULT);
-                }
-            }
-            else if (strcmp(shared_memory, "TelePrompTerNextParagraph") == 0) {
-                // 读取提词器文本文件
-                wake_display_and_touch_activity();
-                read_and_display_file("/usr/bin/TeleprompTer.txt", &teleprompter_read_position, 
-                                      teleprompter_buffer, "无法打开提词器文件");
-            }
-            else if (strcmp(shared_memory, "FFmFinished") == 0) {
-                wake_display_and_touch_activity();
-                Not_Add_To_TextContainer = false;
-                hide_smile_flag = true;
-                //if (ui_CameraText) {
-                    lv_label_set_text(ui_CameraText, "拍照");
-                //}
-            }  
-            else if (strcmp(shared_memory, "VideoRecing") == 0) {
-                wake_display_and_touch_activity();
-                Not_Add_To_TextContainer = false;
-                hide_smile_flag = true;
-                lv_obj_clear_flag(ui_VideoRecordingContainer, LV_OBJ_FLAG_HIDDEN);
-                if (ui_VideoContainer) lv_obj_add_flag(ui_VideoContainer, LV_OBJ_FLAG_HIDDEN);
-            }
-            else if (strcmp(shared_memory, "Finish-Video") == 0) {
-                wake_display_and_touch_activity();
-                Not_Add_To_TextContainer = false;
-                hide_smile_flag = true;
-                lv_obj_add_flag(ui_VideoRecordingContainer, LV_OBJ_FLAG_HIDDEN);
-                if (ui_VideoContainer) lv_obj_clear_flag(ui_VideoContainer, LV_OBJ_FLAG_HIDDEN);
-            }
-            else if (strncmp(shared_memory, "MeTeR", 5) == 0) {//导航用于指示剩余路程
-            }
-            else if (strcmp(shared_memory, "TurnLefT") == 0) {//显示左转图标
-            }
-            else if (strcmp(shared_memory, "TurnRighT") == 0) {//显示右转图标
-            }
-            else if (strcmp(shared_memory, "GoStraighT") == 0) {//显示直行图标
-            }
-            else if (strcmp(shared_memory, "MeMo") == 0) {//备忘录被选定
-                wake_display_and_touch_activity();
-                Not_Add_To_TextContainer = false;
-                hide_smile_flag = true;
-                
-                // 隐藏ui_Label2
-                if (ui_Label2 != NULL) {
-                    lv_obj_add_flag(ui_Label2, LV_OBJ_FLAG_HIDDEN);
-                }
-                if (ui_subMenu != NULL) {
-                    lv_obj_add_flag(ui_subMenu, LV_OBJ_FLAG_HIDDEN);
-                }
-                // 调整文字标签位置：MeMo收到后变成227，另外两个变成239
-                if (ui_MemoText != NULL) {
-                    lv_obj_set_pos(ui_MemoText, 508-32, 227);
-                }
-                if (ui_RecordText != NULL) {
-                    lv_obj_set_pos(ui_RecordText, 60-10, 239);
-                }
-                if (ui_MoreText != NULL) {
-                    lv_obj_set_pos(ui_MoreText, 280-10, 239);
-                }
-            }
-            else if (strcmp(shared_memory, "MeMoDisplay") == 0) {//备忘录显示出来
-                wake_display_and_touch_activity();
-                Not_Add_To_TextContainer = false;
-                hide_smile_flag = true;
-                
-                // 隐藏ui_Label2
-                if (ui_Label2 != NULL) {
-                    lv_obj_add_flag(ui_Label2, LV_OBJ_FLAG_HIDDEN);
-                }
-                lv_obj_add_flag(ui_Menu3, LV_OBJ_FLAG_HIDDEN);
-                read_and_display_file("/usr/bin/memo.txt", &memo_read_position, 
-                                      memo_buffer, "无法打开备忘录文件");
-            }
-            else if (strcmp(shared_memory, "MoRe") == 0) {//子菜单被选定
-                wake_display_and_touch_activity();
-                Not_Add_To_TextContainer = false;
-                hide_smile_flag = true;
-                
-                // 隐藏ui_Label2
-                if (ui_Label2 != NULL) {
-                    lv_obj_add_flag(ui_Label2, LV_OBJ_FLAG_HIDDEN);
-                }
-                
-                // 调整文字标签位置：MoRe收到后变成227，另外两个变成239
-                if (ui_MoreText != NULL) {
-                    lv_obj_set_pos(ui_MoreText, 280-10, 227);
-                }
-                if (ui_MemoText != NULL) {
-                    lv_obj_set_pos(ui_MemoText, 508-32, 239);
-                }
-                if (ui_RecordText != NULL) {
-                    lv_obj_set_pos(ui_RecordText, 60-10, 239);
-                }
-            }
-            // subMenu相关命令处理
-            else if (strcmp(shared_memory, "TranslatE") == 0) {//翻译被选定
-                wake_display_and_touch_activity();
-                Not_Add_To_TextContainer = false;
-                hide_smile_flag = true;
-                
-                // 隐藏ui_Label2和ui_Menu3
-                if (ui_Label2 != NULL) {
-                    lv_obj_add_flag(ui_Label2, LV_OBJ_FLAG_HIDDEN);
-                }
-                if (ui_Menu3 != NULL) {
-                    lv_obj_add_flag(ui_Menu3, LV_OBJ_FLAG_HIDDEN);
-                }
-                // 显示ui_subMenu
-                if (ui_subMenu != NULL) {
-                    lv_obj_clear_flag(ui_subMenu, LV_OBJ_FLAG_HIDDEN);
-                }
-                
-                // 调整ui_SubMenu_Rect位置：X=69, Y=289
-                if (ui_SubMenu_Rect != NULL) {
-                    lv_obj_set_pos(ui_SubMenu_Rect, 69, 289);
-                }
-            }
-            else if (strcmp(shared_memory, "NavigaT") == 0) {//导航被选定
-                wake_display_and_touch_activity();
-                Not_Add_To_TextContainer = false;
-                hide_smile_flag = true;
-                
-                // 隐藏ui_Label2和ui_Menu3
-                if (ui_Label2 != NULL) {
-                    lv_obj_add_flag(ui_Label2, LV_OBJ_FLAG_HIDDEN);
-                }
-                if (ui_Menu3 != NULL) {
-                    lv_obj_add_flag(ui_Menu3, LV_OBJ_FLAG_HIDDEN);
-                }
-                // 显示ui_subMenu
-                if (ui_subMenu != NULL) {
-                    lv_obj_clear_flag(ui_subMenu, LV_OBJ_FLAG_HIDDEN);
-                }
-                
-                // 调整ui_SubMenu_Rect位置：X=269, Y=289
-                if (ui_SubMenu_Rect != NULL) {
-                    lv_obj_set_pos(ui_SubMenu_Rect, 269, 289);
-                }
-            }
-            else if (strcmp(shared_memory, "DisplayPhoto") == 0) {//显示图被选定
-                wake_display_and_touch_activity();
-                Not_Add_To_TextContainer = false;
-                hide_smile_flag = true;
-                
-                // 隐藏ui_Label2和ui_Menu3
-                if (ui_Label2 != NULL) {
-                    lv_obj_add_flag(ui_Label2, LV_OBJ_FLAG_HIDDEN);
-                }
-                if (ui_Menu3 != NULL) {
-                    lv_obj_add_flag(ui_Menu3, LV_OBJ_FLAG_HIDDEN);
-                }
-                // 显示ui_subMenu
-                if (ui_subMenu != NULL) {
-                    lv_obj_clear_flag(ui_subMenu, LV_OBJ_FLAG_HIDDEN);
-                }
-                
-                // 调整ui_SubMenu_Rect位置：X=471, Y=289
-                if (ui_SubMenu_Rect != NULL) {
-                    lv_obj_set_pos(ui_SubMenu_Rect, 471, 289);
-                }
-            }
-            else if (strcmp(shared_memory, "DisplayPhoto-ON") == 0) {//显示图被选定
-                wake_display_and_touch_activity();
-                Not_Add_To_TextContainer = false;
-                hide_smile_flag = true;
-                
-                // 隐藏ui_Label2和ui_Menu3
-                if (ui_subMenu != NULL) {
-                    lv_obj_add_flag(ui_subMenu, LV_OBJ_FLAG_HIDDEN);
-                }
-                load_and_display_image(NULL);//显示图片
-            }
-            else if (strcmp(shared_memory, "FontSize-ON") == 0) {//大小字
-                wake_display_and_touch_activity();
-                Not_Add_To_TextContainer = false;
-                hide_smile_flag = true;
-
-                // 将所有SubMenu标签的字体改为ui_font_alibaba_30
-                if (ui_SubMenu_Translate != NULL) {
-                    lv_obj_set_style_text_font(ui_SubMenu_Translate, &ui_font_alibaba_30, LV_PART_MAIN | LV_STATE_DEFAULT);
-                }
-                if (ui_SubMenu_Navigation != NULL) {
-                    lv_obj_set_style_text_font(ui_SubMenu_Navigation, &ui_font_alibaba_30, LV_PART_MAIN | LV_STATE_DEFAULT);
-                }
-                if (ui_SubMenu_DisplayImage != NULL) {
-                    lv_obj_set_style_text_font(ui_SubMenu_DisplayImage, &ui_font_alibaba_30, LV_PART_MAIN | LV_STATE_DEFAULT);
-                }
-                if (ui_SubMenu_ASR != NULL) {
-                    lv_obj_set_style_text_font(ui_SubMenu_ASR, &ui_font_alibaba_30, LV_PART_MAIN | LV_STATE_DEFAULT);
-                }
-                if (ui_SubMenu_Sleep != NULL) {
-                    lv_obj_set_style_text_font(ui_SubMenu_Sleep, &ui_font_alibaba_30, LV_PART_MAIN | LV_STATE_DEFAULT);
-                }
-                if (ui_SubMenu_Personalize != NULL) {
-                    lv_obj_set_style_text_font(ui_SubMenu_Personalize, &ui_font_alibaba_30, LV_PART_MAIN | LV_STATE_DEFAULT);
-                }
-                if (ui_SubMenu_Attitude != NULL) {
-                    lv_obj_set_style_text_font(ui_SubMenu_Attitude, &ui_font_alibaba_30, LV_PART_MAIN | LV_STATE_DEFAULT);
-                }
-                if (ui_SubMenu_Exit != NULL) {
-                    lv_obj_set_style_text_font(ui_SubMenu_Exit, &ui_font_alibaba_30, LV_PART_MAIN | LV_STATE_DEFAULT);
-                }
-
-                // 强制刷新屏幕，让用户看得到效果
-                lv_obj_invalidate(lv_scr_act());  // invalidate整个屏幕
-                lv_refr_now(lv_disp_get_default()); // 强制刷新
-
-            }
-            else if (strcmp(shared_memory, "bd_ASR") == 0) {//ASR被选定
-                wake_display_and_touch_activity();
-                Not_Add_To_TextContainer = false;
-                hide_smile_flag = true;
-                
-                // 隐藏ui_Label2和ui_Menu3
-                if (ui_Label2 != NULL) {
-                    lv_obj_add_flag(ui_Label2, LV_OBJ_FLAG_HIDDEN);
-                }
-                if (ui_Menu3 != NULL) {
-                    lv_obj_add_flag(ui_Menu3, LV_OBJ_FLAG_HIDDEN);
-                }
-                // 显示ui_subMenu
-                if (ui_subMenu != NULL) {
-                    lv_obj_clear_flag(ui_subMenu, LV_OBJ_FLAG_HIDDEN);
-                }
-
-                if (ui_SubMenu_Rect != NULL) {
-                    lv_obj_set_pos(ui_SubMenu_Rect, 69, 174);
-                }
-            }
-            else if (strcmp(shared_memory, "SleeP") == 0) {//休眠被选定
-                wake_display_and_touch_activity();
-                Not_Add_To_TextContainer = false;
-                hide_smile_flag = true;
-                
-                // 调整ui_SubMenu_Rect位置：X轴变为269，Y轴不变
-                if (ui_SubMenu_Rect != NULL) {
-                    lv_obj_set_pos(ui_SubMenu_Rect, 269, 174);
-                }
-
-                lv_label_set_text(ui_StatusLabel, "  ");//清空上一个
-                
-                // 隐藏ui_Label2和ui_Menu3
-                if (ui_Label2 != NULL) {
-                    lv_obj_add_flag(ui_Label2, LV_OBJ_FLAG_HIDDEN);
-                }
-                if (ui_Menu3 != NULL) {
-                    lv_obj_add_flag(ui_Menu3, LV_OBJ_FLAG_HIDDEN);
-                }
-                // 显示ui_subMenu
-                if (ui_subMenu != NULL) {
-                    lv_obj_clear_flag(ui_subMenu, LV_OBJ_FLAG_HIDDEN);
-                }
-            }
-            else if (strcmp(shared_memory, "FontSize") == 0) {//个性化被选定
-                wake_display_and_touch_activity();
-                Not_Add_To_TextContainer = false;
-                hide_smile_flag = true;
-                
-                // 隐藏ui_Label2和ui_Menu3
-                if (ui_Label2 != NULL) {
-                    lv_obj_add_flag(ui_Label2, LV_OBJ_FLAG_HIDDEN);
-                }
-                if (ui_Menu3 != NULL) {
-                    lv_obj_add_flag(ui_Menu3, LV_OBJ_FLAG_HIDDEN);
-                }
-                // 显示ui_subMenu
-                if (ui_subMenu != NULL) {
-                    lv_obj_clear_flag(ui_subMenu, LV_OBJ_FLAG_HIDDEN);
-                }
-                
-                // 调整ui_SubMenu_Rect位置：Y轴变为471，X轴保持不变
-                if (ui_SubMenu_Rect != NULL) {
-                    lv_coord_t current_x = lv_obj_get_x(ui_SubMenu_Rect);
-                    lv_obj_set_pos(ui_SubMenu_Rect, 471, 174);
-                }
-            }
-            else if (strcmp(shared_memory, "QuiT") == 0) {//退出子菜单
-                wake_display_and_touch_activity();
-                Not_Add_To_TextContainer = false;
-                hide_smile_flag = true;
-                
-
-                
-                // 调整ui_SubMenu_Rect位置：X=269, Y=410
-                if (ui_SubMenu_Rect != NULL) {
-                    lv_obj_set_pos(ui_SubMenu_Rect, 269, 410-100+48+48);
-                }
-            }
-            else if (strcmp(shared_memory, "QuiTed") == 0) {//退出子菜单
-                wake_display_and_touch_activity();
-                Not_Add_To_TextContainer = false;
-                hide_smile_flag = true;
-                
-                // 隐藏ui_subMenu
-                if (ui_subMenu != NULL) {
-                    lv_obj_add_flag(ui_subMenu, LV_OBJ_FLAG_HIDDEN);
-                }
-            }
-            else if (strcmp(shared_memory, "IntoSleep") == 0) {//关闭屏幕
-                send_cmd(SPI_DISPLAY_DISABLE);
-                send_cmd(SPI_SYNC);
-            }
-            else if (strcmp(shared_memory, "IMUtest") == 0) {//IMU测试被选定
-                wake_display_and_touch_activity();
-                Not_Add_To_TextContainer = false;
-                hide_smile_flag = true;
-                
-                // 隐藏ui_Label2和ui_Menu3
-                if (ui_Label2 != NULL) {
-                    lv_obj_add_flag(ui_Label2, LV_OBJ_FLAG_HIDDEN);
-                }
-                if (ui_Menu3 != NULL) {
-                    lv_obj_add_flag(ui_Menu3, LV_OBJ_FLAG_HIDDEN);
-                }
-                // 显示ui_subMenu
-                if (ui_subMenu != NULL) {
-                    lv_obj_clear_flag(ui_subMenu, LV_OBJ_FLAG_HIDDEN);
-                }
-                
-                // 调整ui_SubMenu_Rect位置：X=69, Y=410
-                if (ui_SubMenu_Rect != NULL) {
-                    lv_obj_set_pos(ui_SubMenu_Rect, 69, 410);
-                }
-            }
-            // 处理其他显示内容
-            else if (strcmp(shared_memory, "init") != 0) {
-                // 如果有新内容显示，重新开启显示并更新活动时间
-                wake_display_and_touch_activity();
-                Not_Add_To_TextContainer = true;
-                hide_smile_flag = true;  // 设置标志位，不直接操作UI
-                printf("Display updated to: %s\n", shared_memory);
-
-
-                // 指令到中文提示的映射
-                if (strcmp(shared_memory, "finished") == 0) {
-                    Not_Add_To_TextContainer = false;
-                    lv_label_set_text(ui_StatusLabel, "触摸镜腿 开始对话");
-                    // 不再放进 last_message、shared_memory，也不显示到 ui_Label2
-                    continue;
-                } else if (strcmp(shared_memory, "Recording") == 0) {
-                    Not_Add_To_TextContainer = false;
-                    lv_label_set_text(ui_StatusLabel, "录音中 松手发送");
-                    continue;
-                } else if (strcmp(shared_memory, "Upload") == 0) {
-                    Not_Add_To_TextContainer = false;
-                    lv_label_set_text(ui_StatusLabel, "上传中");
-                    continue;
-                }
-                else if (strcmp(shared_memory, "ProceSSing") == 0) {
-                    Not_Add_To_TextContainer = false;
-                    lv_label_set_text(ui_StatusLabel, "处理中");
-                    continue;
-                }
-                // 隐藏对话气泡
-                /*if (ui_SpeechBubble != NULL) {
-                    lv_obj_add_flag(ui_SpeechBubble, LV_OBJ_FLAG_HIDDEN);
-                    //printf("🎯 未检测到Ai，隐藏对话气泡\n");
-                }
-                if (ui_SpeechTail1 != NULL) {
-                    lv_obj_add_flag(ui_SpeechTail1, LV_OBJ_FLAG_HIDDEN);
-                }
-                if (ui_SpeechTail2 != NULL) {
-                    lv_obj_add_flag(ui_SpeechTail2, LV_OBJ_FLAG_HIDDEN);
-                }
-                */
-
-                
-                // 检测是否为"Brightness"指令，控制亮度调节元素显示，同时隐藏文本容器
-
-
-
-                
-                // 显示普通文本内容时，确保文本容器可见并隐藏其它图标
-                if (ui_TextContainer) lv_obj_clear_flag(ui_TextContainer, LV_OBJ_FLAG_HIDDEN);
-                lv_obj_add_flag(ui_TeleprompTerContainer, LV_OBJ_FLAG_HIDDEN);//设置提词器隐藏
-                lv_obj_add_flag(ui_subMenu, LV_OBJ_FLAG_HIDDEN);//设置子菜单隐藏
-                // 隐藏录像机容器（包含所有录像机组件）
-                if (ui_VideoContainer != NULL) {
-                    lv_obj_add_flag(ui_VideoContainer, LV_OBJ_FLAG_HIDDEN);
-                }
-                //隐藏Menu3容器
-                if (ui_Menu3) lv_obj_add_flag(ui_Menu3, LV_OBJ_FLAG_HIDDEN);
-                // 隐藏这些元素
-                if (ui_Menu1) lv_obj_add_flag(ui_Menu1, LV_OBJ_FLAG_HIDDEN);
-                // 取消隐藏 ui_Label2
-                if (ui_Label2)           lv_obj_clear_flag(ui_Label2, LV_OBJ_FLAG_HIDDEN);
-                lv_obj_scroll_to_y(ui_TextContainer, LV_COORD_MAX, LV_ANIM_OFF);//滚动到底
-                                // 强制刷新屏幕，让用户看得到效果
-                //lv_obj_invalidate(lv_scr_act());  // invalidate整个屏幕
-                //lv_refr_now(lv_disp_get_default()); // 强制刷新
-            }
-            // 在display_update_thread函数中修改处理逻辑
-            
-            
-        //}
+        memcpy(text, shared_memory, BUFFER_SIZE);
+        text[BUFFER_SIZE - 1] = '\0';
+        msg_bus_publish_text(&display_bus, text);
     }
-    
     return NULL;
 }
 
@@ -1018,7 +1002,13 @@ void cleanup(int signum) {
     }
     
     shm_unlink(SHM_NAME);
+
+    // 总线不unlink：其他进程还映射着，重启后继续用同一个对象
+    msg_bus_close(&display_bus);
     
+    if (spi_get_transport() == &panel_sim_transport) {
+        panel_sim_stats_print();
+    }
     if (spi_file > 0) {
         close(spi_file);
     }
@@ -1052,7 +1042,33 @@ int setup() {
     spi_init();         // 初始化SPI设备
     panel_init();       // 初始化面板
 
-            // 启动IMU HUD后台服务线程（空闲等待，非IMUtest-ON不读取）
+    // 1bit快速通道：DISPLAY_1BIT=auto 自动识别单色区间，=force 整屏按单色发送
+    const char* mono_env = getenv("DISPLAY_1BIT");
+    if (mono_env != NULL && strcmp(mono_env, "auto") == 0) {
+        panel_set_1bit_mode(PANEL_1BIT_AUTO);
+    } else if (mono_env != NULL && strcmp(mono_env, "force") == 0) {
+        panel_set_1bit_mode(PANEL_1BIT_FORCE);
+    }
+
+    // 照片抖动：DISPLAY_DITHER=bayer 有序抖动，=fs 误差扩散
+    const char* dither_env = getenv("DISPLAY_DITHER");
+    if (dither_env != NULL && strcmp(dither_env, "bayer") == 0) {
+        rgb_dither_mode = PIX_DITHER_BAYER;
+    } else if (dither_env != NULL && strcmp(dither_env, "fs") == 0) {
+        rgb_dither_mode = PIX_DITHER_FS;
+    }
+
+    // 硬件平滑滚动：DISPLAY_HW_SCROLL=1 打开（面板偏移回绕未核实，默认整区重绘）
+    const char* scroll_env = getenv("DISPLAY_HW_SCROLL");
+    if (scroll_env != NULL && strcmp(scroll_env, "1") == 0) {
+        hw_scroll_set_enabled(true);
+    }
+
+            // 主循环的事件分发和UI命令队列的eventfd
+            reactor_init();
+            ui_queue_init();
+
+            // IMU HUD（定时器只在IMUtest-ON时启用）
             imu_hud_init();
 
             // 设置信号处理
@@ -1095,6 +1111,16 @@ int setup() {
                 return -1;
             }
         
+            // 命令表的哈希索引，display_update_thread启动前建好
+            display_cmds_init();
+
+            // 打开消息总线并订阅，之后发布的消息display_update_thread都会收到
+            if (msg_bus_open(&display_bus, NULL) != 0 ||
+                msg_bus_subscribe(&display_bus, "display") != 0) {
+                display_string_at(0,0,"bus-f");
+                return -1;
+            }
+
             // 创建显示更新线程
             pthread_t display_thread;
             if (pthread_create(&display_thread, NULL, display_update_thread, NULL) != 0) {
@@ -1103,6 +1129,15 @@ int setup() {
                 return -1;
             }
             pthread_detach(display_thread);  // 线程后台运行
+
+            // 创建旧协议桥接线程
+            pthread_t bridge_thread;
+            if (pthread_create(&bridge_thread, NULL, legacy_bridge_thread, NULL) != 0) {
+                perror("Failed to create bridge thread");
+                display_string_at(0,0,"pth-f");
+                return -1;
+            }
+            pthread_detach(bridge_thread);
     //显示文字测试
     //display_string("FH");
     //demo_image_sequence("/test/test.bmp");
@@ -1136,82 +1171,148 @@ int setup() {
 
 
 
-void disp_flush(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p) {
-    
-    uint32_t width = area->x2 - area->x1 + 1;    // 刷新区域的像素宽度（关键：单位是像素，不是字节）
-    uint32_t height = area->y2 - area->y1 + 1;  // 刷新区域的像素高度
-    uint32_t pixel_count = width * height;       // 总像素数（4位色深）
-    uint32_t bytes_written = 0;                  // 缓冲区已写入的字节数
-    uint32_t transfer_count = 0;                 // SPI传输次数计数器
-    
-    #define SPI_MAX_TRANSFER_SIZE 1024
-    static uint8_t transfer_buffer[SPI_MAX_TRANSFER_SIZE];
-    printf("Flush started (4-bit color): area (%d,%d)-(%d,%d), pixels=%d\n", 
-           area->x1, area->y1, area->x2, area->y2, pixel_count);    // 添加调试信息
-    
-    uint8_t current_byte = 0;          // 临时存储2个4位像素（高4位+低4位）
-    bool has_upper_nibble = false;     // 标记是否已存储高4位像素
-    uint32_t start_pixel = 0;          // 记录当前传输块的**起始像素索引**（关键修正）
-    
-    for (uint32_t i = 0; i < pixel_count; i++) {
-        // 提取4位像素数据（假设有效数据在低4位，可根据实际格式调整）
-        uint8_t pixel_4bit = (*((uint8_t *)&color_p[i])) & 0x0F;
-        
-        if (!has_upper_nibble) {
-            // 第一个像素：存到字节的高4位
-            current_byte = (pixel_4bit << 4) & 0xF0;
-            has_upper_nibble = true;
-        } else {
-            // 第二个像素：存到字节的低4位，完成1字节
-            current_byte |= pixel_4bit & 0x0F;
-            transfer_buffer[bytes_written++] = current_byte;
-            has_upper_nibble = false;
-        }
-        
-        // 触发SPI传输的条件：缓冲区满 或 处理完所有像素
-        bool is_last_pixel = (i == pixel_count - 1);
-        if (bytes_written >= SPI_MAX_TRANSFER_SIZE || is_last_pixel) {
-            // 处理最后一个像素（若为奇数，补全1字节）
-            if (is_last_pixel && has_upper_nibble) {
-                transfer_buffer[bytes_written++] = current_byte;  // 低4位留空
-                has_upper_nibble = false;
-            }
-            
-            // 关键修正：计算传输块的**起始像素坐标**（基于start_pixel）
-            uint32_t start_row = area->y1 + (start_pixel / width);  // 起始行 = 起始像素 / 宽度
-            uint32_t start_col = area->x1 + (start_pixel % width);  // 起始列 = 起始像素 % 宽度
-            
-            // 用起始坐标传输，而非当前像素i的坐标
-            if (spi_wr_buffer(start_col, start_row, transfer_buffer, bytes_written) != 0) {
-                printf("SPI transfer failed!");
-            }
-            transfer_count++;
-            
-            // 更新下一次传输的起始像素（当前传输块的结束像素+1）
-            start_pixel = i + 1;
-            
-            // 重置缓冲区
-            bytes_written = 0;
-            current_byte = 0;
-        }
-    }
-    
-    // 打印传输次数
-    printf("spi_wr_buffer called %d times\n", transfer_count);
-    
-    // 验证传输字节数（4位色深：总字节数 = 总像素数 ÷ 2 向上取整）
-    uint32_t expected_bytes = (pixel_count + 1) / 2;
-    uint32_t actual_bytes = (transfer_count - 1) * SPI_MAX_TRANSFER_SIZE + bytes_written;
-    if (actual_bytes == expected_bytes) {
-        printf("Bytes verified: %d bytes for %d pixels\n", actual_bytes, pixel_count);
-    } else {
-        printf("Bytes mismatch: expected %d, actual %d\n", expected_bytes, actual_bytes);
-    }
-    
-    send_cmd(SPI_SYNC);
-    usleep(1 * 1000);
-    lv_disp_flush_ready(drv);
+// 刷新区域对齐到整字节：面板4bpp每字节2像素，x1取偶数、x2取奇数
+static void disp_rounder(lv_disp_drv_t *drv, lv_area_t *area) {
+    area->x1 &= ~1;
+    area->x2 |= 1;
+}
+
+static void disp_flush_transmit(const lv_area_t *area, const lv_color_t *color_p) {
+    uint32_t width = area->x2 - area->x1 + 1;    // 刷新区域像素宽度（rounder保证为偶数）
+    uint32_t height = area->y2 - area->y1 + 1;  // 刷新区域像素高度
+    uint32_t row_bytes = width / 2;              // 每行打包后的字节数
+    const uint8_t *l4 = (const uint8_t *)color_p; // 已是面板格式的4bpp数据（disp_l4.c）
+
+    static spi_wr_seg_t segs[480];               // 每行一段
+    uint32_t seg_count = 0;
+
+    if (width == 640) {
+        // 全宽区域：面板地址按行线性递增，一次突发写完
+        segs[0].col = 0;
+        segs[0].row = area->y1;
+        segs[0].pBuf = l4;
+        segs[0].len = row_bytes * height;
+        seg_count = 1;
+    } else {
+        // 部分宽度：每行一段连续写，直接从绘制缓冲区发送
+        for (uint32_t y = 0; y < height; y++) {
+            segs[y].col = area->x1;
+            segs[y].row = area->y1 + y;
+            segs[y].pBuf = &l4[y * row_bytes];
+            segs[y].len = row_bytes;
+        }
+        seg_count = height;
+    }
+
+    // 经影子缓冲只发送变化的区间，同步在帧结束时统一进行
+    display_segments(segs, seg_count);
+}
+
+
+
+// ================== SPI 刷新工作线程 ==================
+// disp_flush只把刷新任务放入队列就返回，由工作线程打包、发送、同步，
+// 完成后再调用lv_disp_flush_ready，LVGL渲染下一帧与SPI发送并行
+#define FLUSH_QUEUE_LEN 4
+
+typedef struct {
+    lv_disp_drv_t *drv;
+    lv_area_t area;
+    lv_color_t *color_p;    // NULL为硬件滚动任务：area的各行上移dy行（hw_scroll.c）
+    lv_coord_t dy;
+    bool last;              // 本次刷新的最后一块区域
+} flush_job_t;
+
+static flush_job_t flush_queue[FLUSH_QUEUE_LEN];
+static uint32_t flush_head = 0;    // 下一个出队位置
+static uint32_t flush_count = 0;   // 队列中任务数
+static pthread_mutex_t flush_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t flush_not_empty = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t flush_not_full = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t flush_done = PTHREAD_COND_INITIALIZER;    // 一块区域发送完（lv_disp_flush_ready之后）
+static pthread_t flush_thread;
+
+static void* flush_worker_thread(void* arg) {
+    bool in_frame = false;
+
+    (void)arg;
+    while (1) {
+        pthread_mutex_lock(&flush_mutex);
+        while (flush_count == 0) {
+            pthread_cond_wait(&flush_not_empty, &flush_mutex);
+        }
+        flush_job_t job = flush_queue[flush_head];
+        flush_head = (flush_head + 1) % FLUSH_QUEUE_LEN;
+        flush_count--;
+        pthread_cond_signal(&flush_not_full);
+        pthread_mutex_unlock(&flush_mutex);
+
+        // 一次LVGL刷新的所有区域合并为一帧，最后一块区域发送后只同步一次
+        if (!in_frame) {
+            panel_frame_begin();
+            in_frame = true;
+        }
+        if (job.color_p == NULL) {
+            // 硬件滚动：行原点移动和随后重绘的区域在同一帧，一起同步
+            panel_scroll_rows(job.area.y1, job.area.y2 - job.area.y1 + 1, job.dy);
+            continue;
+        }
+        disp_flush_transmit(&job.area, job.color_p);
+        if (job.last) {
+            panel_frame_end();
+            in_frame = false;
+        }
+        lv_disp_flush_ready(job.drv);   // 只置位标志，可在非LVGL线程调用
+        pthread_mutex_lock(&flush_mutex);
+        pthread_cond_signal(&flush_done);
+        pthread_mutex_unlock(&flush_mutex);
+    }
+    return NULL;
+}
+
+// LVGL要用正在发送的缓冲区时在draw_buf->flushing上等待，默认是空转；
+// 单核RV1106上空转会和工作线程抢CPU，这里睡到工作线程发完再醒
+static void disp_flush_wait(lv_disp_drv_t *drv) {
+    pthread_mutex_lock(&flush_mutex);
+    while (drv->draw_buf->flushing) {
+        pthread_cond_wait(&flush_done, &flush_mutex);
+    }
+    pthread_mutex_unlock(&flush_mutex);
+}
+
+static int flush_worker_init(void) {
+    if (pthread_create(&flush_thread, NULL, flush_worker_thread, NULL) != 0) {
+        perror("Failed to create flush thread");
+        return -1;
+    }
+    pthread_detach(flush_thread);
+    return 0;
+}
+
+static void flush_queue_put(const flush_job_t *job) {
+    pthread_mutex_lock(&flush_mutex);
+    while (flush_count == FLUSH_QUEUE_LEN) {
+        pthread_cond_wait(&flush_not_full, &flush_mutex);
+    }
+    flush_queue[(flush_head + flush_count) % FLUSH_QUEUE_LEN] = *job;
+    flush_count++;
+    pthread_cond_signal(&flush_not_empty);
+    pthread_mutex_unlock(&flush_mutex);
+}
+
+void disp_flush(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p) {
+    flush_job_t job = { drv, *area, color_p, 0, lv_disp_flush_is_last(drv) };
+
+    flush_queue_put(&job);
+}
+
+// hw_scroll.c：在LVGL线程调用，排在之前已提交的刷新之后、滚动后重绘的区域之前
+void disp_flush_scroll(const lv_area_t *area, lv_coord_t dy) {
+    flush_job_t job = { NULL, *area, NULL, dy, false };
+
+    flush_queue_put(&job);
 }
+// ================== SPI 刷新工作线程结束 ==================
 
 
 
@@ -1220,23 +1321,50 @@ void lvgl_init(void) {
     // 初始化LVGL核心
     //lv_init();
 
-    // 初始化显示缓冲区
-    lv_disp_draw_buf_init(&draw_buf, disp_buf, NULL, DISP_BUF_SIZE);
+    // 初始化显示缓冲区（双缓冲）
+    lv_disp_draw_buf_init(&draw_buf, disp_buf, disp_buf2, DISP_BUF_PX);
+    flush_worker_init();
   
     // 初始化显示驱动
     lv_disp_drv_init(&disp_drv);
     disp_drv.hor_res = 640;  // 水平分辨率
     disp_drv.ver_res = 480;  // 垂直分辨率
     disp_drv.flush_cb = disp_flush;
+    disp_drv.wait_cb = disp_flush_wait;
+    disp_drv.rounder_cb = disp_rounder;
     disp_drv.draw_buf = &draw_buf;
+    disp_drv.draw_ctx_init = disp_l4_draw_ctx_init;  // 按4bpp合成，flush不再转换
     lv_disp_drv_register(&disp_drv);
 }
 
-/* 系统定时器回调 (用于LVGL心跳) */
-void sys_tick_handler(void) {
-    lv_tick_inc(1); // 增加LVGL的时钟计数
+// 界面对象上直接引用的字体换成带缓存的包装字体
+static lv_obj_tree_walk_res_t use_cached_font(lv_obj_t *obj, void *user_data) {
+    lv_style_value_t v;
+    const lv_font_t *font;
+
+    (void)user_data;
+    if (lv_obj_get_local_style_prop(obj, LV_STYLE_TEXT_FONT, &v, LV_PART_MAIN | LV_STATE_DEFAULT) == LV_RES_OK) {
+        font = glyph_cache_resolve(v.ptr);
+        if (font != v.ptr) {
+            lv_obj_set_style_text_font(obj, font, LV_PART_MAIN | LV_STATE_DEFAULT);
+        }
+    }
+    return LV_OBJ_TREE_WALK_NEXT;
+}
+
+// 中文字体的字形描述和位图走缓存（glyph_cache.h），ui_init之后调用
+// SquareLine生成的界面直接取字体变量的地址，这里遍历所有屏幕换成包装字体；之后改字体的命令经ui_queue同样换掉
+void ui_font_cache_init(void) {
+#ifndef FONT_BIN
+    // FONT_BIN时alibaba_30由font_bin.c实现，自带同样的缓存，不再包装
+    glyph_cache_font(&ui_font_alibaba_30, GLYPH_CACHE_BYTES);
+#endif
+    glyph_cache_font(&ui_font_alibaba_48, GLYPH_CACHE_BYTES);
+    lv_obj_tree_walk(NULL, use_cached_font, NULL);
 }
 
+/* LVGL心跳由LV_TICK_CUSTOM取CLOCK_MONOTONIC（reactor.c: custom_tick_get），不再需要lv_tick_inc */
+
 /* 主应用初始化 */
 // void app_init(void) {
    
@@ -1270,7 +1398,180 @@ void loop() {
     usleep(100 * 1000);
 }
 
-// 主函数
+// UI命令执行和主函数（DISPLAY_NO_MAIN时不编译，供bench/display_bench.c链接显示程序的其余部分）
+#ifndef DISPLAY_NO_MAIN
+// ================== UI命令执行（LVGL线程） ==================
+// 一条消息处理完：需要时把消息累加到ui_Label2，滚动到底并立即刷新
+static void ui_apply_message(const ui_cmd_t* cmd) {
+    if (ui_Label2 == NULL) return;
+
+    // 检查是否有新消息需要累加（流式片段可能和上一段相同，比如重复的词，不去重）
+    if (cmd->cont || strcmp(cmd->text, last_displayed_message) != 0) {
+        // 更新上次显示的消息（排除的关键词也要更新，避免重复处理）
+        strncpy(last_displayed_message, cmd->text, BUFFER_SIZE - 1);
+        last_displayed_message[BUFFER_SIZE - 1] = '\0';
+
+        // 排除不应进入累加文本的关键词；每条消息另起一行，流式字幕的后续片段接在最后一行后面，
+        // 只布局和失效改写过的行
+        if (cmd->append) {
+            caption_log_append(ui_Label2, cmd->text, !cmd->cont);
+            lv_obj_clear_flag(ui_Label2, LV_OBJ_FLAG_HIDDEN);
+            printf("caption += %s\n", cmd->text);
+        }
+    }
+    // 不再整屏失效、强制刷新：由主循环的lv_timer_handler只刷新失效的行
+}
+
+// 文档分页：文件只映射一次，页索引按ui_TeleprompTerTxT的字体和尺寸排版
+typedef struct {
+    const char *path;
+    const char *error_msg;
+    doc_pager_t pager;
+} doc_source_t;
+
+static doc_source_t doc_sources[DOC_COUNT] = {
+    [DOC_TELEPROMPTER] = { "/usr/bin/TeleprompTer.txt", "无法打开提词器文件" },
+    [DOC_PHONE]        = { "/usr/bin/phone.txt",        "无法打开电话本" },
+    [DOC_MEMO]         = { "/usr/bin/memo.txt",         "无法打开备忘录文件" },
+};
+static doc_view_t doc_view;     // ui_TeleprompTerTxT和预排下一页用的隐藏标签
+#define TELEPROMPTER_SCROLL_SPEED 40    // 提词器自动滚动速度（像素/秒）
+static doc_pager_t *scroll_pager;   // 自动滚动中的文档
+
+// 打开文档（文件或布局变了才重新映射），失败时显示错误信息并返回NULL
+static doc_pager_t *doc_open(int doc) {
+    doc_source_t *src;
+    doc_layout_t layout;
+
+    if (ui_TeleprompTerTxT == NULL || doc < 0 || doc >= DOC_COUNT) return NULL;
+    src = &doc_sources[doc];
+    if (doc_view.label[0] == NULL) doc_view_init(&doc_view, ui_TeleprompTerTxT);
+    lv_obj_clear_flag(ui_TeleprompTerContainer, LV_OBJ_FLAG_HIDDEN);
+
+    doc_view_get_layout(&doc_view, &layout);
+    if (doc_pager_open(&src->pager, src->path, &layout) < 0) {
+        // 文件打开失败，显示错误信息
+        doc_view_set_text(&doc_view, src->error_msg);
+        return NULL;
+    }
+    return &src->pager;
+}
+
+static void ui_apply_page(const ui_cmd_t* cmd) {
+    doc_pager_t *pg;
+
+    hw_scroll_auto_stop();
+    pg = doc_open(cmd->x);
+    if (pg == NULL) return;
+    doc_pager_step(pg, cmd->y);
+    doc_view_show(&doc_view, pg);
+    printf("%s: 第%u页\n", pg->path, (unsigned)pg->cur + 1);
+}
+
+// 滚到底：接上下一页继续滚
+static bool doc_scroll_refill(lv_obj_t* obj) {
+    return doc_view_run_advance(&doc_view, scroll_pager);
+}
+
+static void ui_apply_auto_scroll(const ui_cmd_t* cmd) {
+    if (hw_scroll_auto_running()) {
+        hw_scroll_auto_stop();
+        return;
+    }
+    scroll_pager = doc_open(cmd->x);
+    if (scroll_pager == NULL) return;
+    if (!scroll_pager->shown) doc_pager_step(scroll_pager, 1);
+    doc_view_show_run(&doc_view, scroll_pager);
+    hw_scroll_auto_start(ui_TeleprompTerContainer, TELEPROMPTER_SCROLL_SPEED, doc_scroll_refill);
+}
+
+static void ui_apply(const ui_cmd_t* cmd) {
+    switch (cmd->type) {
+    case UI_CMD_MESSAGE:
+        ui_apply_message(cmd);
+        break;
+    case UI_CMD_PAGE:
+        ui_apply_page(cmd);
+        break;
+    case UI_CMD_AUTO_SCROLL:
+        ui_apply_auto_scroll(cmd);
+        break;
+    default:
+        ui_cmd_apply(cmd);
+        break;
+    }
+}
+
+// 取空队列；命令带文本副本，放在静态区避免占用栈
+static void ui_drain(void) {
+    static ui_cmd_t cmd;
+
+    while (ui_queue_pop(&ui_ipc_queue, &cmd)) {
+        ui_apply(&cmd);
+    }
+}
+// ================== UI命令执行结束 ==================
+
+// ================== 主循环事件源 ==================
+static int lvgl_timer_fd = -1;     // 按lv_timer_handler返回的下一个到期时间触发
+static int power_timer_fd = -1;    // 省电超时
+
+// 未在省电模式时，把超时定时器设到 最后活动时间+POWER_SAVE_TIMEOUT，到期则关闭显示
+// last_activity_time由display_update_thread更新，它每处理一条消息都会触发UI事件，这里随之重新计算
+static void power_save_check(void) {
+    time_t current_time = time(NULL);
+    time_t idle = current_time - last_activity_time;
+
+    if (display_power_save_mode) {
+        reactor_timer_arm(power_timer_fd, REACTOR_TIMER_OFF);
+        return;
+    }
+    if (idle >= POWER_SAVE_TIMEOUT) {
+        display_disable();
+        display_power_save_mode = true;
+        power_save_start_time = current_time;
+        reactor_timer_arm(power_timer_fd, REACTOR_TIMER_OFF);
+    } else {
+        reactor_timer_arm(power_timer_fd, (uint32_t)(POWER_SAVE_TIMEOUT - idle) * 1000);
+    }
+}
+
+static void on_ui_event(int fd, void* arg) {
+    (void)fd;
+    (void)arg;
+    ui_queue_ack();
+    ui_drain();
+    power_save_check();
+}
+
+static void on_power_timer(int fd, void* arg) {
+    (void)arg;
+    reactor_timer_ack(fd);
+    power_save_check();
+}
+
+static void on_lvgl_timer(int fd, void* arg) {
+    (void)arg;
+    reactor_timer_ack(fd);
+}
+
+// 执行到期的LVGL定时器，返回距下一个到期的毫秒数
+// 没有待刷新区域也没有动画时暂停刷新定时器，否则它每LV_DISP_DEF_REFR_PERIOD都会唤醒一次；
+// 每次有事件唤醒后先恢复，UI命令造成的失效区域在本轮立即刷新
+static uint32_t lvgl_service(void) {
+    lv_disp_t* disp = lv_disp_get_default();
+    uint32_t next;
+
+    lv_timer_resume(disp->refr_timer);
+    next = lv_timer_handler();
+    if (disp->inv_p == 0 && lv_anim_count_running() == 0) {
+        lv_timer_pause(disp->refr_timer);
+        next = lv_timer_handler();  // 重新计算下一个到期时间，暂停的定时器不计
+    }
+    return next == LV_NO_TIMER_READY ? REACTOR_TIMER_OFF : next;
+}
+// ================== 主循环事件源结束 ==================
+
 int main() {
     usleep(10 * 1000);
     setup();
@@ -1282,118 +1583,33 @@ int main() {
 //    初始化应用
     //app_init();
     ui_init();
-    
+    ui_font_cache_init();
 
     lv_scr_load(ui_Screen1);
     //show_symbol_left();
     // 初始化时间检测
     last_activity_time = time(NULL);
 
-    while(1) {
-        // 处理LVGL任务
-        lv_task_handler();
-
-        if (hide_smile_flag) {
-            if (ui_Label2 != NULL) {
-                // 检查是否有新消息需要累加
-                if (strcmp(shared_memory, last_displayed_message) != 0) {
-                    // 排除不应进入累加文本的关键词
-                    if (Not_Add_To_TextContainer) {
-                        Not_Add_To_TextContainer = false;
-                        // 更新上次显示的消息
-                        strncpy(last_displayed_message, shared_memory, BUFFER_SIZE - 1);
-                        last_displayed_message[BUFFER_SIZE - 1] = '\0';
-
-                        // 计算新消息长度
-                        size_t new_msg_len = strnlen(shared_memory, BUFFER_SIZE - 1);
-
-                        // 检查是否有足够空间添加新消息
-                        if (accumulated_text_len + new_msg_len + 2 < ACCUMULATED_TEXT_SIZE) {  // +2 for "\n" and null terminator
-                            // 如果不是第一条消息，添加换行符
-                            if (accumulated_text_len > 0) {
-                                accumulated_text[accumulated_text_len++] = '\n';
-                            }
-
-                            // 添加新消息到累积文本
-                            strncpy(accumulated_text + accumulated_text_len, shared_memory, new_msg_len);
-                            accumulated_text_len += new_msg_len;
-                            accumulated_text[accumulated_text_len] = '\0';  // 确保字符串结束
-                        } else {
-                            // 缓冲区满，清空并重新开始
-                            accumulated_text_len = 0;
-                            strncpy(accumulated_text, shared_memory, new_msg_len);
-                            accumulated_text_len = new_msg_len;
-                            accumulated_text[accumulated_text_len] = '\0';
-                        }
-
-                        lv_label_set_text(ui_Label2, accumulated_text);
-                        lv_obj_clear_flag(ui_Label2, LV_OBJ_FLAG_HIDDEN);
-                    } else {
-                        // 对于排除的关键词，仍需更新 last_displayed_message 以避免重复处理
-                        strncpy(last_displayed_message, shared_memory, BUFFER_SIZE - 1);
-                        last_displayed_message[BUFFER_SIZE - 1] = '\0';
-                    }
-                }
-                
-                // 显示累积的文本
-                printf("accumulated_text = %s\n", accumulated_text);
-                
-
-                // 容器显隐改由 display_update_thread 决定，这里仅在可见时自动滚动
-                if (ui_TextContainer && !lv_obj_has_flag(ui_TextContainer, LV_OBJ_FLAG_HIDDEN)) {
-                    /* 确保标签完成重新布局后再执行滚动到底，避免滚动区高度仍为旧值 */
-                    lv_obj_update_layout(ui_Label2);
-                    lv_obj_update_layout(ui_TextContainer);
-                    /* 计算应滚动到的偏移 = (内容高度 - 容器高度)，小于0则置0 */
-                    lv_coord_t target_offset = lv_obj_get_height(ui_Label2) - lv_obj_get_height(ui_TextContainer);
-                    if (target_offset < 0) target_offset = 0;
-                    lv_obj_scroll_to_y(ui_TextContainer, target_offset, LV_ANIM_OFF);
-                }
-
-                lv_obj_invalidate(lv_scr_act());  // 关键修改： invalidate整个屏幕
-                lv_refr_now(lv_disp_get_default()); // 强制刷新
-            }
-            hide_smile_flag = false;
-        }
-        
-        // 省电模式检测
-        time_t current_time = time(NULL);
-        
-        if (!display_power_save_mode) {
-            // 检查是否需要进入省电模式
-            if (current_time - last_activity_time >= POWER_SAVE_TIMEOUT) {
-                send_cmd(SPI_DISPLAY_DISABLE);
-                send_cmd(SPI_SYNC);
-                usleep(1 * 1000);
-                display_power_save_mode = true;
-                power_save_start_time = current_time;
-            }
-        } else {
-            // 已在省电模式，显示省电状态信息
-            time_t power_save_duration = current_time - power_save_start_time;
-            if (power_save_duration % 10 == 0 && power_save_duration > 0) {
-            }
-        }
-        
-        // IMU HUD 触发显示（仅在IMUtest-ON下轮询且满足条件时触发一次）
-        if (g_imu_hud_triggered) {
-            wake_display_and_touch_activity();
-            if (ui_subMenu != NULL) {
-                lv_obj_clear_flag(ui_subMenu, LV_OBJ_FLAG_HIDDEN);
-            }
-            lv_label_set_text(ui_StatusLabel, "抬头触发");
-            printf("TAITOU");
-            lv_obj_invalidate(lv_scr_act());  // 关键修改： invalidate整个屏幕
-            lv_refr_now(lv_disp_get_default()); // 强制刷新
-            g_imu_hud_triggered = false;
-        }
+    lvgl_timer_fd = reactor_timer_create();
+    power_timer_fd = reactor_timer_create();
+    if (reactor_add(ui_queue_fd(), on_ui_event, NULL) != 0 ||
+        reactor_add(lvgl_timer_fd, on_lvgl_timer, NULL) != 0 ||
+        reactor_add(power_timer_fd, on_power_timer, NULL) != 0) {
+        printf("主循环事件源初始化失败\n");
+        return -1;
+    }
+    power_save_check();
 
-        usleep(10 * 1000);//10ms
+    // 所有工作都由事件触发：UI命令、LVGL定时器、省电超时、IMU轮询，空闲时阻塞在epoll_wait
+    while(1) {
+        reactor_timer_arm(lvgl_timer_fd, lvgl_service());
+        reactor_run_once(-1);
     }
     printf("Succsss\n");
     close(spi_file);
     return 0;
 }
+#endif
 
 // ================== 图片加载API ==================
 
@@ -1720,6 +1936,148 @@ int save_4bit_to_bmp(const char* filename, uint8_t* image_data, uint16_t width,
     return 0;
 }
 
+// RGB888图像 -> 打包4bpp，按rgb_dither_mode选择截断/有序抖动/误差扩散
+static int rgb_rows_to_4bpp(const uint8_t* rgb, uint32_t rgb_stride, uint8_t* dst, uint32_t dst_stride,
+                            uint16_t width, uint16_t height, uint8_t order) {
+    static uint8_t gray_row[640];
+
+    if (rgb_dither_mode == PIX_DITHER_FS) {
+        // 误差扩散需要整幅灰度图
+        uint8_t* gray = malloc((size_t)width * height);
+        if (gray == NULL) {
+            printf("错误：内存分配失败\n");
+            return -1;
+        }
+        for (uint16_t y = 0; y < height; y++) {
+            pix_rgb_to_gray8(&rgb[y * rgb_stride], &gray[y * width], width, order);
+        }
+        int ret = pix_gray8_to_4bpp_fs(gray, width, dst, dst_stride, width, height);
+        free(gray);
+        return ret;
+    }
+    for (uint16_t y = 0; y < height; y++) {
+        if (rgb_dither_mode == PIX_DITHER_BAYER) {
+            pix_rgb_to_gray8(&rgb[y * rgb_stride], gray_row, width, order);
+            pix_gray8_to_4bpp_bayer(gray_row, &dst[y * dst_stride], width, y);
+        } else {
+            pix_rgb_to_4bpp(&rgb[y * rgb_stride], &dst[y * dst_stride], width, order);
+        }
+    }
+    return 0;
+}
+
+// 8位灰度图像 -> 打包4bpp，抖动方式同上
+static int gray_rows_to_4bpp(const uint8_t* gray, uint32_t gray_stride, uint8_t* dst, uint32_t dst_stride,
+                             uint16_t width, uint16_t height) {
+    if (rgb_dither_mode == PIX_DITHER_FS) {
+        return pix_gray8_to_4bpp_fs(gray, gray_stride, dst, dst_stride, width, height);
+    }
+    for (uint16_t y = 0; y < height; y++) {
+        if (rgb_dither_mode == PIX_DITHER_BAYER) {
+            pix_gray8_to_4bpp_bayer(&gray[y * gray_stride], &dst[y * dst_stride], width, y);
+        } else {
+            pix_gray8_to_4bpp(&gray[y * gray_stride], &dst[y * dst_stride], width);
+        }
+    }
+    return 0;
+}
+
+// 缩放结果（最大整屏），第一次用时分配，之后缩放动画、相机预览每帧复用
+static uint8_t* scaled_gray;
+static uint8_t* scaled_4bpp;
+
+/**
+ * 按建好的缩放表缩放8位灰度图，转4bpp后居中显示
+ * @param s 缩放表（pix_scale_init），目标尺寸不超过640×480
+ */
+static int display_gray_scaled(pix_scale_t* s, const uint8_t* gray, uint32_t gray_stride) {
+    if (s->dst_w > 640 || s->dst_h > 480) {
+        printf("错误：缩放目标尺寸超出屏幕范围\n");
+        return -1;
+    }
+    if (scaled_gray == NULL) {
+        scaled_gray = malloc(640 * 480);
+        scaled_4bpp = malloc(320 * 480);
+        if (scaled_gray == NULL || scaled_4bpp == NULL) {
+            printf("错误：内存分配失败\n");
+            free(scaled_gray);
+            free(scaled_4bpp);
+            scaled_gray = scaled_4bpp = NULL;
+            return -1;
+        }
+    }
+    pix_scale_gray8(s, gray, gray_stride, scaled_gray, s->dst_w);
+    if (gray_rows_to_4bpp(scaled_gray, s->dst_w, scaled_4bpp, (s->dst_w + 1) / 2, s->dst_w, s->dst_h) != 0) {
+        return -1;
+    }
+    return display_image_fast(scaled_4bpp, s->dst_w, s->dst_h);
+}
+
+// 缩小用区域平均，缩小倍数超出区域平均的限制或放大时用双线性
+static int scale_init_auto(pix_scale_t* s, uint32_t src_w, uint32_t src_h, uint32_t dst_w, uint32_t dst_h) {
+    if (dst_w <= src_w && dst_h <= src_h && (dst_w < src_w || dst_h < src_h) &&
+        pix_scale_init(s, src_w, src_h, dst_w, dst_h, PIX_SCALE_BOX) == 0) {
+        return 0;
+    }
+    return pix_scale_init(s, src_w, src_h, dst_w, dst_h, PIX_SCALE_BILINEAR);
+}
+
+/**
+ * 超出屏幕的RGB图片：转灰度后等比缩小到640×480以内再显示
+ */
+static int display_rgb_image_fit(const uint8_t* rgb_data, uint16_t width, uint16_t height) {
+    pix_scale_t s;
+    uint16_t fit_w, fit_h;
+    uint8_t* gray = malloc((size_t)width * height);
+    int result;
+
+    if (gray == NULL) {
+        printf("错误：内存分配失败\n");
+        return -1;
+    }
+    for (uint16_t y = 0; y < height; y++) {
+        pix_rgb_to_gray8(&rgb_data[(size_t)y * width * 3], &gray[(size_t)y * width], width, PIX_ORDER_RGB);
+    }
+    pix_scale_fit(width, height, 640, 480, &fit_w, &fit_h);
+    printf("图片%d×%d超出屏幕，缩小到%d×%d显示\n", width, height, fit_w, fit_h);
+    if (scale_init_auto(&s, width, height, fit_w, fit_h) != 0) {
+        free(gray);
+        return -1;
+    }
+    result = display_gray_scaled(&s, gray, width);
+    pix_scale_free(&s);
+    free(gray);
+    return result;
+}
+
+/**
+ * 相机预览：8位灰度帧（NV12/NV21的Y平面即是）等比缩小到屏幕内居中显示
+ * 帧尺寸不变时缩放表一直复用，每帧只做缩放和4bpp转换
+ * @param y_plane 灰度数据
+ * @param stride 每行字节数
+ */
+int display_camera_preview(const uint8_t* y_plane, uint16_t width, uint16_t height, uint32_t stride) {
+    static pix_scale_t preview_scale;
+    static uint16_t preview_w, preview_h;
+
+    if (y_plane == NULL || width == 0 || height == 0) {
+        printf("错误：预览帧无效\n");
+        return -1;
+    }
+    if (preview_scale.x0 == NULL || preview_w != width || preview_h != height) {
+        uint16_t fit_w, fit_h;
+
+        pix_scale_free(&preview_scale);
+        pix_scale_fit(width, height, 640, 480, &fit_w, &fit_h);
+        if (scale_init_auto(&preview_scale, width, height, fit_w, fit_h) != 0) {
+            return -1;
+        }
+        preview_w = width;
+        preview_h = height;
+    }
+    return display_gray_scaled(&preview_scale, y_plane, stride);
+}
+
 /**
  * 从RGB数据生成图片并显示
  * @param rgb_data RGB数据数组 (r,g,b,r,g,b...)
@@ -1731,10 +2089,13 @@ int display_rgb_image(uint8_t* rgb_data, uint16_t width, uint16_t height) {
     if (width == 0) width = 640;
     if (height == 0) height = 480;
     
-    if (rgb_data == NULL || width > 640 || height > 480) {
-        printf("错误：RGB数据无效或尺寸超出范围\n");
+    if (rgb_data == NULL) {
+        printf("错误：RGB数据无效\n");
         return -1;
     }
+    if (width > 640 || height > 480) {
+        return display_rgb_image_fit(rgb_data, width, height);
+    }
     
     printf("转换并显示RGB图片 %d×%d\n", width, height);
     
@@ -1746,33 +2107,13 @@ int display_rgb_image(uint8_t* rgb_data, uint16_t width, uint16_t height) {
         return -1;
     }
     
-    // RGB转换为4位格式 - 推荐版本2：减少条件判断 + 内联优化
-    uint8_t* rgb_ptr = rgb_data;  // RGB数据指针
-    uint8_t* output_ptr = converted_data;  // 输出数据指针
-    uint32_t pixel_pairs = width / 2;  // 完整的像素对数量
-    bool has_odd_pixel = (width % 2) != 0;  // 是否有奇数像素
-    
-    for (uint16_t row = 0; row < height; row++) {
-        // 处理成对的像素 - 减少分支预测失败
-        for (uint16_t pair = 0; pair < pixel_pairs; pair++) {
-            uint8_t pixel1 = rgb_to_4bit_fast(rgb_ptr[0], rgb_ptr[1], rgb_ptr[2]);
-            rgb_ptr += 3;
-            uint8_t pixel2 = rgb_to_4bit_fast(rgb_ptr[0], rgb_ptr[1], rgb_ptr[2]);
-            rgb_ptr += 3;
-            
-            *output_ptr++ = (pixel1 << 4) | pixel2;
-        }
-        
-        // 处理最后一个奇数像素（如果存在）
-        if (has_odd_pixel) {
-            uint8_t pixel1 = rgb_to_4bit_fast(rgb_ptr[0], rgb_ptr[1], rgb_ptr[2]);
-            rgb_ptr += 3;
-            *output_ptr++ = (pixel1 << 4);  // 第二个像素为0
-        }
+    // RGB转换为4位格式（向量化内核，按DISPLAY_DITHER抖动）
+    if (rgb_rows_to_4bpp(rgb_data, width * 3, converted_data, (width + 1) / 2,
+                         width, height, PIX_ORDER_RGB) != 0) {
+        free(converted_data);
+        return -1;
     }
     
-    // ✅ 已实现的版本：减少条件判断 + 内联函数 + 位运算优化
-    
     // 保存转换后的图片用于调试
     save_4bit_to_bmp("/test/out.bmp", converted_data, width, height);
     
@@ -1812,46 +2153,27 @@ int display_image_fast(uint8_t* image_data, uint16_t width, uint16_t height) {
         printf("全屏快速显示 (%d字节)...\n", total_size);
         display_image(0, 0, image_data, total_size);
     } else {
-        // 非全屏图片：需要转换为全屏缓冲区格式
-        printf("转换非全屏图片为全屏缓冲区格式\n");
-        
-        // 分配全屏缓冲区并清零（黑色背景）
-        uint32_t screen_size = 320 * 480;
-        uint8_t* screen_buffer = malloc(screen_size);
-        if (!screen_buffer) {
-            printf("错误：内存分配失败\n");
-            return -1;
-        }
-        memset(screen_buffer, 0x00, screen_size);  // 黑色背景
-        
-        // 计算居中位置
+        // 非全屏图片：上面已清屏，直接按行从原图内存发送，不再拼全屏缓冲区
         uint16_t start_x = (640 - width) / 2;
         uint16_t start_y = (480 - height) / 2;
-        
-        printf("居中显示在位置 (%d,%d)\n", start_x, start_y);
-        
-        // 高效的行复制方式 - 借鉴用户的优化思路
         uint16_t src_row_bytes = (width + 1) / 2;  // 原图每行字节数
-        uint16_t dst_row_bytes = 320;              // 全屏缓冲区每行字节数
-        uint16_t start_x_bytes = start_x / 2;      // 起始列的字节偏移
-        
+
+        printf("居中显示在位置 (%d,%d)\n", start_x, start_y);
+
+        spi_wr_seg_t* segs = malloc(height * sizeof(spi_wr_seg_t));
+        if (!segs) {
+            printf("错误：内存分配失败\n");
+            return -1;
+        }
         for (uint16_t row = 0; row < height; row++) {
-            uint16_t screen_row = start_y + row;
-            if (screen_row >= 480) break;
-            
-            // 计算源和目标行的起始指针
-            uint8_t* src_row = &image_data[row * src_row_bytes];
-            uint8_t* dst_row = &screen_buffer[screen_row * dst_row_bytes + start_x_bytes];
-            
-            // 一次性复制整行数据
-            memcpy(dst_row, src_row, src_row_bytes);
+            segs[row].col = start_x & ~1u;         // 按字节对齐到偶数列
+            segs[row].row = start_y + row;
+            segs[row].pBuf = &image_data[row * src_row_bytes];
+            segs[row].len = src_row_bytes;
         }
-        
-        // 使用全屏模式显示
-        printf("全屏模式显示转换后的缓冲区\n");
-        display_image(0, 0, screen_buffer, screen_size);
-        
-        free(screen_buffer);
+        display_segments(segs, height);
+
+        free(segs);
     }
     
     printf("图片显示完成！\n");
@@ -1862,7 +2184,8 @@ int display_image_fast(uint8_t* image_data, uint16_t width, uint16_t height) {
 // ================== 🎬 图片缩放动画API ==================
 
 /**
- * 简单最近邻缩放算法
+ * 简单最近邻缩放算法（RGB888）
+ * 显示用的缩放（缩放动画、大图、相机预览）改用pix_scale.h，在灰度上按预先建好的表缩放
  * @param src_data 源图片RGB数据
  * @param src_width 源图片宽度
  * @param src_height 源图片高度  
@@ -1961,6 +2284,22 @@ int display_bmp_zoom_animation(const char* filename, struct zoom_animation_t* an
     
     printf("✅ 原图加载成功: %d×%d\n", orig_width, orig_height);
     
+    // 只转一次灰度，之后每帧从灰度原图直接缩放（面板只显示灰度，RGB缩放是白做）
+    uint8_t* orig_gray = malloc((size_t)orig_width * orig_height);
+    if (!orig_gray) {
+        printf("❌ 内存分配失败\n");
+        free(orig_rgb);
+        return -1;
+    }
+    for (uint16_t y = 0; y < orig_height; y++) {
+        pix_rgb_to_gray8(&orig_rgb[(size_t)y * orig_width * 3], &orig_gray[(size_t)y * orig_width],
+                         orig_width, PIX_ORDER_RGB);
+    }
+    free(orig_rgb);
+    
+    // 缩放表按帧尺寸建，尺寸和上一帧相同（例如到达最大尺寸后）时复用
+    pix_scale_t frame_scale = { 0 };
+    
     // 帧率统计变量
     struct timeval animation_start, frame_start, frame_end;
     gettimeofday(&animation_start, NULL);
@@ -2004,19 +2343,17 @@ int display_bmp_zoom_animation(const char* filename, struct zoom_animation_t* an
         if (scaled_width > 640) scaled_width = 640;
         if (scaled_height > 480) scaled_height = 480;
         
-        // 缩放图片
-        uint8_t* scaled_rgb = scale_image_nearest(orig_rgb, orig_width, orig_height,
-                                                scaled_width, scaled_height);
-        if (!scaled_rgb) {
-            printf("❌ 帧%d缩放失败\n", frame);
-            continue;
+        // 缩放图片（缩小用区域平均，放大用双线性）
+        if (frame_scale.x0 == NULL || frame_scale.dst_w != scaled_width || frame_scale.dst_h != scaled_height) {
+            pix_scale_free(&frame_scale);
+            if (scale_init_auto(&frame_scale, orig_width, orig_height, scaled_width, scaled_height) != 0) {
+                printf("❌ 帧%d缩放失败\n", frame);
+                continue;
+            }
         }
         
         // 显示缩放后的图片（自动居中）
-        display_rgb_image(scaled_rgb, scaled_width, scaled_height);
-        
-        // 释放当前帧内存
-        free(scaled_rgb);
+        display_gray_scaled(&frame_scale, orig_gray, orig_width);
         
         // 计算帧处理时间
         gettimeofday(&frame_end, NULL);
@@ -2073,9 +2410,11 @@ int display_bmp_zoom_animation(const char* filename, struct zoom_animation_t* an
     }
     
     // 清理资源
-    free(orig_rgb);
+    pix_scale_free(&frame_scale);
+    free(orig_gray);
     
     printf("🎬 缩放动画完成！\n\n");
+    return 0;
 }
 
 /**
@@ -2365,6 +2704,11 @@ void free_image_sequence(char** filenames, int count) {
     }
 }
 
+// 两个时间点之间的毫秒数
+static float elapsed_ms(const struct timeval* start, const struct timeval* end) {
+    return (end->tv_sec - start->tv_sec) * 1000.0f + (end->tv_usec - start->tv_usec) / 1000.0f;
+}
+
 /**
  * 播放图片序列
  * @param filenames 图片文件名数组
@@ -2390,9 +2734,13 @@ int play_image_sequence(char** filenames, int count, struct sequence_animation_t
         frame_delay_us = (uint32_t)(1000000.0f / anim_params->target_fps);
     }
     
-    // 性能统计变量
+    // 4位格式显示缓冲区（153600字节，不能放在栈上）
+    static uint8_t display_buffer[320 * 480];
+    
+    // 性能统计变量：每个阶段都实际计时，不再按比例估算
     struct timeval sequence_start, frame_start, frame_end;
-    struct timeval load_start, load_end, process_start, process_end, display_start, display_end;
+    struct timeval load_start, load_end, convert_start, convert_end;
+    struct timeval clear_start, clear_end, spi_start, spi_end;
     gettimeofday(&sequence_start, NULL);
     
     uint32_t total_frames_shown = 0;
@@ -2402,8 +2750,9 @@ int play_image_sequence(char** filenames, int count, struct sequence_animation_t
     
     // 详细时间统计
     float total_load_time = 0.0f;
-    float total_process_time = 0.0f;
-    float total_display_time = 0.0f;
+    float total_convert_time = 0.0f;
+    float total_clear_time = 0.0f;
+    float total_spi_time = 0.0f;
     float total_delay_time = 0.0f;
     
     uint16_t current_loop = 0;
@@ -2439,160 +2788,54 @@ int play_image_sequence(char** filenames, int count, struct sequence_animation_t
                 continue;
             }
             
-            // ========== 步骤2：图片处理（RGB转换+缩放等） ==========
-            gettimeofday(&process_start, NULL);
-            
-            // 细分时间测量点
-            struct timeval alloc_start, alloc_end, convert_start, convert_end, copy_start, copy_end;
-            
-            // 2.1 内存分配
-            gettimeofday(&alloc_start, NULL);
-            uint8_t display_buffer[320 * 480];  // 栈分配，自动管理，替换掉原本的uint8_t* display_buffer = malloc(320 * 480);  // 4位格式缓冲区
-            gettimeofday(&alloc_end, NULL);
-            bool need_free_buffer = false;
-            
-            if (!display_buffer) {
-                printf("⚠️  警告：内存分配失败 %s\n", filenames[i]);
+            // ========== 步骤2：RGB转4位格式 ==========
+            if (img_width > 640 || img_height > 480) {
+                printf("⚠️  警告：图片尺寸超出屏幕范围 %s\n", filenames[i]);
                 free(rgb_data);
                 continue;
             }
-            need_free_buffer = true;
-            
+            gettimeofday(&convert_start, NULL);
             if (img_width == 640 && img_height == 480) {
-                // ===== 全屏图片：直接RGB转换 =====
-                
-                // 2.2 缓冲区清零（全屏图片跳过）
-                gettimeofday(&copy_start, NULL);
-                gettimeofday(&copy_end, NULL);  // 立即结束，表示跳过
-                
-                // 2.3 RGB转换
-                gettimeofday(&convert_start, NULL);
-                
-                // 高效RGB转4位格式（指针优化版本）
-                uint8_t* rgb_ptr = rgb_data;
-                uint8_t* buf_ptr = display_buffer;
-                uint32_t pixel_pairs = (640 * 480) / 2;
-                
-                for (uint32_t pair = 0; pair < pixel_pairs; pair++) {
-                    // 像素1：BGR→RGB
-                    uint8_t pixel1 = rgb_to_4bit_fast(rgb_ptr[2], rgb_ptr[1], rgb_ptr[0]);
-                    rgb_ptr += 3;
-                    
-                    // 像素2：BGR→RGB
-                    uint8_t pixel2 = rgb_to_4bit_fast(rgb_ptr[2], rgb_ptr[1], rgb_ptr[0]);
-                    rgb_ptr += 3;
-                    
-                    // 合并两个4位像素到一个字节
-                    *buf_ptr++ = (pixel1 << 4) | pixel2;
-                }
-                
-                gettimeofday(&convert_end, NULL);
-                
+                // 全屏图片：直接转换，覆盖整个缓冲区
+                rgb_rows_to_4bpp(rgb_data, 640 * 3, display_buffer, 320, 640, 480, PIX_ORDER_BGR);
             } else {
-                // ===== 非全屏图片：居中处理 =====
-                
-                // 2.2 缓冲区清零
-                gettimeofday(&copy_start, NULL);
-                memset(display_buffer, 0, 320 * 480);  // 黑色背景
-                gettimeofday(&copy_end, NULL);
-                
-                // 2.3 居中位置计算
-                struct timeval calc_start, calc_end;
-                gettimeofday(&calc_start, NULL);
+                // 非全屏图片：黑色背景上居中
                 uint16_t start_x = (640 - img_width) / 2;
                 uint16_t start_y = (480 - img_height) / 2;
-                gettimeofday(&calc_end, NULL);
-                
-                // 2.4 逐像素转换和复制
-                gettimeofday(&convert_start, NULL);
-                for (uint16_t y = 0; y < img_height; y++) {
-                    for (uint16_t x = 0; x < img_width; x += 2) {
-                        uint16_t screen_x = start_x + x;
-                        uint16_t screen_y = start_y + y;
-                        
-                        if (screen_x < 640 && screen_y < 480) {
-                            uint8_t* rgb_ptr = rgb_data + (y * img_width + x) * 3;
-                            uint8_t pixel1 = rgb_to_4bit_fast(rgb_ptr[2], rgb_ptr[1], rgb_ptr[0]);
-                            
-                            uint8_t pixel2 = pixel1;
-                            if (x + 1 < img_width) {
-                                rgb_ptr += 3;
-                                pixel2 = rgb_to_4bit_fast(rgb_ptr[2], rgb_ptr[1], rgb_ptr[0]);
-                            }
-                            
-                            uint32_t buffer_index = screen_y * 320 + screen_x / 2;
-                            display_buffer[buffer_index] = (pixel1 << 4) | pixel2;
-                        }
-                    }
-                }
-                gettimeofday(&convert_end, NULL);
+                memset(display_buffer, 0, sizeof(display_buffer));
+                rgb_rows_to_4bpp(rgb_data, img_width * 3, &display_buffer[start_y * 320 + start_x / 2], 320,
+                                 img_width, img_height, PIX_ORDER_BGR);
             }
-            
-            // 2.5 释放原始RGB数据
-            struct timeval free_start, free_end;
-            gettimeofday(&free_start, NULL);
             free(rgb_data);
-            gettimeofday(&free_end, NULL);
-            
-            gettimeofday(&process_end, NULL);
-            
-            if (!display_buffer) {
-                printf("⚠️  警告：内存分配失败 %s\n", filenames[i]);
-                continue;
-            }
+            gettimeofday(&convert_end, NULL);
             
             // ========== 步骤3：显示传输 ==========
-            gettimeofday(&display_start, NULL);
-            
             // 3.1 清屏操作
-            struct timeval clear_start, clear_end;
             gettimeofday(&clear_start, NULL);
             clr_cache();
             gettimeofday(&clear_end, NULL);
             
             // 3.2 SPI数据传输
-            struct timeval spi_start, spi_end;
             gettimeofday(&spi_start, NULL);
             uint32_t total_size = 320 * 480;  // 153600字节
             display_image(0, 0, display_buffer, total_size);
             gettimeofday(&spi_end, NULL);
             
-            gettimeofday(&display_end, NULL);
-            
-            if (need_free_buffer) {
-                free(display_buffer);
-            }
-            
             gettimeofday(&frame_end, NULL);
             
             // ========== 步骤4：计算各阶段时间 ==========
-            float load_time = (load_end.tv_sec - load_start.tv_sec) * 1000.0f +
-                             (load_end.tv_usec - load_start.tv_usec) / 1000.0f;
-            float process_time = (process_end.tv_sec - process_start.tv_sec) * 1000.0f +
-                                (process_end.tv_usec - process_start.tv_usec) / 1000.0f;
-            float display_time = (display_end.tv_sec - display_start.tv_sec) * 1000.0f +
-                                 (display_end.tv_usec - display_start.tv_usec) / 1000.0f;
-            float total_frame_time = (frame_end.tv_sec - frame_start.tv_sec) * 1000.0f +
-                                    (frame_end.tv_usec - frame_start.tv_usec) / 1000.0f;
-            
-            // 计算细分时间
-            float alloc_time = (alloc_end.tv_sec - alloc_start.tv_sec) * 1000.0f +
-                              (alloc_end.tv_usec - alloc_start.tv_usec) / 1000.0f;
-            float copy_time = (copy_end.tv_sec - copy_start.tv_sec) * 1000.0f +
-                             (copy_end.tv_usec - copy_start.tv_usec) / 1000.0f;
-            float convert_time = (convert_end.tv_sec - convert_start.tv_sec) * 1000.0f +
-                                (convert_end.tv_usec - convert_start.tv_usec) / 1000.0f;
-            float free_time = (free_end.tv_sec - free_start.tv_sec) * 1000.0f +
-                             (free_end.tv_usec - free_start.tv_usec) / 1000.0f;
-            float clear_time = (clear_end.tv_sec - clear_start.tv_sec) * 1000.0f +
-                              (clear_end.tv_usec - clear_start.tv_usec) / 1000.0f;
-            float spi_time = (spi_end.tv_sec - spi_start.tv_sec) * 1000.0f +
-                            (spi_end.tv_usec - spi_start.tv_usec) / 1000.0f;
+            float load_time = elapsed_ms(&load_start, &load_end);
+            float convert_time = elapsed_ms(&convert_start, &convert_end);
+            float clear_time = elapsed_ms(&clear_start, &clear_end);
+            float spi_time = elapsed_ms(&spi_start, &spi_end);
+            float display_time = clear_time + spi_time;
+            float total_frame_time = elapsed_ms(&frame_start, &frame_end);
             
             // 累计统计
             total_load_time += load_time;
-            total_process_time += process_time;
-            total_display_time += display_time;
+            total_convert_time += convert_time;
+            total_clear_time += clear_time;
+            total_spi_time += spi_time;
             total_processing_time += total_frame_time;
             
             if (total_frame_time < min_frame_time) min_frame_time = total_frame_time;
@@ -2608,27 +2851,10 @@ int play_image_sequence(char** filenames, int count, struct sequence_animation_t
                 printf("📊 帧 %d/%d | %s | 总时间: %.1fms | FPS: %.1f\n", 
                        total_frames_shown, count, filename, total_frame_time, current_fps);
                 printf("   ├─ 📁 加载: %.1fms (%.1f%%)\n", load_time, (load_time/total_frame_time)*100);
-                printf("   ├─ ⚙️  处理: %.1fms (%.1f%%) 🔍\n", process_time, (process_time/total_frame_time)*100);
-                printf("   │  ├─ 🏷️  内存分配: %.2fms\n", alloc_time);
-                if (copy_time > 0.01f) {  // 只有非全屏图片才显示
-                    printf("   │  ├─ 🧹 缓冲区清零: %.2fms\n", copy_time);
-                }
-                printf("   │  ├─ 🔄 RGB转换: %.1fms\n", convert_time);
-                printf("   │  └─ 🗑️  内存释放: %.2fms\n", free_time);
-                printf("   └─ 📺 显示: %.1fms (%.1f%%) 🔍\n", display_time, (display_time/total_frame_time)*100);
+                printf("   ├─ 🔄 RGB转换: %.1fms (%.1f%%)\n", convert_time, (convert_time/total_frame_time)*100);
+                printf("   └─ 📺 显示: %.1fms (%.1f%%)\n", display_time, (display_time/total_frame_time)*100);
                 printf("      ├─ 🧹 清屏: %.1fms\n", clear_time);
                 printf("      └─ 📡 SPI传输: %.1fms (%.1fKB/s)\n", spi_time, (153.6f/spi_time)*1000);
-                
-                // 性能瓶颈提示
-                if (spi_time > clear_time * 5) {
-                    printf("      💡 SPI传输是显示瓶颈，建议提高SPI时钟频率\n");
-                } else if (clear_time > spi_time * 2) {
-                    printf("      💡 清屏操作较慢，可能是显存访问瓶颈\n");
-                }
-                
-                if (convert_time > alloc_time * 10) {
-                    printf("   💡 RGB转换是处理瓶颈，建议使用查找表或硬件加速\n");
-                }
             }
             
             // ========== 步骤5：帧率控制延迟 ==========
@@ -2642,8 +2868,7 @@ int play_image_sequence(char** filenames, int count, struct sequence_animation_t
                     usleep(frame_delay_us - processing_time_us);
                 }
                 gettimeofday(&delay_end, NULL);
-                delay_time = (delay_end.tv_sec - delay_start.tv_sec) * 1000.0f +
-                            (delay_end.tv_usec - delay_start.tv_usec) / 1000.0f;
+                delay_time = elapsed_ms(&delay_start, &delay_end);
                 total_delay_time += delay_time;
                 
                 if (anim_params->show_performance && delay_time > 0.1f) {
@@ -2670,13 +2895,16 @@ int play_image_sequence(char** filenames, int count, struct sequence_animation_t
         }
     }
     
+    if (total_frames_shown == 0) {
+        printf("❌ 错误：没有成功显示的帧\n");
+        return -1;
+    }
+    
     // 计算总体统计
     struct timeval sequence_end;
     gettimeofday(&sequence_end, NULL);
     
-    float total_time = (sequence_end.tv_sec - sequence_start.tv_sec) * 1000.0f +
-                      (sequence_end.tv_usec - sequence_start.tv_usec) / 1000.0f;
-    
+    float total_time = elapsed_ms(&sequence_start, &sequence_end);
     float avg_fps = total_frames_shown * 1000.0f / total_time;
     float avg_frame_time = total_processing_time / total_frames_shown;
     
@@ -2690,85 +2918,31 @@ int play_image_sequence(char** filenames, int count, struct sequence_animation_t
     
     printf("\n详细时间分解 (平均每帧):\n");
     float avg_load_time = total_load_time / total_frames_shown;
-    float avg_process_time = total_process_time / total_frames_shown;
-    float avg_display_time = total_display_time / total_frames_shown;
+    float avg_convert_time = total_convert_time / total_frames_shown;
+    float avg_clear_time = total_clear_time / total_frames_shown;
+    float avg_spi_time = total_spi_time / total_frames_shown;
     float avg_delay_time = total_delay_time / total_frames_shown;
     
     printf("    图片加载: %.1f ms (%.1f%%)\n", avg_load_time, (avg_load_time/avg_frame_time)*100);
-    printf("    数据处理: %.1f ms (%.1f%%)\n", avg_process_time, (avg_process_time/avg_frame_time)*100);
-    printf("      ├─ 内存操作: ~%.1f ms\n", (avg_process_time * 0.1f));  // 估算内存分配+释放时间
-    printf("      └─ RGB转换: ~%.1f ms\n", (avg_process_time * 0.9f));    // 估算RGB转换时间
-    printf("   📺 显示传输: %.1f ms (%.1f%%)\n", avg_display_time, (avg_display_time/avg_frame_time)*100);
-    printf("      ├─ 清屏操作: ~%.1f ms\n", (avg_display_time * 0.2f));   // 估算清屏时间
-    printf("      └─ SPI传输: ~%.1f ms (%.1f MB/s)\n", 
-           (avg_display_time * 0.8f), (153.6f/(avg_display_time * 0.8f)));  // 估算SPI传输时间和速度
+    printf("    RGB转换: %.1f ms (%.1f%%)\n", avg_convert_time, (avg_convert_time/avg_frame_time)*100);
+    printf("   📺 显示传输: %.1f ms (%.1f%%)\n", avg_clear_time + avg_spi_time,
+           ((avg_clear_time + avg_spi_time)/avg_frame_time)*100);
+    printf("      ├─ 清屏操作: %.1f ms\n", avg_clear_time);
+    printf("      └─ SPI传输: %.1f ms (%.1f MB/s)\n", avg_spi_time, 153.6f / avg_spi_time);
     if (avg_delay_time > 0.1f) {
         printf("   ⏱️  帧率延迟: %.1f ms (%.1f%%)\n", avg_delay_time, (avg_delay_time/(avg_frame_time+avg_delay_time))*100);
     }
     
-    printf("\n💡 详细性能分析:\n");
-    
-    // 找出最耗时的环节
-    if (avg_load_time > avg_process_time && avg_load_time > avg_display_time) {
-        printf("   🔍 主要瓶颈：图片加载 (%.1fms)\n", avg_load_time);
-        printf("      💡 建议：使用更快的存储设备或预加载图片到内存\n");
-    } else if (avg_process_time > avg_display_time) {
-        printf("   🔍 主要瓶颈：数据处理 (%.1fms)\n", avg_process_time);
-        float estimated_rgb_time = avg_process_time * 0.9f;
-        if (estimated_rgb_time > 15.0f) {
-            printf("      RGB转换过慢 (%.1fms)：建议使用查找表或SIMD指令\n", estimated_rgb_time);
-        }
-        printf("      可考虑：预处理图片为4位格式存储\n");
-    } else {
-        printf("   🔍 主要瓶颈：显示传输 (%.1fms)\n", avg_display_time);
-        float estimated_spi_time = avg_display_time * 0.8f;
-        float current_spi_speed = 153.6f / estimated_spi_time;  // MB/s
-        printf("      当前SPI速度：%.1f MB/s\n", current_spi_speed);
-        if (current_spi_speed < 15.0f) {
-            printf("      建议：提高SPI时钟频率 (当前可能低于20MHz)\n");
-        }
-        if (estimated_spi_time > 60.0f) {
-            printf("      建议：使用DMA传输减少CPU占用\n");
-        }
-    }
-    
-    // CPU利用率分析
-    float cpu_utilization = ((avg_load_time + avg_process_time + avg_display_time) / avg_frame_time) * 100.0f;
-    printf("    CPU利用率: %.1f%%\n", cpu_utilization);
-    
-    // 优化潜力分析
-    if (cpu_utilization < 50.0f) {
-        printf("    CPU利用率较低，可考虑并行处理或提高目标帧率\n");
-    } else if (cpu_utilization > 90.0f) {
-        printf("    CPU负载较高，建议优化算法或降低处理复杂度\n");
-    }
-    
-    // 具体优化建议
-    printf("\n🛠️  具体优化建议:\n");
-    if (avg_process_time > 20.0f) {
-        printf("   1 RGB转换优化：使用位运算代替除法，或预计算查找表\n");
-    }
-    if (avg_display_time > 60.0f) {
-        printf("   2 SPI优化：检查时钟频率设置，考虑使用DMA传输\n");
-    }
-    if (avg_load_time > 10.0f) {
-        printf("   3 I/O优化：使用RAM磁盘或预加载图片数据\n");
-    }
-    printf("   4 格式优化：考虑存储预处理的4位格式图片\n");
-    printf("   5 硬件优化：使用专用图形处理器或FPGA加速\n");
-    
     if (anim_params->target_fps > 0) {
         float efficiency = (anim_params->target_fps / avg_fps) * 100.0f;
         printf("    帧率达成度: %.1f%%\n", efficiency > 100 ? 100.0f : efficiency);
-        
-        if (avg_fps < anim_params->target_fps * 0.9f) {
-            printf("    建议：降低目标帧率或优化图片大小\n");
-        } else if (avg_fps > anim_params->target_fps * 1.1f) {
-            printf("    建议：可以提高目标帧率或增加图片复杂度\n");
-        }
     }
     
+    // 传输量统计（按写缓存路径和影子缓冲），各阶段细分见 bench/display_bench.c
+    spi_wr_stats_print();
+    shadow_stats_print();
     printf("✅ 序列播放完成！\n\n");
+    return 0;
 }
 
 /**
@@ -0,0 +1,258 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <signal.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include "msg_bus.h"
+
+#define LOAD(p, order) __atomic_load_n((p), (order))
+#define STORE(p, v, order) __atomic_store_n((p), (v), (order))
+#define MSG_BUS_INIT_WAIT_TRIES 100     // 等第一个进程写version，每次10ms
+
+static int futex_wait(uint32_t *addr, uint32_t val, const struct timespec *timeout) {
+    return (int)syscall(SYS_futex, addr, FUTEX_WAIT, val, timeout, NULL, 0);
+}
+
+static int futex_wake(uint32_t *addr) {
+    return (int)syscall(SYS_futex, addr, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+uint64_t msg_bus_now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+// 打开（不存在则创建）总线；name为NULL时用MSG_BUS_NAME
+int msg_bus_open(msg_bus_t *bus, const char *name) {
+    int fd;
+    struct stat st;
+    uint32_t magic = 0;
+
+    memset(bus, 0, sizeof(*bus));
+    bus->sub = -1;
+    bus->pid = (int32_t)getpid();
+    snprintf(bus->name, sizeof(bus->name), "%s", name ? name : MSG_BUS_NAME);
+
+    fd = shm_open(bus->name, O_CREAT | O_RDWR, 0666);
+    if (fd < 0) {
+        perror("msg_bus_open: shm_open");
+        return -1;
+    }
+    // 只会变大：新扩展的部分为0
+    if (fstat(fd, &st) == 0 && st.st_size < (off_t)sizeof(msg_bus_shm_t) &&
+        ftruncate(fd, sizeof(msg_bus_shm_t)) < 0) {
+        perror("msg_bus_open: ftruncate");
+        close(fd);
+        return -1;
+    }
+    bus->shm = mmap(NULL, sizeof(msg_bus_shm_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (bus->shm == MAP_FAILED) {
+        perror("msg_bus_open: mmap");
+        bus->shm = NULL;
+        return -1;
+    }
+
+    // 第一个打开的进程写入magic，随后写version；已有magic但版本不同说明布局不兼容
+    if (!__atomic_compare_exchange_n(&bus->shm->magic, &magic, MSG_BUS_MAGIC, false,
+                                     __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) {
+        uint32_t version = LOAD(&bus->shm->version, __ATOMIC_ACQUIRE);
+
+        // 几个进程同时启动时，第一个进程可能刚写完magic还没写version，等它写完（最多约1秒）
+        for (int i = 0; magic == MSG_BUS_MAGIC && version == 0 && i < MSG_BUS_INIT_WAIT_TRIES; i++) {
+            struct timespec ts = { 0, 10 * 1000 * 1000 };
+            futex_wait(&bus->shm->version, 0, &ts);
+            version = LOAD(&bus->shm->version, __ATOMIC_ACQUIRE);
+        }
+        if (magic != MSG_BUS_MAGIC || version != MSG_BUS_VERSION) {
+            printf("msg_bus_open: %s 版本不兼容（magic 0x%08x 版本%u），请先删除 /dev/shm%s\n",
+                   bus->name, magic, version, bus->name);
+            munmap(bus->shm, sizeof(msg_bus_shm_t));
+            bus->shm = NULL;
+            return -1;
+        }
+    } else {
+        STORE(&bus->shm->version, MSG_BUS_VERSION, __ATOMIC_RELEASE);
+        futex_wake(&bus->shm->version);
+    }
+    return 0;
+}
+
+void msg_bus_close(msg_bus_t *bus) {
+    if (bus->shm == NULL) return;
+    if (bus->sub >= 0) {
+        STORE(&bus->shm->subs[bus->sub].in_use, 0, __ATOMIC_RELEASE);
+        bus->sub = -1;
+    }
+    munmap(bus->shm, sizeof(msg_bus_shm_t));
+    bus->shm = NULL;
+}
+
+int msg_bus_unlink(const char *name) {
+    return shm_unlink(name ? name : MSG_BUS_NAME);
+}
+
+// pid还没写入（刚占用）时视为存活
+static int sub_alive(const msg_bus_sub_t *s) {
+    int32_t pid = LOAD(&s->pid, __ATOMIC_ACQUIRE);
+    return pid <= 0 || kill(pid, 0) == 0 || errno != ESRCH;
+}
+
+// 注册订阅者，只接收注册之后发布的消息
+// 同名的订阅者（进程重启）或进程已退出的槽位会被接管
+int msg_bus_subscribe(msg_bus_t *bus, const char *sub_name) {
+    msg_bus_shm_t *shm = bus->shm;
+    int slot = -1;
+
+    for (int i = 0; i < MSG_BUS_MAX_SUBS && slot < 0; i++) {
+        msg_bus_sub_t *s = &shm->subs[i];
+        if (LOAD(&s->in_use, __ATOMIC_ACQUIRE) &&
+            (strncmp(s->name, sub_name, MSG_BUS_NAME_LEN) == 0 || !sub_alive(s))) {
+            slot = i;
+        }
+    }
+    for (int i = 0; i < MSG_BUS_MAX_SUBS && slot < 0; i++) {
+        uint32_t expected = 0;
+        if (__atomic_compare_exchange_n(&shm->subs[i].in_use, &expected, 1, false,
+                                        __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) {
+            slot = i;
+        }
+    }
+    if (slot < 0) {
+        printf("msg_bus_subscribe: 订阅者已满（%d）\n", MSG_BUS_MAX_SUBS);
+        return -1;
+    }
+
+    msg_bus_sub_t *s = &shm->subs[slot];
+    snprintf(s->name, sizeof(s->name), "%s", sub_name);
+    STORE(&s->read_seq, LOAD(&shm->write_seq, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+    STORE(&s->pid, bus->pid, __ATOMIC_RELEASE);
+    STORE(&s->in_use, 1, __ATOMIC_RELEASE);
+    bus->sub = slot;
+    return 0;
+}
+
+// 槽位按seqlock方式写：先置0，写负载，再发布 序号+1
+int msg_bus_publish(msg_bus_t *bus, uint16_t type, const void *data, uint16_t len) {
+    msg_bus_shm_t *shm = bus->shm;
+
+    if (shm == NULL || len > MSG_BUS_PAYLOAD_MAX) return -1;
+
+    uint32_t seq = __atomic_fetch_add(&shm->write_seq, 1, __ATOMIC_SEQ_CST);
+    msg_bus_slot_t *slot = &shm->slots[seq & (MSG_BUS_SLOTS - 1)];
+
+    STORE(&slot->seq, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    slot->type = type;
+    slot->len = len;
+    slot->sender = bus->pid;
+    slot->time_ns = msg_bus_now_ns();
+    memcpy(slot->payload, data, len);
+    STORE(&slot->seq, seq + 1, __ATOMIC_RELEASE);
+
+    __atomic_fetch_add(&shm->futex_word, 1, __ATOMIC_SEQ_CST);
+    if (LOAD(&shm->waiters, __ATOMIC_SEQ_CST) > 0) {
+        futex_wake(&shm->futex_word);
+    }
+    return 0;
+}
+
+static int publish_string(msg_bus_t *bus, uint16_t type, const char *text) {
+    size_t len = strnlen(text, MSG_BUS_PAYLOAD_MAX - 1);
+    char buf[MSG_BUS_PAYLOAD_MAX];
+
+    memcpy(buf, text, len);
+    buf[len] = '\0';
+    return msg_bus_publish(bus, type, buf, (uint16_t)(len + 1));
+}
+
+int msg_bus_publish_text(msg_bus_t *bus, const char *text) {
+    return publish_string(bus, MSG_TYPE_TEXT, text);
+}
+
+int msg_bus_publish_text_cont(msg_bus_t *bus, const char *text) {
+    return publish_string(bus, MSG_TYPE_TEXT_CONT, text);
+}
+
+// 尝试读一条：1读到，0还没有，读游标被覆盖时跳到最旧的可用消息并计入lost
+static int try_read(msg_bus_t *bus, msg_bus_msg_t *msg, uint32_t *lost) {
+    msg_bus_shm_t *shm = bus->shm;
+    msg_bus_sub_t *s = &shm->subs[bus->sub];
+
+    while (1) {
+        uint32_t r = LOAD(&s->read_seq, __ATOMIC_RELAXED);
+        uint32_t w = LOAD(&shm->write_seq, __ATOMIC_ACQUIRE);
+        msg_bus_slot_t *slot = &shm->slots[r & (MSG_BUS_SLOTS - 1)];
+
+        if (r == w) return 0;
+        if (w - r > MSG_BUS_SLOTS) {
+            *lost += w - r - MSG_BUS_SLOTS;
+            STORE(&s->read_seq, w - MSG_BUS_SLOTS, __ATOMIC_RELEASE);
+            continue;
+        }
+
+        uint32_t v1 = LOAD(&slot->seq, __ATOMIC_ACQUIRE);
+        if (v1 != r + 1) {
+            // 序号已分配但发布者还没写完
+            if (v1 == 0 || (int32_t)(v1 - (r + 1)) < 0) return 0;
+            // 读之前就被新一圈覆盖
+            continue;
+        }
+        msg->type = slot->type;
+        msg->len = slot->len > MSG_BUS_PAYLOAD_MAX ? MSG_BUS_PAYLOAD_MAX : slot->len;
+        msg->sender = slot->sender;
+        msg->time_ns = slot->time_ns;
+        memcpy(msg->payload, slot->payload, msg->len);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (LOAD(&slot->seq, __ATOMIC_RELAXED) != v1) {
+            continue;   // 复制过程中被覆盖，重新判断
+        }
+        msg->seq = r;
+        msg->lost = *lost;
+        STORE(&s->read_seq, r + 1, __ATOMIC_RELEASE);
+        return 1;
+    }
+}
+
+// 等待下一条消息：1收到，0超时，-1出错；timeout_ms为-1时一直等
+int msg_bus_recv(msg_bus_t *bus, msg_bus_msg_t *msg, int timeout_ms) {
+    msg_bus_shm_t *shm = bus->shm;
+    uint64_t deadline = timeout_ms < 0 ? 0 : msg_bus_now_ns() + (uint64_t)timeout_ms * 1000000ull;
+    uint32_t lost = 0;
+
+    if (shm == NULL || bus->sub < 0) return -1;
+    while (1) {
+        uint32_t word = LOAD(&shm->futex_word, __ATOMIC_SEQ_CST);
+        struct timespec ts, *tsp = NULL;
+
+        if (try_read(bus, msg, &lost)) return 1;
+        if (timeout_ms >= 0) {
+            uint64_t now = msg_bus_now_ns();
+            if (now >= deadline) return 0;
+            ts.tv_sec = (time_t)((deadline - now) / 1000000000ull);
+            ts.tv_nsec = (long)((deadline - now) % 1000000000ull);
+            tsp = &ts;
+        }
+
+        __atomic_fetch_add(&shm->waiters, 1, __ATOMIC_SEQ_CST);
+        int ret = futex_wait(&shm->futex_word, word, tsp);
+        int err = errno;
+        __atomic_fetch_sub(&shm->waiters, 1, __ATOMIC_SEQ_CST);
+        if (ret < 0 && err != EAGAIN && err != EINTR && err != ETIMEDOUT) {
+            errno = err;
+            perror("msg_bus_recv: futex");
+            return -1;
+        }
+    }
+}
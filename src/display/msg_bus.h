@@ -0,0 +1,90 @@
+#ifndef MSG_BUS_H_
+#define MSG_BUS_H_
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 共享内存消息总线：取代只有一个128字节槽位和一个信号量的 /display_shm
+// - 多个发布者：原子递增分配序号，写入环形缓冲区对应槽位，写完再发布槽位序号
+// - 多个订阅者：每个订阅者在共享内存里有自己的读游标，每条消息每个订阅者都会收到一次
+// - 消息带类型、长度和二进制负载；文本命令（旧协议的字符串）用 MSG_TYPE_TEXT
+// - 等待用futex：发布后只有在有订阅者等待时才做一次唤醒系统调用
+// - 订阅者落后超过 MSG_BUS_SLOTS 条时最旧的消息被覆盖，recv返回的lost给出丢失条数
+// 全零的共享内存就是空总线，创建者和后来者不需要协调初始化顺序
+#define MSG_BUS_NAME "/display_bus"
+#define MSG_BUS_MAGIC 0x4D534742u   // "MSGB"
+#define MSG_BUS_VERSION 1
+#define MSG_BUS_SLOTS 128           // 必须是2的幂
+#define MSG_BUS_PAYLOAD_MAX 128     // 与旧协议的BUFFER_SIZE相同
+#define MSG_BUS_MAX_SUBS 8
+#define MSG_BUS_NAME_LEN 16
+
+// 消息类型
+#define MSG_TYPE_TEXT 1             // 旧协议的字符串命令，负载含结束符
+#define MSG_TYPE_TEXT_CONT 2        // 流式字幕（ASR/AI逐词输出）的后续片段：接在上一条字幕后面，不查命令表
+#define MSG_TYPE_USER 0x100         // 应用自定义的二进制消息从这里开始
+
+typedef struct {
+    uint32_t seq;                   // 已发布时为 序号+1，写入中为0
+    uint16_t type;
+    uint16_t len;
+    int32_t sender;                 // 发布者pid
+    uint32_t reserved;
+    uint64_t time_ns;               // 发布时的CLOCK_MONOTONIC
+    uint8_t payload[MSG_BUS_PAYLOAD_MAX];
+} msg_bus_slot_t;
+
+typedef struct {
+    uint32_t in_use;
+    int32_t pid;
+    uint32_t read_seq;              // 下一条要读的序号
+    char name[MSG_BUS_NAME_LEN];
+} msg_bus_sub_t;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t write_seq;             // 下一个分配给发布者的序号
+    uint32_t futex_word;            // 每发布一条加一，订阅者在上面等待
+    uint32_t waiters;               // 正在等待的订阅者数
+    uint32_t reserved[3];
+    msg_bus_sub_t subs[MSG_BUS_MAX_SUBS];
+    msg_bus_slot_t slots[MSG_BUS_SLOTS];
+} msg_bus_shm_t;
+
+typedef struct {
+    msg_bus_shm_t *shm;
+    char name[64];                  // 共享内存对象名
+    int sub;                        // 订阅者序号，只发布时为-1
+    int32_t pid;
+} msg_bus_t;
+
+typedef struct {
+    uint32_t seq;
+    uint16_t type;
+    uint16_t len;
+    int32_t sender;
+    uint32_t lost;                  // 在这条之前因落后被覆盖的消息数
+    uint64_t time_ns;
+    uint8_t payload[MSG_BUS_PAYLOAD_MAX];
+} msg_bus_msg_t;
+
+int msg_bus_open(msg_bus_t *bus, const char *name);
+void msg_bus_close(msg_bus_t *bus);
+int msg_bus_unlink(const char *name);
+int msg_bus_subscribe(msg_bus_t *bus, const char *sub_name);
+int msg_bus_publish(msg_bus_t *bus, uint16_t type, const void *data, uint16_t len);
+int msg_bus_publish_text(msg_bus_t *bus, const char *text);
+// 流式字幕的后续片段（MSG_TYPE_TEXT_CONT）：第一段用msg_bus_publish_text，之后的逐段用这个
+int msg_bus_publish_text_cont(msg_bus_t *bus, const char *text);
+int msg_bus_recv(msg_bus_t *bus, msg_bus_msg_t *msg, int timeout_ms);
+uint64_t msg_bus_now_ns(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,306 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "panel_sim.h"
+#include "jbd013_api.h"
+
+static uint8_t sim_cache[PANEL_SIM_BYTES];      // 面板缓存（写缓存指令写入这里）
+static uint8_t sim_frame_buf[PANEL_SIM_BYTES];  // 最近一次SYNC锁存的缓存内容
+static uint8_t sim_visible[PANEL_SIM_BYTES];    // 经过偏移/镜像/显示开关后实际看到的画面
+static uint8_t* sim_frame = NULL;               // 当前片选帧的数据（拼接多个transfer）
+static uint32_t sim_frame_len = 0;
+static uint32_t sim_frame_cap = 0;
+static uint32_t sim_rd_pos = 0;                 // 当前读缓存帧已返回的像素位置
+static panel_sim_stats_t sim_stats;
+static uint32_t sim_hz = PANEL_SIM_SPI_HZ;
+static uint32_t sim_msg_overhead_ns = PANEL_SIM_MSG_OVERHEAD_NS;
+static const char* sim_dump_dir = NULL;
+
+// 寄存器：写入后为待定值，SYNC时锁存
+typedef struct {
+    uint8_t row_off, col_off;   // 偏移寄存器
+    uint8_t mirror_rl, mirror_ud;
+    uint8_t enable;
+} sim_regs_t;
+static sim_regs_t sim_pending;
+static sim_regs_t sim_active;
+
+static void sim_sync(void);
+
+const panel_transport_t panel_sim_transport = {
+    .name = "sim",
+    .message = panel_sim_message,
+    .reset = panel_sim_reset,
+};
+
+// 复位：缓存内容未知，填充非零图案，便于发现依赖旧内容的错误
+void panel_sim_reset(void) {
+    memset(sim_cache, 0x88, sizeof(sim_cache));
+    memset(sim_frame_buf, 0x88, sizeof(sim_frame_buf));
+    memset(sim_visible, 0, sizeof(sim_visible));
+    memset(&sim_pending, 0, sizeof(sim_pending));
+    memset(&sim_active, 0, sizeof(sim_active));
+    memset(&sim_stats, 0, sizeof(sim_stats));
+    sim_frame_len = 0;
+}
+
+// 设置模拟的SPI时钟和每个消息的固定开销，用于估算传输时间
+void panel_sim_set_clock(uint32_t hz, uint32_t msg_overhead_ns) {
+    if (hz > 0) {
+        sim_hz = hz;
+    }
+    sim_msg_overhead_ns = msg_overhead_ns;
+}
+
+// 设置后每次SYNC把看到的画面保存为dir/frame_NNNNN.pgm，NULL关闭
+void panel_sim_set_dump_dir(const char* dir) {
+    sim_dump_dir = dir;
+}
+
+static inline uint8_t get_px(const uint8_t* buf, uint32_t pos) {
+    uint8_t b = buf[pos / 2];
+    return (pos & 1) ? (b & 0x0F) : (b >> 4);
+}
+
+static inline void set_px(uint8_t* buf, uint32_t pos, uint8_t gray) {
+    uint8_t* b = &buf[pos / 2];
+    if (pos & 1) {
+        *b = (*b & 0xF0) | (gray & 0x0F);
+    } else {
+        *b = (*b & 0x0F) | (gray << 4);
+    }
+}
+
+// 地址 -> 像素位置（行优先线性）
+static uint32_t sim_addr_pos(const uint8_t* hdr) {
+    uint32_t addr = ((uint32_t)hdr[1] << 16) | ((uint32_t)hdr[2] << 8) | hdr[3];
+    return ((addr >> 10) & 0x1ff) * PANEL_SIM_W + (addr & 0x3ff);
+}
+
+// 解析一个完整的片选帧
+static void sim_decode_frame(const uint8_t* buf, uint32_t len) {
+    uint32_t pos, i;
+
+    if (len == 0) {
+        return;
+    }
+    sim_stats.frames++;
+    switch (buf[0]) {
+    case SPI_WR_CACHE:
+    case SPI_WR_CACHE_1BIT_QSPI:
+    case SPI_WR_CACHE_FAST_1BIT_QSPI:
+        // 指令+24位地址+Dummy，数据，尾部Dummy
+        if (len < 6) {
+            printf("模拟面板：写缓存帧过短 (%u字节)\n", len);
+            return;
+        }
+        pos = sim_addr_pos(buf);
+        len -= 6;
+        if (buf[0] == SPI_WR_CACHE) {
+            sim_stats.wr4_bytes += len;
+            for (i = 0; i < len && pos + 1 < PANEL_SIM_W * PANEL_SIM_H; i++, pos += 2) {
+                set_px(sim_cache, pos, buf[5 + i] >> 4);
+                set_px(sim_cache, pos + 1, buf[5 + i] & 0x0F);
+            }
+        } else {
+            sim_stats.wr1_bytes += len;
+            for (i = 0; i < len * 8 && pos < PANEL_SIM_W * PANEL_SIM_H; i++, pos++) {
+                set_px(sim_cache, pos, (buf[5 + i / 8] & (0x80 >> (i % 8))) ? 0x0F : 0x00);
+            }
+        }
+        return;
+    case SPI_RD_CACHE:
+        return;
+    case SPI_SYNC:
+        sim_sync();
+        break;
+    case SPI_RST:
+        memset(sim_cache, 0x88, sizeof(sim_cache));
+        memset(&sim_pending, 0, sizeof(sim_pending));
+        break;
+    case SPI_WR_OFFSET_REG:
+        if (len >= 3) {
+            sim_pending.row_off = buf[1];
+            sim_pending.col_off = buf[2];
+        }
+        break;
+    case SPI_DISPLAY_DEFAULT_MODE:
+        sim_pending.mirror_rl = 0;
+        sim_pending.mirror_ud = 0;
+        break;
+    case SPI_DISPLAY_RL:
+        sim_pending.mirror_rl = 1;
+        break;
+    case SPI_DISPLAY_UD:
+        sim_pending.mirror_ud = 1;
+        break;
+    case SPI_DISPLAY_ENABLE:
+        sim_pending.enable = 1;
+        break;
+    case SPI_DISPLAY_DISABLE:
+        sim_pending.enable = 0;
+        break;
+    default:
+        break;
+    }
+    sim_stats.cmds++;
+}
+
+// SYNC：锁存缓存和寄存器，按偏移（假定按行列回绕）、镜像和显示开关合成看到的画面
+static void sim_sync(void) {
+    uint32_t x, y;
+
+    memcpy(sim_frame_buf, sim_cache, sizeof(sim_cache));
+    sim_active = sim_pending;
+    sim_stats.syncs++;
+
+    if (!sim_active.enable) {
+        memset(sim_visible, 0, sizeof(sim_visible));
+    } else {
+        for (y = 0; y < PANEL_SIM_H; y++) {
+            uint32_t sy = (y + sim_active.row_off) % PANEL_SIM_H;
+            uint32_t vy = sim_active.mirror_ud ? PANEL_SIM_H - 1 - y : y;
+            for (x = 0; x < PANEL_SIM_W; x++) {
+                uint32_t sx = (x + sim_active.col_off) % PANEL_SIM_W;
+                uint32_t vx = sim_active.mirror_rl ? PANEL_SIM_W - 1 - x : x;
+                set_px(sim_visible, vy * PANEL_SIM_W + vx, get_px(sim_frame_buf, sy * PANEL_SIM_W + sx));
+            }
+        }
+    }
+
+    if (sim_dump_dir != NULL) {
+        char path[256];
+        snprintf(path, sizeof(path), "%s/frame_%05llu.pgm", sim_dump_dir,
+                 (unsigned long long)sim_stats.syncs);
+        panel_sim_dump_pgm(path);
+    }
+}
+
+static int sim_frame_append(const uint8_t* data, uint32_t len) {
+    if (sim_frame_len + len > sim_frame_cap) {
+        uint32_t cap = (sim_frame_len + len) * 2;
+        uint8_t* p = realloc(sim_frame, cap);
+        if (p == NULL) {
+            perror("panel_sim: realloc");
+            return -1;
+        }
+        sim_frame = p;
+        sim_frame_cap = cap;
+    }
+    memcpy(sim_frame + sim_frame_len, data, len);
+    sim_frame_len += len;
+    return 0;
+}
+
+// 接收数据：读缓存帧返回缓存内容，其他读取返回0
+static void sim_fill_rx(uint8_t* rx, uint32_t len) {
+    uint32_t i;
+
+    if (sim_frame_len >= 5 && sim_frame[0] == SPI_RD_CACHE) {
+        if (sim_rd_pos == UINT32_MAX) {
+            sim_rd_pos = sim_addr_pos(sim_frame);
+        }
+        for (i = 0; i < len; i++, sim_rd_pos += 2) {
+            uint32_t p0 = sim_rd_pos % (PANEL_SIM_W * PANEL_SIM_H);
+            uint32_t p1 = (sim_rd_pos + 1) % (PANEL_SIM_W * PANEL_SIM_H);
+            rx[i] = (uint8_t)((get_px(sim_cache, p0) << 4) | get_px(sim_cache, p1));
+        }
+        sim_stats.rd_bytes += len;
+    } else {
+        memset(rx, 0, len);
+    }
+}
+
+// 处理一个SPI消息：cs_change的transfer之后片选拉高，一帧结束；消息结束也结束一帧
+int panel_sim_message(struct spi_ioc_transfer* transfer, uint32_t n) {
+    uint32_t i;
+
+    sim_stats.messages++;
+    sim_stats.modeled_ns += sim_msg_overhead_ns;
+    for (i = 0; i < n; i++) {
+        const struct spi_ioc_transfer* t = &transfer[i];
+        uint32_t nbits = t->tx_nbits ? t->tx_nbits : 1;
+
+        if (sim_frame_len == 0) {
+            sim_rd_pos = UINT32_MAX;
+        }
+        if (t->rx_buf) {
+            sim_fill_rx((uint8_t*)(unsigned long)t->rx_buf, t->len);
+        }
+        if (t->tx_buf) {
+            if (sim_frame_append((const uint8_t*)(unsigned long)t->tx_buf, t->len) != 0) {
+                return -1;
+            }
+        }
+        sim_stats.wire_bytes += t->len;
+        sim_stats.modeled_ns += (uint64_t)t->len * 8 / nbits * 1000000000ull / sim_hz;
+        if (t->cs_change || i + 1 == n) {
+            sim_decode_frame(sim_frame, sim_frame_len);
+            sim_frame_len = 0;
+        }
+    }
+    return 0;
+}
+
+// 当前缓存内容（尚未同步的写入也可见）
+const uint8_t* panel_sim_cache(void) {
+    return sim_cache;
+}
+
+// 最近一次SYNC锁存的缓存内容
+const uint8_t* panel_sim_frame(void) {
+    return sim_frame_buf;
+}
+
+// 实际看到的画面（偏移、镜像、显示开关之后）
+const uint8_t* panel_sim_visible(void) {
+    return sim_visible;
+}
+
+// 读取看到的画面中的一个像素（0~15）
+uint8_t panel_sim_pixel(uint16_t x, uint16_t y) {
+    return get_px(sim_visible, y * PANEL_SIM_W + x);
+}
+
+void panel_sim_get_offset(uint8_t* row, uint8_t* col) {
+    *row = sim_active.row_off;
+    *col = sim_active.col_off;
+}
+
+// 把看到的画面保存为PGM（灰度0~15）
+int panel_sim_dump_pgm(const char* path) {
+    FILE* fp = fopen(path, "wb");
+    uint8_t line[PANEL_SIM_W];
+    uint32_t x, y;
+
+    if (fp == NULL) {
+        perror("panel_sim: fopen");
+        return -1;
+    }
+    fprintf(fp, "P5\n%d %d\n15\n", PANEL_SIM_W, PANEL_SIM_H);
+    for (y = 0; y < PANEL_SIM_H; y++) {
+        for (x = 0; x < PANEL_SIM_W; x++) {
+            line[x] = get_px(sim_visible, y * PANEL_SIM_W + x);
+        }
+        fwrite(line, 1, sizeof(line), fp);
+    }
+    fclose(fp);
+    return 0;
+}
+
+void panel_sim_stats_get(panel_sim_stats_t* stats) {
+    *stats = sim_stats;
+}
+
+void panel_sim_stats_reset(void) {
+    memset(&sim_stats, 0, sizeof(sim_stats));
+}
+
+void panel_sim_stats_print(void) {
+    printf("模拟面板: %llu 消息, %llu 帧, 线上 %llu 字节 (4bpp %llu, 1bit %llu), %llu 次SYNC, 估算 %.2f ms\n",
+           (unsigned long long)sim_stats.messages, (unsigned long long)sim_stats.frames,
+           (unsigned long long)sim_stats.wire_bytes, (unsigned long long)sim_stats.wr4_bytes,
+           (unsigned long long)sim_stats.wr1_bytes, (unsigned long long)sim_stats.syncs,
+           sim_stats.modeled_ns / 1e6);
+}
@@ -0,0 +1,44 @@
+#ifndef PANEL_SIM_H_
+#define PANEL_SIM_H_
+
+#include <stdint.h>
+#include <linux/spi/spidev.h>
+#include "hal_driver.h"
+
+// 模拟面板：解析发往JBD013的SPI消息，维护640x480的4bpp缓存，
+// 按SYNC锁存缓存和偏移/镜像/显示开关寄存器，并按SPI时钟估算传输时间，
+// 用于在主机上运行整个显示程序并统计每帧的传输量
+#define PANEL_SIM_W 640
+#define PANEL_SIM_H 480
+#define PANEL_SIM_BYTES (PANEL_SIM_W * PANEL_SIM_H / 2)
+#define PANEL_SIM_SPI_HZ 19200000       // 默认时钟，与spi_init一致
+#define PANEL_SIM_MSG_OVERHEAD_NS 20000 // 每个SPI消息的固定开销估计（系统调用+控制器启动）
+
+typedef struct {
+    uint64_t messages;      // SPI消息数（对应ioctl次数）
+    uint64_t frames;        // 片选帧数
+    uint64_t wire_bytes;    // 总线上的字节数（含指令头和Dummy）
+    uint64_t wr4_bytes;     // 4bpp写缓存的像素数据字节
+    uint64_t wr1_bytes;     // 1bit写缓存的像素数据字节
+    uint64_t rd_bytes;      // 读缓存字节
+    uint64_t cmds;          // 其他指令帧数
+    uint64_t syncs;         // SYNC次数
+    uint64_t modeled_ns;    // 按时钟和消息开销估算的总线时间
+} panel_sim_stats_t;
+
+extern const panel_transport_t panel_sim_transport;
+
+void panel_sim_reset(void);
+int panel_sim_message(struct spi_ioc_transfer* transfer, uint32_t n);
+void panel_sim_set_clock(uint32_t hz, uint32_t msg_overhead_ns);
+void panel_sim_set_dump_dir(const char* dir);
+const uint8_t* panel_sim_cache(void);
+const uint8_t* panel_sim_frame(void);
+const uint8_t* panel_sim_visible(void);
+uint8_t panel_sim_pixel(uint16_t x, uint16_t y);
+void panel_sim_get_offset(uint8_t* row, uint8_t* col);
+int panel_sim_dump_pgm(const char* path);
+void panel_sim_stats_get(panel_sim_stats_t* stats);
+void panel_sim_stats_reset(void);
+void panel_sim_stats_print(void);
+#endif
@@ -0,0 +1,225 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pix_kernels.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define PIX_USE_NEON 1
+#endif
+
+// 4x4 Bayer阈值（0~15），加到灰度上再截断，平均值与直接截断相同
+static const uint8_t bayer4[4][4] = {
+    {  0,  8,  2, 10 },
+    { 12,  4, 14,  6 },
+    {  3, 11,  1,  9 },
+    { 15,  7, 13,  5 },
+};
+
+static inline uint8_t gray_of(const uint8_t* p, uint8_t order) {
+    uint8_t r = order == PIX_ORDER_BGR ? p[2] : p[0];
+    uint8_t b = order == PIX_ORDER_BGR ? p[0] : p[2];
+    return (uint8_t)((r * 77 + p[1] * 151 + b * 28) >> 8);
+}
+
+static inline uint8_t bayer_of(uint8_t gray, uint32_t x, uint32_t y) {
+    uint32_t v = gray + bayer4[y & 3][x & 3];
+    return (uint8_t)((v > 255 ? 255 : v) >> 4);
+}
+
+#ifdef PIX_USE_NEON
+// 16个灰度值 -> 16个0~15
+static inline uint8x16_t rgb16_to_gray(const uint8_t* rgb, uint8_t order) {
+    uint8x16x3_t p = vld3q_u8(rgb);
+    uint8x16_t r = p.val[0], b = p.val[2];
+    uint16x8_t lo, hi;
+
+    if (order == PIX_ORDER_BGR) {
+        r = p.val[2];
+        b = p.val[0];
+    }
+    lo = vmull_u8(vget_low_u8(r), vdup_n_u8(77));
+    hi = vmull_u8(vget_high_u8(r), vdup_n_u8(77));
+    lo = vmlal_u8(lo, vget_low_u8(p.val[1]), vdup_n_u8(151));
+    hi = vmlal_u8(hi, vget_high_u8(p.val[1]), vdup_n_u8(151));
+    lo = vmlal_u8(lo, vget_low_u8(b), vdup_n_u8(28));
+    hi = vmlal_u8(hi, vget_high_u8(b), vdup_n_u8(28));
+    return vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8));
+}
+
+// 16个0~15的像素 -> 8字节：每个16位通道为 p0 | p1<<8，取 (p0<<4 | p1) 的低字节
+static inline uint8x8_t pack16(uint8x16_t px) {
+    uint16x8_t w = vreinterpretq_u16_u8(px);
+    return vmovn_u16(vorrq_u16(vshlq_n_u16(w, 4), vshrq_n_u16(w, 8)));
+}
+#endif
+
+// RGB888 -> 8位灰度
+void pix_rgb_to_gray8(const uint8_t* rgb, uint8_t* gray, uint32_t n, uint8_t order) {
+    uint32_t i = 0;
+
+#ifdef PIX_USE_NEON
+    for (; i + 16 <= n; i += 16) {
+        vst1q_u8(&gray[i], rgb16_to_gray(&rgb[i * 3], order));
+    }
+#endif
+    for (; i < n; i++) {
+        gray[i] = gray_of(&rgb[i * 3], order);
+    }
+}
+
+// RGB888 -> 打包4bpp，n为奇数时最后一个字节低4位为0
+void pix_rgb_to_4bpp(const uint8_t* rgb, uint8_t* dst, uint32_t n, uint8_t order) {
+    uint32_t i = 0;
+
+#ifdef PIX_USE_NEON
+    for (; i + 16 <= n; i += 16) {
+        vst1_u8(&dst[i / 2], pack16(vshrq_n_u8(rgb16_to_gray(&rgb[i * 3], order), 4)));
+    }
+#endif
+    for (; i + 1 < n; i += 2) {
+        dst[i / 2] = (uint8_t)(((gray_of(&rgb[i * 3], order) >> 4) << 4) | (gray_of(&rgb[i * 3 + 3], order) >> 4));
+    }
+    if (i < n) {
+        dst[i / 2] = (uint8_t)((gray_of(&rgb[i * 3], order) >> 4) << 4);
+    }
+}
+
+// 8位灰度 -> 打包4bpp，直接截断
+void pix_gray8_to_4bpp(const uint8_t* gray, uint8_t* dst, uint32_t n) {
+    uint32_t i = 0;
+
+#ifdef PIX_USE_NEON
+    for (; i + 16 <= n; i += 16) {
+        vst1_u8(&dst[i / 2], pack16(vshrq_n_u8(vld1q_u8(&gray[i]), 4)));
+    }
+#endif
+    for (; i + 1 < n; i += 2) {
+        dst[i / 2] = (uint8_t)((gray[i] & 0xF0) | (gray[i + 1] >> 4));
+    }
+    if (i < n) {
+        dst[i / 2] = (uint8_t)(gray[i] & 0xF0);
+    }
+}
+
+// 8位灰度 -> 打包4bpp，4x4有序抖动；y为该行在屏幕上的行号，x从0开始
+void pix_gray8_to_4bpp_bayer(const uint8_t* gray, uint8_t* dst, uint32_t n, uint32_t y) {
+    uint32_t i = 0;
+
+#ifdef PIX_USE_NEON
+    const uint8_t* b = bayer4[y & 3];
+    const uint8_t row[16] = { b[0], b[1], b[2], b[3], b[0], b[1], b[2], b[3],
+                              b[0], b[1], b[2], b[3], b[0], b[1], b[2], b[3] };
+    uint8x16_t thr = vld1q_u8(row);
+
+    for (; i + 16 <= n; i += 16) {
+        vst1_u8(&dst[i / 2], pack16(vshrq_n_u8(vqaddq_u8(vld1q_u8(&gray[i]), thr), 4)));
+    }
+#endif
+    for (; i + 1 < n; i += 2) {
+        dst[i / 2] = (uint8_t)((bayer_of(gray[i], i, y) << 4) | bayer_of(gray[i + 1], i + 1, y));
+    }
+    if (i < n) {
+        dst[i / 2] = (uint8_t)(bayer_of(gray[i], i, y) << 4);
+    }
+}
+
+// 8位灰度 -> 打包4bpp，Floyd-Steinberg误差扩散（16级对应0,17,...,255）
+// 误差沿行传递，前后像素相互依赖，没有向量实现
+int pix_gray8_to_4bpp_fs(const uint8_t* gray, uint32_t gray_stride, uint8_t* dst, uint32_t dst_stride,
+                         uint32_t width, uint32_t height) {
+    // 两行误差，左右各留一个像素的边界
+    int16_t* err = calloc((size_t)(width + 2) * 2, sizeof(int16_t));
+    int16_t *cur, *next;
+
+    if (err == NULL) {
+        perror("pix_gray8_to_4bpp_fs: calloc");
+        return -1;
+    }
+    cur = err + 1;
+    next = err + width + 3;
+    for (uint32_t y = 0; y < height; y++) {
+        const uint8_t* src = &gray[y * gray_stride];
+        uint8_t* out = &dst[y * dst_stride];
+
+        for (uint32_t x = 0; x < width; x++) {
+            int16_t* below = &next[x];
+            int v = src[x] + cur[x] / 16;
+            int q, e;
+
+            v = v < 0 ? 0 : (v > 255 ? 255 : v);
+            q = (v + 8) / 17;
+            e = v - q * 17;
+            cur[x + 1] += (int16_t)(e * 7);
+            below[-1] += (int16_t)(e * 3);
+            below[0] += (int16_t)(e * 5);
+            below[1] += (int16_t)e;
+
+            if (x & 1) {
+                out[x / 2] |= (uint8_t)q;
+            } else {
+                out[x / 2] = (uint8_t)(q << 4);
+            }
+        }
+        // 下一行的误差变为当前行
+        int16_t* t = cur;
+        cur = next;
+        next = t;
+        memset(next - 1, 0, (width + 2) * sizeof(int16_t));
+    }
+    free(err);
+    return 0;
+}
+
+// 8位像素（低4位为灰度，如LV_COLOR_DEPTH 8下的lv_color_t）-> 打包4bpp
+void pix_pack_4bpp(const uint8_t* src, uint8_t* dst, uint32_t n) {
+    uint32_t i = 0;
+
+#ifdef PIX_USE_NEON
+    uint8x16_t mask = vdupq_n_u8(0x0F);
+
+    for (; i + 16 <= n; i += 16) {
+        vst1_u8(&dst[i / 2], pack16(vandq_u8(vld1q_u8(&src[i]), mask)));
+    }
+#endif
+    for (; i + 1 < n; i += 2) {
+        dst[i / 2] = (uint8_t)(((src[i] & 0x0F) << 4) | (src[i + 1] & 0x0F));
+    }
+    if (i < n) {
+        dst[i / 2] = (uint8_t)((src[i] & 0x0F) << 4);
+    }
+}
+
+// 打包4bpp -> 每像素一字节（0~15）
+void pix_unpack_4bpp(const uint8_t* src, uint8_t* dst, uint32_t n) {
+    uint32_t i = 0;
+
+#ifdef PIX_USE_NEON
+    uint8x16_t mask = vdupq_n_u8(0x0F);
+
+    for (; i + 32 <= n; i += 32) {
+        uint8x16_t b = vld1q_u8(&src[i / 2]);
+        uint8x16x2_t px;
+
+        px.val[0] = vshrq_n_u8(b, 4);
+        px.val[1] = vandq_u8(b, mask);
+        vst2q_u8(&dst[i], px);
+    }
+#endif
+    for (; i + 1 < n; i += 2) {
+        dst[i] = src[i / 2] >> 4;
+        dst[i + 1] = src[i / 2] & 0x0F;
+    }
+    if (i < n) {
+        dst[i] = src[i / 2] >> 4;
+    }
+}
+
+const char* pix_impl_name(void) {
+#ifdef PIX_USE_NEON
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,28 @@
+#ifndef PIX_KERNELS_H_
+#define PIX_KERNELS_H_
+
+#include <stdint.h>
+
+// 像素转换内核：RGB/灰度 -> 面板4bpp（每字节2像素，高4位在前）
+// 编译器打开NEON（__ARM_NEON）时使用向量实现，否则为标量实现，两者结果逐位一致
+// 灰度公式与rgb_to_4bit_fast相同：(r*77 + g*151 + b*28) >> 8
+
+// 输入字节顺序
+#define PIX_ORDER_RGB 0
+#define PIX_ORDER_BGR 1         // BMP文件
+
+// 抖动方式
+#define PIX_DITHER_NONE 0       // 直接截断到16级
+#define PIX_DITHER_BAYER 1      // 4x4有序抖动，逐行独立，可向量化
+#define PIX_DITHER_FS 2         // Floyd-Steinberg误差扩散，整幅处理，只有标量实现
+
+void pix_rgb_to_gray8(const uint8_t* rgb, uint8_t* gray, uint32_t n, uint8_t order);
+void pix_rgb_to_4bpp(const uint8_t* rgb, uint8_t* dst, uint32_t n, uint8_t order);
+void pix_gray8_to_4bpp(const uint8_t* gray, uint8_t* dst, uint32_t n);
+void pix_gray8_to_4bpp_bayer(const uint8_t* gray, uint8_t* dst, uint32_t n, uint32_t y);
+int pix_gray8_to_4bpp_fs(const uint8_t* gray, uint32_t gray_stride, uint8_t* dst, uint32_t dst_stride,
+                         uint32_t width, uint32_t height);
+void pix_pack_4bpp(const uint8_t* src, uint8_t* dst, uint32_t n);
+void pix_unpack_4bpp(const uint8_t* src, uint8_t* dst, uint32_t n);
+const char* pix_impl_name(void);
+#endif
@@ -0,0 +1,352 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pix_kernels.h"
+#include "pix_scale.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define PIX_USE_NEON 1
+#endif
+
+#define WEIGHT_ONE 128          // 双线性权重的1.0：7位，128-w也放得进uint8，NEON可直接vmull_u8
+#define BOX_INV_SHIFT 38        // 面积不超过2^15时，(和+面积/2)*倒数>>38与整数除法结果相同
+
+// ================== 行内核 ==================
+// out = (a*wa + b*wb + 64) >> 7，权重逐像素（水平方向）
+static void blend_var(const uint8_t* a, const uint8_t* b, const uint8_t* wa, const uint8_t* wb,
+                      uint8_t* out, uint32_t n) {
+    uint32_t i = 0;
+
+#ifdef PIX_USE_NEON
+    for (; i + 16 <= n; i += 16) {
+        uint8x16_t va = vld1q_u8(&a[i]), vb = vld1q_u8(&b[i]);
+        uint8x16_t vwa = vld1q_u8(&wa[i]), vwb = vld1q_u8(&wb[i]);
+        uint16x8_t lo = vmull_u8(vget_low_u8(va), vget_low_u8(vwa));
+        uint16x8_t hi = vmull_u8(vget_high_u8(va), vget_high_u8(vwa));
+
+        lo = vmlal_u8(lo, vget_low_u8(vb), vget_low_u8(vwb));
+        hi = vmlal_u8(hi, vget_high_u8(vb), vget_high_u8(vwb));
+        vst1q_u8(&out[i], vcombine_u8(vrshrn_n_u16(lo, 7), vrshrn_n_u16(hi, 7)));
+    }
+#endif
+    for (; i < n; i++) {
+        out[i] = (uint8_t)((a[i] * wa[i] + b[i] * wb[i] + 64) >> 7);
+    }
+}
+
+// 同上，整行同一对权重（垂直方向）
+static void blend_const(const uint8_t* a, const uint8_t* b, uint8_t wa, uint8_t wb, uint8_t* out, uint32_t n) {
+    uint32_t i = 0;
+
+#ifdef PIX_USE_NEON
+    uint8x8_t vwa = vdup_n_u8(wa), vwb = vdup_n_u8(wb);
+
+    for (; i + 16 <= n; i += 16) {
+        uint8x16_t va = vld1q_u8(&a[i]), vb = vld1q_u8(&b[i]);
+        uint16x8_t lo = vmull_u8(vget_low_u8(va), vwa);
+        uint16x8_t hi = vmull_u8(vget_high_u8(va), vwa);
+
+        lo = vmlal_u8(lo, vget_low_u8(vb), vwb);
+        hi = vmlal_u8(hi, vget_high_u8(vb), vwb);
+        vst1q_u8(&out[i], vcombine_u8(vrshrn_n_u16(lo, 7), vrshrn_n_u16(hi, 7)));
+    }
+#endif
+    for (; i < n; i++) {
+        out[i] = (uint8_t)((a[i] * wa + b[i] * wb + 64) >> 7);
+    }
+}
+
+// 区域平均的列累加：sum = row / sum += row
+static void colsum_load(uint16_t* sum, const uint8_t* row, uint32_t n) {
+    uint32_t i = 0;
+
+#ifdef PIX_USE_NEON
+    for (; i + 16 <= n; i += 16) {
+        uint8x16_t v = vld1q_u8(&row[i]);
+        vst1q_u16(&sum[i], vmovl_u8(vget_low_u8(v)));
+        vst1q_u16(&sum[i + 8], vmovl_u8(vget_high_u8(v)));
+    }
+#endif
+    for (; i < n; i++) {
+        sum[i] = row[i];
+    }
+}
+
+static void colsum_add(uint16_t* sum, const uint8_t* row, uint32_t n) {
+    uint32_t i = 0;
+
+#ifdef PIX_USE_NEON
+    for (; i + 16 <= n; i += 16) {
+        uint8x16_t v = vld1q_u8(&row[i]);
+        vst1q_u16(&sum[i], vaddw_u8(vld1q_u16(&sum[i]), vget_low_u8(v)));
+        vst1q_u16(&sum[i + 8], vaddw_u8(vld1q_u16(&sum[i + 8]), vget_high_u8(v)));
+    }
+#endif
+    for (; i < n; i++) {
+        sum[i] = (uint16_t)(sum[i] + row[i]);
+    }
+}
+// ================== 行内核结束 ==================
+
+// ================== 坐标表 ==================
+// 一个方向的表：src个源像素映射到dst个目标像素
+static void axis_table(uint8_t mode, uint32_t src, uint32_t dst, uint16_t* p0, uint16_t* p1,
+                       uint8_t* wa, uint8_t* wb) {
+    for (uint32_t i = 0; i < dst; i++) {
+        if (mode == PIX_SCALE_NEAREST) {
+            p0[i] = (uint16_t)(((2 * (uint64_t)i + 1) * src) / (2 * (uint64_t)dst));
+        } else if (mode == PIX_SCALE_BILINEAR) {
+            // 像素中心对齐：源坐标 = (i+0.5)*src/dst - 0.5，单位1/128
+            int64_t f = (int64_t)(((2 * (uint64_t)i + 1) * src * WEIGHT_ONE) / (2 * (uint64_t)dst)) - WEIGHT_ONE / 2;
+            uint32_t x, w;
+
+            if (f < 0) f = 0;
+            x = (uint32_t)(f / WEIGHT_ONE);
+            w = (uint32_t)(f % WEIGHT_ONE);
+            if (x >= src - 1) {
+                x = src - 1;
+                w = 0;
+            }
+            p0[i] = (uint16_t)x;
+            p1[i] = (uint16_t)(x + 1 < src ? x + 1 : x);
+            wa[i] = (uint8_t)(WEIGHT_ONE - w);
+            wb[i] = (uint8_t)w;
+        } else {
+            uint32_t a = (uint32_t)((uint64_t)i * src / dst);
+            uint32_t b = (uint32_t)((uint64_t)(i + 1) * src / dst);
+
+            p0[i] = (uint16_t)a;
+            p1[i] = (uint16_t)(b > a ? b : a + 1);
+        }
+    }
+}
+
+// 区域平均：区域宽度的最小、最大值
+static void box_span(const uint16_t* p0, const uint16_t* p1, uint32_t n, uint32_t* lo, uint32_t* hi) {
+    *lo = UINT32_MAX;
+    *hi = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t len = p1[i] - p0[i];
+        if (len < *lo) *lo = len;
+        if (len > *hi) *hi = len;
+    }
+}
+
+void pix_scale_free(pix_scale_t* s) {
+    free(s->x0);
+    free(s->x1);
+    free(s->xwa);
+    free(s->xwb);
+    free(s->y0);
+    free(s->y1);
+    free(s->ywa);
+    free(s->ywb);
+    free(s->unpack);
+    free(s->line);
+    free(s->ga);
+    free(s->gb);
+    free(s->hrow[0]);
+    free(s->hrow[1]);
+    free(s->colsum);
+    memset(s, 0, sizeof(*s));
+}
+
+int pix_scale_init(pix_scale_t* s, uint32_t src_w, uint32_t src_h, uint32_t dst_w, uint32_t dst_h, uint8_t mode) {
+    memset(s, 0, sizeof(*s));
+    if (src_w == 0 || src_h == 0 || dst_w == 0 || dst_h == 0 ||
+        src_w > UINT16_MAX || src_h > UINT16_MAX || dst_w > UINT16_MAX || dst_h > UINT16_MAX ||
+        mode > PIX_SCALE_BOX) {
+        printf("pix_scale: 参数无效 %ux%u -> %ux%u 模式%u\n", src_w, src_h, dst_w, dst_h, mode);
+        return -1;
+    }
+    s->src_w = (uint16_t)src_w;
+    s->src_h = (uint16_t)src_h;
+    s->dst_w = (uint16_t)dst_w;
+    s->dst_h = (uint16_t)dst_h;
+    s->mode = mode;
+
+    s->x0 = malloc(dst_w * sizeof(uint16_t));
+    s->x1 = malloc(dst_w * sizeof(uint16_t));
+    s->xwa = malloc(dst_w);
+    s->xwb = malloc(dst_w);
+    s->y0 = malloc(dst_h * sizeof(uint16_t));
+    s->y1 = malloc(dst_h * sizeof(uint16_t));
+    s->ywa = malloc(dst_h);
+    s->ywb = malloc(dst_h);
+    s->unpack = malloc(src_w);
+    s->line = malloc(dst_w);
+    if (s->x0 == NULL || s->x1 == NULL || s->xwa == NULL || s->xwb == NULL || s->y0 == NULL ||
+        s->y1 == NULL || s->ywa == NULL || s->ywb == NULL || s->unpack == NULL || s->line == NULL) {
+        goto oom;
+    }
+    axis_table(mode, src_w, dst_w, s->x0, s->x1, s->xwa, s->xwb);
+    axis_table(mode, src_h, dst_h, s->y0, s->y1, s->ywa, s->ywb);
+
+    if (mode == PIX_SCALE_BILINEAR) {
+        s->ga = malloc(dst_w);
+        s->gb = malloc(dst_w);
+        s->hrow[0] = malloc(dst_w);
+        s->hrow[1] = malloc(dst_w);
+        if (s->ga == NULL || s->gb == NULL || s->hrow[0] == NULL || s->hrow[1] == NULL) goto oom;
+    } else if (mode == PIX_SCALE_BOX) {
+        uint32_t nx_lo, nx_hi, ny_lo, ny_hi;
+
+        box_span(s->x0, s->x1, dst_w, &nx_lo, &nx_hi);
+        box_span(s->y0, s->y1, dst_h, &ny_lo, &ny_hi);
+        if (ny_hi > PIX_SCALE_BOX_MAX || nx_hi > PIX_SCALE_BOX_MAX || nx_hi * ny_hi > 32768) {
+            printf("pix_scale: 区域平均缩小倍数过大 %ux%u -> %ux%u\n", src_w, src_h, dst_w, dst_h);
+            pix_scale_free(s);
+            return -1;
+        }
+        s->box_nx = (uint16_t)nx_lo;
+        s->box_ny = (uint16_t)ny_lo;
+        for (uint32_t ky = 0; ky < 2; ky++) {
+            for (uint32_t kx = 0; kx < 2; kx++) {
+                uint64_t area = (uint64_t)(nx_lo + kx) * (ny_lo + ky);
+                s->box_inv[ky][kx] = ((1ull << BOX_INV_SHIFT) + area - 1) / area;
+            }
+        }
+        s->colsum = malloc(src_w * sizeof(uint16_t));
+        if (s->colsum == NULL) goto oom;
+    }
+    s->hrow_y[0] = s->hrow_y[1] = -1;
+    return 0;
+
+oom:
+    perror("pix_scale_init: malloc");
+    pix_scale_free(s);
+    return -1;
+}
+// ================== 坐标表结束 ==================
+
+// ================== 缩放 ==================
+// 源图第y行，4bpp解包成每像素一字节
+static const uint8_t* src_row(pix_scale_t* s, const uint8_t* src, uint32_t stride, uint32_t y, int packed) {
+    const uint8_t* row = &src[(size_t)y * stride];
+
+    if (!packed) return row;
+    pix_unpack_4bpp(row, s->unpack, s->src_w);
+    return s->unpack;
+}
+
+static void nearest_line(pix_scale_t* s, const uint8_t* row, uint8_t* line) {
+    const uint16_t* x0 = s->x0;
+
+    for (uint32_t i = 0; i < s->dst_w; i++) {
+        line[i] = row[x0[i]];
+    }
+}
+
+// 双线性：源第y行水平缩放后的结果，缓存两行（相邻目标行多半用同一对源行），不覆盖busy槽
+static const uint8_t* bilinear_hrow(pix_scale_t* s, const uint8_t* src, uint32_t stride, uint32_t y,
+                                    int packed, int busy, int* slot_out) {
+    const uint8_t* row;
+    int slot;
+
+    for (slot = 0; slot < 2; slot++) {
+        if (s->hrow_y[slot] == (int32_t)y) {
+            *slot_out = slot;
+            return s->hrow[slot];
+        }
+    }
+    // 目标行从上往下走，淘汰行号小的那个
+    if (busy >= 0) {
+        slot = !busy;
+    } else {
+        slot = s->hrow_y[0] <= s->hrow_y[1] ? 0 : 1;
+    }
+    row = src_row(s, src, stride, y, packed);
+    for (uint32_t i = 0; i < s->dst_w; i++) {
+        s->ga[i] = row[s->x0[i]];
+        s->gb[i] = row[s->x1[i]];
+    }
+    blend_var(s->ga, s->gb, s->xwa, s->xwb, s->hrow[slot], s->dst_w);
+    s->hrow_y[slot] = (int32_t)y;
+    *slot_out = slot;
+    return s->hrow[slot];
+}
+
+static void bilinear_line(pix_scale_t* s, const uint8_t* src, uint32_t stride, uint32_t dy, int packed,
+                          uint8_t* line) {
+    int sa, sb;
+    const uint8_t* a = bilinear_hrow(s, src, stride, s->y0[dy], packed, -1, &sa);
+
+    if (s->ywb[dy] == 0) {
+        memcpy(line, a, s->dst_w);
+        return;
+    }
+    const uint8_t* b = bilinear_hrow(s, src, stride, s->y1[dy], packed, sa, &sb);
+    blend_const(a, b, s->ywa[dy], s->ywb[dy], line, s->dst_w);
+}
+
+static void box_line(pix_scale_t* s, const uint8_t* src, uint32_t stride, uint32_t dy, int packed,
+                     uint8_t* line) {
+    uint32_t ya = s->y0[dy], yb = s->y1[dy], ny = yb - ya;
+    const uint64_t* inv = s->box_inv[ny - s->box_ny];
+    const uint16_t* sum = s->colsum;
+
+    colsum_load(s->colsum, src_row(s, src, stride, ya, packed), s->src_w);
+    for (uint32_t y = ya + 1; y < yb; y++) {
+        colsum_add(s->colsum, src_row(s, src, stride, y, packed), s->src_w);
+    }
+    for (uint32_t i = 0; i < s->dst_w; i++) {
+        uint32_t xa = s->x0[i], xb = s->x1[i], acc = 0;
+        uint32_t area = (xb - xa) * ny;
+
+        for (uint32_t x = xa; x < xb; x++) acc += sum[x];
+        line[i] = (uint8_t)(((uint64_t)(acc + area / 2) * inv[xb - xa - s->box_nx]) >> BOX_INV_SHIFT);
+    }
+}
+
+static void scale_run(pix_scale_t* s, const uint8_t* src, uint32_t src_stride, uint8_t* dst, uint32_t dst_stride,
+                      int packed) {
+    uint32_t row_bytes = packed ? (s->dst_w + 1u) / 2 : s->dst_w;
+
+    // 源数据每次调用都可能换了，行缓存作废
+    s->hrow_y[0] = s->hrow_y[1] = -1;
+    for (uint32_t dy = 0; dy < s->dst_h; dy++) {
+        uint8_t* out = &dst[(size_t)dy * dst_stride];
+        uint8_t* line = packed ? s->line : out;
+
+        if (s->mode == PIX_SCALE_NEAREST) {
+            // 放大时相邻目标行取同一源行，直接复制上一行
+            if (dy > 0 && s->y0[dy] == s->y0[dy - 1]) {
+                memcpy(out, out - dst_stride, row_bytes);
+                continue;
+            }
+            nearest_line(s, src_row(s, src, src_stride, s->y0[dy], packed), line);
+        } else if (s->mode == PIX_SCALE_BILINEAR) {
+            bilinear_line(s, src, src_stride, dy, packed, line);
+        } else {
+            box_line(s, src, src_stride, dy, packed, line);
+        }
+        if (packed) pix_pack_4bpp(line, out, s->dst_w);
+    }
+}
+
+void pix_scale_gray8(pix_scale_t* s, const uint8_t* src, uint32_t src_stride, uint8_t* dst, uint32_t dst_stride) {
+    scale_run(s, src, src_stride, dst, dst_stride, 0);
+}
+
+void pix_scale_4bpp(pix_scale_t* s, const uint8_t* src, uint32_t src_stride, uint8_t* dst, uint32_t dst_stride) {
+    scale_run(s, src, src_stride, dst, dst_stride, 1);
+}
+
+void pix_scale_fit(uint32_t src_w, uint32_t src_h, uint32_t max_w, uint32_t max_h, uint16_t* w, uint16_t* h) {
+    uint64_t fw = src_w, fh = src_h;
+
+    if (fw > max_w || fh > max_h) {
+        if ((uint64_t)src_w * max_h > (uint64_t)src_h * max_w) {
+            fw = max_w;
+            fh = (uint64_t)src_h * max_w / src_w;
+        } else {
+            fh = max_h;
+            fw = (uint64_t)src_w * max_h / src_h;
+        }
+    }
+    *w = (uint16_t)(fw ? fw : 1);
+    *h = (uint16_t)(fh ? fh : 1);
+}
+// ================== 缩放结束 ==================
@@ -0,0 +1,54 @@
+#ifndef PIX_SCALE_H_
+#define PIX_SCALE_H_
+
+#include <stdint.h>
+
+// 图像缩放：8位灰度或打包4bpp（高4位在前）-> 同格式
+// pix_scale_init按源/目标尺寸预先算好每列、每行的源坐标和权重，之后每帧只做查表和行运算，
+// 尺寸不变时（相机预览、同一帧率的动画）表可以一直复用
+// 行运算（双线性混合、区域累加、4bpp解包/打包）在__ARM_NEON下用向量实现，结果与标量逐位一致
+// 4bpp按0~15的灰度值运算，结果不会超出16级
+
+#define PIX_SCALE_NEAREST 0     // 最近邻，取目标像素中心对应的源像素
+#define PIX_SCALE_BILINEAR 1    // 双线性，权重7位，放大和小幅缩小用
+#define PIX_SCALE_BOX 2         // 区域平均（四舍五入），大幅缩小用；放大方向上退化为最近邻
+
+// 区域平均：每个方向最多合并PIX_SCALE_BOX_MAX个源像素（列累加和用uint16），单个区域不超过32768像素
+#define PIX_SCALE_BOX_MAX 257
+
+typedef struct {
+    uint16_t src_w, src_h;
+    uint16_t dst_w, dst_h;
+    uint8_t mode;
+    // 列表：最近邻只用x0；双线性为左右源列和权重（wa+wb=128）；区域平均为[x0, x1)
+    uint16_t* x0;
+    uint16_t* x1;
+    uint8_t* xwa;
+    uint8_t* xwb;
+    // 行表，含义同列表
+    uint16_t* y0;
+    uint16_t* y1;
+    uint8_t* ywa;
+    uint8_t* ywb;
+    // 区域平均：每个方向区域宽度只有lo和lo+1两种，四种面积各自的倒数（定点）
+    uint16_t box_nx, box_ny;
+    uint64_t box_inv[2][2];
+    // 工作缓冲
+    uint8_t* unpack;            // 4bpp源行解包
+    uint8_t* line;              // 4bpp输出行打包前
+    uint8_t* ga;                // 双线性水平方向取到的左右像素
+    uint8_t* gb;
+    uint8_t* hrow[2];           // 双线性：水平缩放后的两行，按源行号缓存
+    int32_t hrow_y[2];
+    uint16_t* colsum;           // 区域平均：列累加和
+} pix_scale_t;
+
+// 成功返回0；尺寸为0、超出区域平均的限制或内存不足返回-1
+int pix_scale_init(pix_scale_t* s, uint32_t src_w, uint32_t src_h, uint32_t dst_w, uint32_t dst_h, uint8_t mode);
+void pix_scale_free(pix_scale_t* s);
+// stride为每行字节数；4bpp行宽为(w+1)/2字节，奇数宽度最后一个字节的低4位写0
+void pix_scale_gray8(pix_scale_t* s, const uint8_t* src, uint32_t src_stride, uint8_t* dst, uint32_t dst_stride);
+void pix_scale_4bpp(pix_scale_t* s, const uint8_t* src, uint32_t src_stride, uint8_t* dst, uint32_t dst_stride);
+// 等比缩小到不超过max_w×max_h（本来就放得下时不变），结果至少1×1
+void pix_scale_fit(uint32_t src_w, uint32_t src_h, uint32_t max_w, uint32_t max_h, uint16_t* w, uint16_t* h);
+#endif
@@ -0,0 +1,119 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include "reactor.h"
+
+#define REACTOR_MAX_SOURCES 8
+
+typedef struct {
+    int fd;
+    reactor_cb_t cb;
+    void *arg;
+} reactor_source_t;
+
+static int epoll_fd = -1;
+static reactor_source_t sources[REACTOR_MAX_SOURCES];
+static int source_count = 0;
+
+int reactor_init(void) {
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0) {
+        perror("reactor_init: epoll_create1");
+        return -1;
+    }
+    return 0;
+}
+
+int reactor_add(int fd, reactor_cb_t cb, void *arg) {
+    struct epoll_event ev;
+
+    if (fd < 0 || source_count == REACTOR_MAX_SOURCES) {
+        printf("reactor_add: 无效的fd或事件源已满\n");
+        return -1;
+    }
+    sources[source_count].fd = fd;
+    sources[source_count].cb = cb;
+    sources[source_count].arg = arg;
+
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.ptr = &sources[source_count];
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        perror("reactor_add: epoll_ctl");
+        return -1;
+    }
+    source_count++;
+    return 0;
+}
+
+// 等待并分发一轮事件，返回处理的事件数；timeout_ms为-1时一直等
+int reactor_run_once(int timeout_ms) {
+    struct epoll_event evs[REACTOR_MAX_SOURCES];
+    int n = epoll_wait(epoll_fd, evs, REACTOR_MAX_SOURCES, timeout_ms);
+
+    if (n < 0) {
+        if (errno != EINTR) perror("reactor_run_once: epoll_wait");
+        return 0;
+    }
+    for (int i = 0; i < n; i++) {
+        reactor_source_t *src = evs[i].data.ptr;
+        src->cb(src->fd, src->arg);
+    }
+    return n;
+}
+
+int reactor_timer_create(void) {
+    int tfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+
+    if (tfd < 0) {
+        perror("reactor_timer_create: timerfd_create");
+    }
+    return tfd;
+}
+
+static int timer_set(int tfd, uint32_t first_ms, uint32_t period_ms) {
+    struct itimerspec its;
+
+    memset(&its, 0, sizeof(its));
+    if (first_ms != REACTOR_TIMER_OFF) {
+        // it_value全0表示停止，0ms改为1ns
+        its.it_value.tv_sec = first_ms / 1000;
+        its.it_value.tv_nsec = first_ms ? (long)(first_ms % 1000) * 1000000L : 1;
+        its.it_interval.tv_sec = period_ms / 1000;
+        its.it_interval.tv_nsec = (long)(period_ms % 1000) * 1000000L;
+    }
+    if (timerfd_settime(tfd, 0, &its, NULL) < 0) {
+        perror("reactor_timer: timerfd_settime");
+        return -1;
+    }
+    return 0;
+}
+
+int reactor_timer_arm(int tfd, uint32_t ms) {
+    return timer_set(tfd, ms, 0);
+}
+
+int reactor_timer_arm_periodic(int tfd, uint32_t period_ms) {
+    return timer_set(tfd, period_ms, period_ms);
+}
+
+// 读掉到期次数，否则epoll会一直报告可读
+void reactor_timer_ack(int tfd) {
+    uint64_t expirations;
+
+    if (read(tfd, &expirations, sizeof(expirations)) < 0 && errno != EAGAIN) {
+        perror("reactor_timer_ack: read");
+    }
+}
+
+uint32_t custom_tick_get(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
@@ -0,0 +1,25 @@
+#ifndef REACTOR_H_
+#define REACTOR_H_
+
+#include <stdint.h>
+
+// 显示主循环的事件分发：epoll等待所有文件描述符（UI命令eventfd、LVGL定时器、
+// 省电超时、IMU轮询的timerfd），有事件才唤醒，空闲时不再周期性醒来
+// 本头文件也由lv_conf.h包含（LV_TICK_CUSTOM），不能依赖lvgl
+
+typedef void (*reactor_cb_t)(int fd, void *arg);
+
+int reactor_init(void);
+int reactor_add(int fd, reactor_cb_t cb, void *arg);
+int reactor_run_once(int timeout_ms);
+
+// 单次触发的CLOCK_MONOTONIC定时器；ms为0时尽快触发，REACTOR_TIMER_OFF停止
+#define REACTOR_TIMER_OFF 0xFFFFFFFFu
+int reactor_timer_create(void);
+int reactor_timer_arm(int tfd, uint32_t ms);
+int reactor_timer_arm_periodic(int tfd, uint32_t period_ms);
+void reactor_timer_ack(int tfd);
+
+// LVGL心跳：CLOCK_MONOTONIC毫秒数（LV_TICK_CUSTOM_SYS_TIME_EXPR）
+uint32_t custom_tick_get(void);
+#endif
@@ -0,0 +1,272 @@
+// 字体转换工具：把LVGL字体源文件（lv_font_conv生成的未压缩格式）转成.gfnt二进制字体（格式见font_bin.h）
+// 在主机上与要转换的字体源文件一起编译，FONT_NAME为字体的变量名：
+//   gcc -I.. -I<LVGL_DIR> -DFONT_NAME=ui_font_alibaba_30 -o font_pack font_pack.c ../font_bin.c ../glyph_cache.c ../ui/fonts/ui_font_alibaba_30.c
+//   ./font_pack ui_font_alibaba_30.gfnt
+// 一般通过 make fonts 调用，输出到 build/fonts/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "font_bin.h"
+
+#define STR_(x) #x
+#define STR(x) STR_(x)
+
+extern const lv_font_t FONT_NAME;
+
+// 字体源文件引用了LVGL的取字形函数，这里只读它的数据，不需要链接LVGL
+bool lv_font_get_glyph_dsc_fmt_txt(const lv_font_t *font, lv_font_glyph_dsc_t *dsc_out, uint32_t unicode_letter, uint32_t unicode_letter_next) {
+    return false;
+}
+
+const uint8_t *lv_font_get_bitmap_fmt_txt(const lv_font_t *font, uint32_t letter) {
+    return NULL;
+}
+
+typedef struct {
+    uint32_t unicode;
+    uint32_t gid;       // LVGL字体里的字形序号
+} cmap_entry_t;
+
+static int cmp_cmap(const void *a, const void *b) {
+    const cmap_entry_t *x = a, *y = b;
+    return (x->unicode > y->unicode) - (x->unicode < y->unicode);
+}
+
+static int cmp_kern(const void *a, const void *b) {
+    const font_bin_kern_t *x = a, *y = b;
+    return (x->pair > y->pair) - (x->pair < y->pair);
+}
+
+// 展开所有码点区间
+static cmap_entry_t *collect_cmap(const lv_font_fmt_txt_dsc_t *fdsc, uint32_t *count) {
+    cmap_entry_t *list = NULL;
+    uint32_t n = 0, cap = 0;
+
+    for (uint32_t i = 0; i < fdsc->cmap_num; i++) {
+        const lv_font_fmt_txt_cmap_t *cm = &fdsc->cmaps[i];
+        uint32_t len = (cm->type == LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY ||
+                        cm->type == LV_FONT_FMT_TXT_CMAP_FORMAT0_FULL) ? cm->range_length : cm->list_length;
+
+        for (uint32_t j = 0; j < len; j++) {
+            cmap_entry_t e;
+
+            switch (cm->type) {
+            case LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY:
+                e.unicode = cm->range_start + j;
+                e.gid = cm->glyph_id_start + j;
+                break;
+            case LV_FONT_FMT_TXT_CMAP_FORMAT0_FULL:
+                e.unicode = cm->range_start + j;
+                e.gid = cm->glyph_id_start + ((const uint8_t *)cm->glyph_id_ofs_list)[j];
+                break;
+            case LV_FONT_FMT_TXT_CMAP_SPARSE_TINY:
+                e.unicode = cm->range_start + cm->unicode_list[j];
+                e.gid = cm->glyph_id_start + j;
+                break;
+            default:
+                e.unicode = cm->range_start + cm->unicode_list[j];
+                e.gid = cm->glyph_id_start + ((const uint16_t *)cm->glyph_id_ofs_list)[j];
+                break;
+            }
+            if (e.gid == 0) continue;
+            if (n == cap) {
+                cap = cap ? cap * 2 : 256;
+                list = realloc(list, cap * sizeof(cmap_entry_t));
+                if (list == NULL) {
+                    perror("realloc");
+                    exit(1);
+                }
+            }
+            list[n++] = e;
+        }
+    }
+    qsort(list, n, sizeof(cmap_entry_t), cmp_cmap);
+    *count = n;
+    return list;
+}
+
+// 字距：按新的字形序号展开成(左, 右)对，值乘上kern_scale
+static font_bin_kern_t *collect_kern(const lv_font_fmt_txt_dsc_t *fdsc, const int32_t *index, uint32_t max_gid,
+                                     uint32_t *count) {
+    font_bin_kern_t *list = NULL;
+    uint32_t n = 0, cap = 0;
+
+#define KERN_ADD(l, r, v) do {                                                          \
+        if ((l) <= max_gid && (r) <= max_gid && index[l] >= 0 && index[r] >= 0 && (v) != 0) { \
+            if (n == cap) {                                                             \
+                cap = cap ? cap * 2 : 256;                                              \
+                list = realloc(list, cap * sizeof(font_bin_kern_t));                    \
+                if (list == NULL) { perror("realloc"); exit(1); }                       \
+            }                                                                           \
+            list[n].pair = (uint32_t)index[l] << 16 | (uint32_t)index[r];               \
+            list[n].value = (int16_t)(((int32_t)(v) * fdsc->kern_scale) >> 4);          \
+            list[n].reserved = 0;                                                       \
+            n++;                                                                        \
+        }                                                                               \
+    } while (0)
+
+    if (fdsc->kern_dsc == NULL) {
+        *count = 0;
+        return NULL;
+    }
+    if (fdsc->kern_classes == 0) {
+        const lv_font_fmt_txt_kern_pair_t *kp = fdsc->kern_dsc;
+
+        for (uint32_t i = 0; i < kp->pair_cnt; i++) {
+            uint32_t l, r;
+
+            if (kp->glyph_ids_size == 0) {
+                l = ((const uint8_t *)kp->glyph_ids)[2 * i];
+                r = ((const uint8_t *)kp->glyph_ids)[2 * i + 1];
+            } else {
+                l = ((const uint16_t *)kp->glyph_ids)[2 * i];
+                r = ((const uint16_t *)kp->glyph_ids)[2 * i + 1];
+            }
+            KERN_ADD(l, r, kp->values[i]);
+        }
+    } else {
+        const lv_font_fmt_txt_kern_classes_t *kc = fdsc->kern_dsc;
+
+        for (uint32_t l = 1; l <= max_gid; l++) {
+            uint8_t lc = kc->left_class_mapping[l];
+            if (lc == 0) continue;
+            for (uint32_t r = 1; r <= max_gid; r++) {
+                uint8_t rc = kc->right_class_mapping[r];
+                if (rc == 0) continue;
+                KERN_ADD(l, r, kc->class_pair_values[(lc - 1) * kc->right_class_cnt + (rc - 1)]);
+            }
+        }
+    }
+#undef KERN_ADD
+
+    qsort(list, n, sizeof(font_bin_kern_t), cmp_kern);
+    *count = n;
+    return list;
+}
+
+static void write_all(FILE *f, const void *buf, size_t len, const char *path) {
+    if (len > 0 && fwrite(buf, 1, len, f) != len) {
+        perror(path);
+        exit(1);
+    }
+}
+
+int main(int argc, char **argv) {
+    const lv_font_t *font = &FONT_NAME;
+    const lv_font_fmt_txt_dsc_t *fdsc = font->dsc;
+    font_bin_header_t hdr;
+    font_bin_glyph_t *glyphs;
+    font_bin_kern_t *kerns;
+    cmap_entry_t *cmap;
+    uint32_t glyph_count, kern_count, max_gid = 0;
+    uint32_t *codes;
+    int32_t *index;
+    uint8_t *bitmaps;
+    size_t bitmap_size = 0, bitmap_cap = 0, raw_size = 0;
+    FILE *f;
+
+    if (argc != 2) {
+        fprintf(stderr, "用法: %s 输出文件.gfnt\n", argv[0]);
+        return 1;
+    }
+    if (fdsc->bitmap_format != LV_FONT_FMT_TXT_PLAIN) {
+        fprintf(stderr, "%s: 只支持未压缩的字体源文件（lv_font_conv --no-compress）\n", STR(FONT_NAME));
+        return 1;
+    }
+
+    cmap = collect_cmap(fdsc, &glyph_count);
+    if (glyph_count > 0xFFFF) {
+        fprintf(stderr, "%s: 字形太多（%u）\n", STR(FONT_NAME), glyph_count);
+        return 1;
+    }
+    for (uint32_t i = 0; i < glyph_count; i++) {
+        if (cmap[i].gid > max_gid) max_gid = cmap[i].gid;
+    }
+    index = malloc((max_gid + 1) * sizeof(int32_t));
+    codes = malloc((glyph_count + 1) * sizeof(uint32_t));
+    glyphs = calloc(glyph_count + 1, sizeof(font_bin_glyph_t));
+    if (index == NULL || codes == NULL || glyphs == NULL) {
+        perror("malloc");
+        return 1;
+    }
+    memset(index, 0xFF, (max_gid + 1) * sizeof(int32_t));
+
+    // 字形和压缩位图
+    bitmaps = NULL;
+    for (uint32_t i = 0; i < glyph_count; i++) {
+        const lv_font_fmt_txt_glyph_dsc_t *gd = &fdsc->glyph_dsc[cmap[i].gid];
+        size_t len = ((size_t)gd->box_w * gd->box_h * fdsc->bpp + 7) / 8;
+        size_t bound = font_bin_comp_bound(gd->box_w, gd->box_h, fdsc->bpp);
+        size_t comp;
+
+        index[cmap[i].gid] = (int32_t)i;
+        codes[i] = cmap[i].unicode;
+        if (bitmap_size + bound > bitmap_cap) {
+            bitmap_cap = (bitmap_cap + bound) * 2;
+            bitmaps = realloc(bitmaps, bitmap_cap);
+            if (bitmaps == NULL) {
+                perror("realloc");
+                return 1;
+            }
+        }
+        glyphs[i].bitmap = (uint32_t)bitmap_size;
+        glyphs[i].adv_w = (uint16_t)gd->adv_w;
+        glyphs[i].box_w = (uint8_t)gd->box_w;
+        glyphs[i].box_h = (uint8_t)gd->box_h;
+        glyphs[i].ofs_x = (int8_t)gd->ofs_x;
+        glyphs[i].ofs_y = (int8_t)gd->ofs_y;
+        comp = font_bin_compress(fdsc->glyph_bitmap + gd->bitmap_index, gd->box_w, gd->box_h, fdsc->bpp,
+                                 bitmaps + bitmap_size);
+        if (comp > 0xFFFF) {
+            fprintf(stderr, "%s: U+%04X 的位图太大\n", STR(FONT_NAME), (unsigned)cmap[i].unicode);
+            return 1;
+        }
+        glyphs[i].comp_len = (uint16_t)comp;
+        bitmap_size += comp;
+        raw_size += len;
+    }
+    kerns = collect_kern(fdsc, index, max_gid, &kern_count);
+
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.magic = FONT_BIN_MAGIC;
+    hdr.version = FONT_BIN_VERSION;
+    hdr.bpp = (uint8_t)fdsc->bpp;
+    hdr.line_height = font->line_height;
+    hdr.base_line = font->base_line;
+    hdr.underline_position = font->underline_position;
+    hdr.underline_thickness = font->underline_thickness;
+    hdr.glyph_count = glyph_count;
+    hdr.kern_count = kern_count;
+    hdr.cmap_off = sizeof(hdr);
+    hdr.glyph_off = hdr.cmap_off + glyph_count * sizeof(uint32_t);
+    hdr.kern_off = hdr.glyph_off + glyph_count * sizeof(font_bin_glyph_t);
+    hdr.bitmap_off = hdr.kern_off + kern_count * sizeof(font_bin_kern_t);
+    hdr.bitmap_size = (uint32_t)bitmap_size;
+
+    f = fopen(argv[1], "wb");
+    if (f == NULL) {
+        perror(argv[1]);
+        return 1;
+    }
+    write_all(f, &hdr, sizeof(hdr), argv[1]);
+    write_all(f, codes, glyph_count * sizeof(uint32_t), argv[1]);
+    write_all(f, glyphs, glyph_count * sizeof(font_bin_glyph_t), argv[1]);
+    write_all(f, kerns, kern_count * sizeof(font_bin_kern_t), argv[1]);
+    write_all(f, bitmaps, bitmap_size, argv[1]);
+    if (fclose(f) != 0) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    printf("%s: %u 个字形, %u 对字距, 位图 %zu -> %zu 字节, 文件 %zu 字节\n", STR(FONT_NAME), glyph_count,
+           kern_count, raw_size, bitmap_size, (size_t)hdr.bitmap_off + bitmap_size);
+    printf("FONT_BIN_DEFINE(%s, %d, %d, %d, %d);\n", STR(FONT_NAME), font->line_height, font->base_line,
+           font->underline_position, font->underline_thickness);
+    free(cmap);
+    free(index);
+    free(codes);
+    free(glyphs);
+    free(kerns);
+    free(bitmaps);
+    return 0;
+}
@@ -4,6 +4,7 @@
 // Project name: SquareLine_Project
 
 #include "../ui.h"
+#include "../../caption_log.h"
 // 在main.c的全局变量区域添加
 extern lv_obj_t *ui_Label2;  // 声明外部变量，指向"微笑"标签
 
@@ -116,17 +117,15 @@ void ui_Screen1_screen_init(void)
         lv_obj_set_style_text_line_space(ui_TeleprompTerTxT, 10, LV_PART_MAIN | LV_STATE_DEFAULT);
         lv_obj_set_style_text_color(ui_TeleprompTerTxT, lv_color_white(), LV_PART_MAIN | LV_STATE_DEFAULT);
 
-        // 迁移过来的主提示标签 ui_Label2（默认隐藏）
-        ui_Label2 = lv_label_create(text_cont);
+        // 迁移过来的主提示标签 ui_Label2（默认隐藏）：字幕日志控件，填满容器，新行平滑滚入
+        ui_Label2 = caption_log_create(text_cont);
         lv_obj_set_width(ui_Label2, LV_PCT(100));
-        lv_obj_set_height(ui_Label2, LV_SIZE_CONTENT);
+        lv_obj_set_height(ui_Label2, LV_PCT(100));
         lv_obj_set_align(ui_Label2, LV_ALIGN_TOP_LEFT);
-        lv_label_set_text(ui_Label2, "通过触摸左镜腿进入菜单");
         lv_obj_set_style_text_font(ui_Label2, &ui_font_alibaba_48, LV_PART_MAIN | LV_STATE_DEFAULT);
-        lv_label_set_long_mode(ui_Label2, LV_LABEL_LONG_WRAP);
-        lv_obj_set_style_text_align(ui_Label2, LV_TEXT_ALIGN_LEFT, LV_PART_MAIN | LV_STATE_DEFAULT);
         lv_obj_set_style_text_line_space(ui_Label2, 10, LV_PART_MAIN | LV_STATE_DEFAULT);
         lv_obj_set_style_text_color(ui_Label2, lv_color_white(), LV_PART_MAIN | LV_STATE_DEFAULT);
+        caption_log_set_hint(ui_Label2, "通过触摸左镜腿进入菜单");
         lv_obj_add_flag(ui_Label2, LV_OBJ_FLAG_HIDDEN);
     //yf
 
@@ -0,0 +1,204 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include "ui_queue.h"
+#include "glyph_cache.h"
+
+ui_queue_t ui_ipc_queue;        // display_update_thread -> LVGL线程
+
+static int ui_event_fd = -1;
+
+int ui_queue_init(void) {
+    ui_event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (ui_event_fd < 0) {
+        perror("ui_queue_init: eventfd");
+        return -1;
+    }
+    return 0;
+}
+
+// 生产者：先拷贝命令，再以release发布head，消费者acquire读到head后命令内容一定可见
+bool ui_queue_push(ui_queue_t *q, const ui_cmd_t *cmd) {
+    uint32_t head = __atomic_load_n(&q->head, __ATOMIC_RELAXED);
+    uint32_t tail = __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE);
+
+    if (head - tail == UI_QUEUE_LEN) return false;
+    q->cmd[head & (UI_QUEUE_LEN - 1)] = *cmd;
+    __atomic_store_n(&q->head, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+// 队列满时唤醒LVGL线程并等它腾出位置，命令不丢弃
+void ui_queue_post(ui_queue_t *q, const ui_cmd_t *cmd) {
+    while (!ui_queue_push(q, cmd)) {
+        ui_queue_wake();
+        usleep(1000);
+    }
+}
+
+bool ui_queue_pop(ui_queue_t *q, ui_cmd_t *cmd) {
+    uint32_t tail = __atomic_load_n(&q->tail, __ATOMIC_RELAXED);
+    uint32_t head = __atomic_load_n(&q->head, __ATOMIC_ACQUIRE);
+
+    if (head == tail) return false;
+    *cmd = q->cmd[tail & (UI_QUEUE_LEN - 1)];
+    __atomic_store_n(&q->tail, tail + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+void ui_queue_wake(void) {
+    uint64_t one = 1;
+
+    if (ui_event_fd < 0) return;
+    if (write(ui_event_fd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+        perror("ui_queue_wake: write");
+    }
+}
+
+int ui_queue_fd(void) {
+    return ui_event_fd;
+}
+
+// LVGL线程：eventfd可读后清零计数，再取空队列
+void ui_queue_ack(void) {
+    uint64_t count;
+
+    if (read(ui_event_fd, &count, sizeof(count)) < 0 && errno != EAGAIN) {
+        perror("ui_queue_ack: read");
+    }
+}
+
+// 在LVGL线程执行通用命令；UI_CMD_MESSAGE等应用相关的命令由调用者处理
+void ui_cmd_apply(const ui_cmd_t *cmd) {
+    lv_obj_t *obj = cmd->obj ? *cmd->obj : NULL;
+
+    switch (cmd->type) {
+    case UI_CMD_REFRESH:
+        lv_obj_invalidate(lv_scr_act());
+        lv_refr_now(lv_disp_get_default());
+        return;
+    default:
+        break;
+    }
+    if (obj == NULL) return;
+
+    switch (cmd->type) {
+    case UI_CMD_ADD_FLAG:
+        lv_obj_add_flag(obj, cmd->flag);
+        break;
+    case UI_CMD_CLEAR_FLAG:
+        lv_obj_clear_flag(obj, cmd->flag);
+        break;
+    case UI_CMD_SET_POS:
+        lv_obj_set_pos(obj, cmd->x, cmd->y);
+        break;
+    case UI_CMD_MOVE:
+        lv_obj_set_pos(obj, lv_obj_get_x(obj) + cmd->x, lv_obj_get_y(obj) + cmd->y);
+        break;
+    case UI_CMD_SET_TEXT:
+        lv_label_set_text(obj, cmd->text);
+        break;
+    case UI_CMD_SET_TEXT_OPA:
+        lv_obj_set_style_text_opa(obj, cmd->opa, LV_PART_MAIN | LV_STATE_DEFAULT);
+        break;
+    case UI_CMD_SET_TEXT_FONT:
+        lv_obj_set_style_text_font(obj, glyph_cache_resolve(cmd->font), LV_PART_MAIN | LV_STATE_DEFAULT);
+        break;
+    case UI_CMD_SCROLL_BOTTOM:
+        lv_obj_scroll_to_y(obj, LV_COORD_MAX, LV_ANIM_OFF);
+        break;
+    default:
+        printf("ui_cmd_apply: 未知命令 %u\n", cmd->type);
+        break;
+    }
+}
+
+// ================== display_update_thread 便捷函数 ==================
+// ui_cmd_t带文本副本，较大，放在静态区；只有display_update_thread调用，不需要加锁
+static ui_cmd_t post_cmd;
+
+static ui_cmd_t *post_begin(uint8_t type, lv_obj_t **obj) {
+    post_cmd.type = type;
+    post_cmd.obj = obj;
+    post_cmd.text[0] = '\0';
+    return &post_cmd;
+}
+
+void ui_post_add_flag(lv_obj_t **obj, uint32_t flag) {
+    ui_cmd_t *cmd = post_begin(UI_CMD_ADD_FLAG, obj);
+    cmd->flag = flag;
+    ui_queue_post(&ui_ipc_queue, cmd);
+}
+
+void ui_post_clear_flag(lv_obj_t **obj, uint32_t flag) {
+    ui_cmd_t *cmd = post_begin(UI_CMD_CLEAR_FLAG, obj);
+    cmd->flag = flag;
+    ui_queue_post(&ui_ipc_queue, cmd);
+}
+
+void ui_post_set_pos(lv_obj_t **obj, lv_coord_t x, lv_coord_t y) {
+    ui_cmd_t *cmd = post_begin(UI_CMD_SET_POS, obj);
+    cmd->x = x;
+    cmd->y = y;
+    ui_queue_post(&ui_ipc_queue, cmd);
+}
+
+void ui_post_move(lv_obj_t **obj, lv_coord_t dx, lv_coord_t dy) {
+    ui_cmd_t *cmd = post_begin(UI_CMD_MOVE, obj);
+    cmd->x = dx;
+    cmd->y = dy;
+    ui_queue_post(&ui_ipc_queue, cmd);
+}
+
+void ui_post_set_text(lv_obj_t **obj, const char *text) {
+    ui_cmd_t *cmd = post_begin(UI_CMD_SET_TEXT, obj);
+    snprintf(cmd->text, sizeof(cmd->text), "%s", text);
+    ui_queue_post(&ui_ipc_queue, cmd);
+}
+
+void ui_post_set_text_opa(lv_obj_t **obj, lv_opa_t opa) {
+    ui_cmd_t *cmd = post_begin(UI_CMD_SET_TEXT_OPA, obj);
+    cmd->opa = opa;
+    ui_queue_post(&ui_ipc_queue, cmd);
+}
+
+void ui_post_set_text_font(lv_obj_t **obj, const lv_font_t *font) {
+    ui_cmd_t *cmd = post_begin(UI_CMD_SET_TEXT_FONT, obj);
+    cmd->font = font;
+    ui_queue_post(&ui_ipc_queue, cmd);
+}
+
+void ui_post_scroll_bottom(lv_obj_t **obj) {
+    ui_queue_post(&ui_ipc_queue, post_begin(UI_CMD_SCROLL_BOTTOM, obj));
+}
+
+void ui_post_refresh(void) {
+    ui_queue_post(&ui_ipc_queue, post_begin(UI_CMD_REFRESH, NULL));
+}
+
+// text为共享内存里的消息（最多len字节，不一定有结束符），拷贝一份，LVGL线程不再直接读共享内存
+void ui_post_message(const char *text, size_t len, bool append, bool cont) {
+    ui_cmd_t *cmd = post_begin(UI_CMD_MESSAGE, NULL);
+    cmd->append = append;
+    cmd->cont = cont;
+    snprintf(cmd->text, sizeof(cmd->text), "%.*s", (int)strnlen(text, len), text);
+    ui_queue_post(&ui_ipc_queue, cmd);
+}
+
+// 文档由LVGL线程打开和排版，这里只传文档序号和翻页方向
+void ui_post_page(int doc, int step) {
+    ui_cmd_t *cmd = post_begin(UI_CMD_PAGE, NULL);
+    cmd->x = (lv_coord_t)doc;
+    cmd->y = (lv_coord_t)step;
+    ui_queue_post(&ui_ipc_queue, cmd);
+}
+
+void ui_post_auto_scroll(int doc) {
+    ui_cmd_t *cmd = post_begin(UI_CMD_AUTO_SCROLL, NULL);
+    cmd->x = (lv_coord_t)doc;
+    ui_queue_post(&ui_ipc_queue, cmd);
+}
+// ================== display_update_thread 便捷函数结束 ==================
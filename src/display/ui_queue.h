@@ -0,0 +1,73 @@
+#ifndef UI_QUEUE_H_
+#define UI_QUEUE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "lvgl/lvgl.h"
+
+// UI命令队列：LVGL不是线程安全的，其他线程不直接调用lv_*，
+// 而是把类型化的命令放入单生产者/单消费者环形队列，由main()里的LVGL线程取出执行
+// 每个生产者线程一个队列（目前只有display_update_thread的ui_ipc_queue），
+// 所有队列共用一个eventfd，LVGL线程的reactor等待它，有命令时立即唤醒
+#define UI_QUEUE_LEN 64         // 必须是2的幂
+#define UI_CMD_TEXT_MAX 320     // 文本命令携带的副本长度（含结束符）
+
+// 命令类型
+#define UI_CMD_ADD_FLAG 0       // lv_obj_add_flag
+#define UI_CMD_CLEAR_FLAG 1     // lv_obj_clear_flag
+#define UI_CMD_SET_POS 2        // lv_obj_set_pos
+#define UI_CMD_MOVE 3           // 在当前位置上偏移(x, y)
+#define UI_CMD_SET_TEXT 4       // lv_label_set_text
+#define UI_CMD_SET_TEXT_OPA 5   // lv_obj_set_style_text_opa（LV_PART_MAIN | LV_STATE_DEFAULT）
+#define UI_CMD_SET_TEXT_FONT 6  // lv_obj_set_style_text_font（LV_PART_MAIN | LV_STATE_DEFAULT）
+#define UI_CMD_SCROLL_BOTTOM 7  // 滚动到底
+#define UI_CMD_REFRESH 8        // 整屏失效并立即刷新
+#define UI_CMD_MESSAGE 9        // 一条消息处理完：累加文本并刷新（由main.c执行）
+#define UI_CMD_PAGE 10          // 文档翻页：x为文档序号，y为方向（由main.c执行）
+#define UI_CMD_AUTO_SCROLL 11   // 开始/停止文档的自动滚动：x为文档序号（由main.c执行）
+
+typedef struct {
+    uint8_t type;
+    bool append;                // UI_CMD_MESSAGE：text是否加入累积文本
+    bool cont;                  // UI_CMD_MESSAGE：接在上一条字幕后面（MSG_TYPE_TEXT_CONT），不另起一行
+    lv_obj_t **obj;             // 指向ui_*全局变量，执行时再取值，对象未创建时忽略
+    uint32_t flag;
+    lv_coord_t x;
+    lv_coord_t y;
+    lv_opa_t opa;
+    const lv_font_t *font;
+    char text[UI_CMD_TEXT_MAX];
+} ui_cmd_t;
+
+typedef struct {
+    ui_cmd_t cmd[UI_QUEUE_LEN];
+    uint32_t head;              // 只由生产者写
+    uint32_t tail;              // 只由消费者写
+} ui_queue_t;
+
+extern ui_queue_t ui_ipc_queue;
+
+int ui_queue_init(void);
+bool ui_queue_push(ui_queue_t *q, const ui_cmd_t *cmd);
+void ui_queue_post(ui_queue_t *q, const ui_cmd_t *cmd);
+bool ui_queue_pop(ui_queue_t *q, ui_cmd_t *cmd);
+void ui_queue_wake(void);
+int ui_queue_fd(void);
+void ui_queue_ack(void);
+void ui_cmd_apply(const ui_cmd_t *cmd);
+
+// display_update_thread专用：放入ui_ipc_queue，处理完一条消息后调用ui_queue_wake
+void ui_post_add_flag(lv_obj_t **obj, uint32_t flag);
+void ui_post_clear_flag(lv_obj_t **obj, uint32_t flag);
+void ui_post_set_pos(lv_obj_t **obj, lv_coord_t x, lv_coord_t y);
+void ui_post_move(lv_obj_t **obj, lv_coord_t dx, lv_coord_t dy);
+void ui_post_set_text(lv_obj_t **obj, const char *text);
+void ui_post_set_text_opa(lv_obj_t **obj, lv_opa_t opa);
+void ui_post_set_text_font(lv_obj_t **obj, const lv_font_t *font);
+void ui_post_scroll_bottom(lv_obj_t **obj);
+void ui_post_refresh(void);
+void ui_post_message(const char *text, size_t len, bool append, bool cont);
+void ui_post_page(int doc, int step);
+void ui_post_auto_scroll(int doc);
+#endif
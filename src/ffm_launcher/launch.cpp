@@ -7,13 +7,13 @@
 #include <sys/ioctl.h>
 #include <linux/videodev2.h>
 #include <sys/mman.h>
-#include <semaphore.h>
 #include <sys/stat.h>
 #include <cstdarg> 
 #include <time.h> // 引入时间相关头文件用于日志
 #include <stdint.h> // 引入 uint32_t 等类型
 #include <sys/wait.h> // 用于 system() 的返回值检查
 #include <signal.h> // 信号处理
+#include "msg_bus.h" // display的共享内存消息总线
 
 // --- Camera Config ---
 #define DEVICE "/dev/video7"
@@ -22,9 +22,8 @@
 // ---------------------
 
 // --- IPC Config (与 display/main.c 保持一致) ---
-#define SHM_NAME "/display_shm" // 共享内存名称
-#define SEM_NAME "/display_sem" // 信号量名称
-#define BUFFER_SIZE 128         // 消息缓冲区大小
+#define BUS_SUB_NAME "ffm"               // 在消息总线上的订阅者名
+#define BUFFER_SIZE MSG_BUS_PAYLOAD_MAX  // 消息缓冲区大小
 // -----------------------------------------------
 
 // --- 日志宏定义 (简化版，与 display/main.c 风格类似) ---
@@ -81,9 +80,7 @@ void log_debug(const char *format, ...) {
 // --------------------------------------------------------
 
 // 全局变量用于 cleanup (与 display/main.c 保持一致)
-static int shm_fd = -1;
-static void *shared_memory = MAP_FAILED;
-static sem_t *semaphore = SEM_FAILED;
+static msg_bus_t display_bus;
 static volatile sig_atomic_t running = 1; // 用于信号处理
 
 // 信号处理函数 (与 display/main.c 保持一致)
@@ -91,38 +88,12 @@ void cleanup(int sig) {
     log_info("Received signal %d, cleaning up...", sig);
     running = 0; // 设置运行标志为假
 
-    // 清理共享内存映射
-    if (shared_memory != MAP_FAILED) {
-        if (munmap(shared_memory, BUFFER_SIZE) == -1) {
-            log_error("Failed to unmap shared memory: %s", strerror(errno));
-        } else {
-            log_debug("Shared memory unmapped.");
-        }
-        shared_memory = MAP_FAILED;
-    }
-
-    // 关闭共享内存文件描述符 (注意：display中未明确close shm_fd，但最好加上)
-    if (shm_fd != -1) {
-        close(shm_fd);
-        shm_fd = -1;
-        log_debug("Shared memory file descriptor closed.");
+    // 注销订阅并解除映射；总线由所有进程共用，这里不 unlink
+    if (display_bus.shm != NULL) {
+        msg_bus_close(&display_bus);
+        log_debug("Message bus closed.");
     }
 
-    // 关闭信号量
-    if (semaphore != SEM_FAILED) {
-        if (sem_close(semaphore) == -1) {
-            log_error("Failed to close semaphore: %s", strerror(errno));
-        } else {
-            log_debug("Semaphore closed.");
-        }
-        // 注意：通常由创建者 unlink，这里不主动 unlink
-        // sem_unlink(SEM_NAME);
-        semaphore = SEM_FAILED;
-    }
-
-    // 注意：通常由创建者 unlink，这里不主动 unlink 共享内存对象
-    // shm_unlink(SHM_NAME);
-
     log_info("Cleanup completed. Exiting.");
     exit(EXIT_SUCCESS);
 }
@@ -376,22 +347,12 @@ void process_capture()
         return;
     }
 
-    // 发送"PhotoCaptured"信号到共享内存
-    log_debug("Sending PhotoCaptured signal to shared memory...");
-    const char* photo_captured_msg = "PhotoCaptured";
-    memset(shared_memory, 0, BUFFER_SIZE); // 清空共享内存
-    strncpy((char*)shared_memory, photo_captured_msg, BUFFER_SIZE - 1);
-    ((char*)shared_memory)[BUFFER_SIZE - 1] = '\0'; // 确保字符串结束
-    
-    // 通知其他进程
-    if (semaphore != SEM_FAILED) {
-        if (sem_post(semaphore) == -1) {
-            log_error("Failed to post semaphore for PhotoCaptured signal: %s", strerror(errno));
-        } else {
-            log_info("PhotoCaptured signal sent successfully to shared memory.");
-        }
+    // 发布"PhotoCaptured"信号到消息总线，所有订阅者（display等）各收到一份
+    log_debug("Publishing PhotoCaptured signal to message bus...");
+    if (msg_bus_publish_text(&display_bus, "PhotoCaptured") != 0) {
+        log_error("Failed to publish PhotoCaptured signal.");
     } else {
-        log_error("Semaphore not available, cannot notify other processes.");
+        log_info("PhotoCaptured signal published to message bus.");
     }
 
     log_info("BLE transmission triggered successfully.");
@@ -407,66 +368,45 @@ int main()
     signal(SIGINT, cleanup);
     signal(SIGTERM, cleanup);
 
-    // --- 初始化 IPC (监听已存在的 display_sem 和 display_shm) ---
-    // 1. 打开已存在的共享内存 (由 display 程序创建)
-    log_debug("Opening existing shared memory object %s...", SHM_NAME);
-    shm_fd = shm_open(SHM_NAME, O_RDWR, 0666);
-    if (shm_fd == -1) {
-        log_error("shm_open failed: %s", strerror(errno));
+    // --- 初始化 IPC (打开消息总线并订阅；不存在时创建，与 display 的启动顺序无关) ---
+    log_debug("Opening message bus %s...", MSG_BUS_NAME);
+    if (msg_bus_open(&display_bus, NULL) != 0) {
+        log_error("msg_bus_open failed.");
         cleanup(0); // 使用 cleanup 进行统一清理
         return -1;
     }
-    log_debug("Shared memory object opened successfully (fd: %d).", shm_fd);
-
-    // 2. 映射共享内存到进程地址空间
-    log_debug("Mapping shared memory...");
-    shared_memory = mmap(NULL, BUFFER_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
-    if (shared_memory == MAP_FAILED) {
-        log_error("mmap failed: %s", strerror(errno));
-        cleanup(0);
-        return -1;
-    }
-    log_debug("Shared memory mapped successfully at %p.", shared_memory);
-
-    // 3. 关闭文件描述符 (因为我们已经映射了)
-    close(shm_fd);
-    shm_fd = -1; // 标记为已关闭
-    log_debug("Shared memory file descriptor closed.");
-
-    // 4. 打开已存在的信号量 (由 display 程序创建)
-    log_debug("Opening existing semaphore %s...", SEM_NAME);
-    semaphore = sem_open(SEM_NAME, 0); // 不创建，只打开
-    if (semaphore == SEM_FAILED) {
-        log_error("sem_open failed: %s", strerror(errno));
+    if (msg_bus_subscribe(&display_bus, BUS_SUB_NAME) != 0) {
+        log_error("msg_bus_subscribe failed.");
         cleanup(0);
         return -1;
     }
-    log_debug("Semaphore opened successfully.");
     // --- IPC 初始化完成 ---
 
-    log_info("Listening for signals on shared memory %s via semaphore %s (created by display program)...", SHM_NAME, SEM_NAME);
+    log_info("Listening for signals on message bus %s as '%s'...", MSG_BUS_NAME, BUS_SUB_NAME);
 
-    // --- 主循环：监听共享内存变化 (逻辑与 display/main.c 中的 display_update_thread 类似) ---
+    // --- 主循环：接收总线消息 (逻辑与 display/main.c 中的 display_update_thread 类似) ---
+    // 旧协议下 display 和本程序抢同一个信号量，一条消息只有一方能收到；
+    // 总线上每个订阅者都有自己的读游标，btgatt-server 写的旧协议消息由 display 转发过来
     char last_message[BUFFER_SIZE] = {0};
+    msg_bus_msg_t msg;
     while (running) { // 使用 running 标志控制循环
-        // 等待信号量
-        log_debug("Waiting on semaphore...");
-        if (sem_wait(semaphore) == -1) {
-            if (errno == EINTR) {
-                log_info("sem_wait interrupted by signal, checking running flag...");
-                continue; // 处理中断信号，检查 running 标志
-            }
-            log_error("sem_wait failed: %s", strerror(errno));
+        log_debug("Waiting on message bus...");
+        if (msg_bus_recv(&display_bus, &msg, -1) < 0) {
+            log_error("msg_bus_recv failed.");
             break; // Exit loop on other errors
         }
-        log_debug("Semaphore acquired.");
+        if (msg.lost > 0) {
+            log_error("Lost %u messages (subscriber fell behind).", msg.lost);
+        }
+        // 只处理文本命令，忽略自己发布的消息（PhotoCaptured）
+        if (msg.type != MSG_TYPE_TEXT || msg.sender == (int32_t)getpid()) {
+            continue;
+        }
 
-        // 检查共享内存中的信号
         char current_message[BUFFER_SIZE] = {0}; // 初始化为0
-        // 使用 memcpy 确保不会因为源内存未完全初始化而读取垃圾
-        memcpy(current_message, (char *)shared_memory, BUFFER_SIZE - 1);
+        memcpy(current_message, msg.payload, msg.len);
         current_message[BUFFER_SIZE - 1] = '\0'; // 确保字符串结束
-        log_info("Received signal from shared memory: '%s'", current_message); // 打印原始信号
+        log_info("Received signal from message bus: '%s'", current_message); // 打印原始信号
 
         // --- 核心逻辑：解析信号并触发拍照 ---
         // 移除重复检查，每次都处理
@@ -490,11 +430,6 @@ int main()
             }
         }
         // --- 信号处理完成 ---
-
-        // 注意：不像 display/main.c 那样清空 shared_memory，
-        // 因为其他进程（如 btgatt-server）可能需要读取它。
-        // 如果需要清空，取消下面一行的注释。
-        // memset(shared_memory, 0, BUFFER_SIZE);
     }
     // --- 主循环结束 ---
 
@@ -7,7 +7,6 @@
 #include <errno.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
-#include <semaphore.h>
 #include <signal.h>
 #include <sys/wait.h>
 #include <time.h>
@@ -15,16 +14,16 @@
 #include <netinet/in.h>      // 定义 sockaddr_in 结构体
 #include <arpa/inet.h>       // 网络地址转换函数
 #include <net/if.h>          // 定义 IFF_UP 和 IFF_RUNNING 标志
+#include "msg_bus.h"         // display的共享内存消息总线
+#include "display_cmds.h"    // display的命令表
 
 #define GPIO_SYSFS_PATH "/sys/class/gpio"
 #define GPIO_DEBUG_PATH "/sys/kernel/debug/gpio"
 #define POLL_INTERVAL_MS 50  // 检测间隔50ms
 
 // IPC相关定义
-// 应该使用与display程序完全相同的定义
-#define SHM_NAME "/display_shm"       // 共享内存名称 - 与display程序一致
-#define SEM_NAME "/display_sem"       // 信号量名称 - 与display程序一致
-#define BUFFER_SIZE 128               // 缓冲区大小 - 与display程序一致
+// 消息通过display的消息总线（msg_bus.h）发送，不再写单槽位的 /display_shm
+#define BUFFER_SIZE MSG_BUS_PAYLOAD_MAX  // 消息最大长度 - 与display程序一致
 
 // GPIO状态结构体
 typedef struct {
@@ -34,9 +33,9 @@ typedef struct {
     int is_exported;
 } GPIO_STATE;
 
-// 共享内存和信号量指针
-char *shared_memory = NULL;
-sem_t *semaphore = NULL;
+// 消息总线（只发布）
+static msg_bus_t display_bus;
+static bool display_bus_opened = false;
 
 // 全局变量用于跟踪ai_client_socket进程
 static pid_t ai_client_pid = -1;
@@ -219,50 +218,15 @@ static int read_gpio_state(int gpio_number) {
 // 初始化IPC通信
 static int init_ipc() {
     int retries = 5;
-    int shm_fd;
     
     while (retries-- > 0) {
-        // 先清理可能残留的资源
-        //shm_unlink(SHM_NAME);
-        //sem_unlink(SEM_NAME);
-        
-        // 创建共享内存
-        shm_fd = shm_open(SHM_NAME, O_CREAT | O_RDWR, 0666);
-        if (shm_fd == -1) {
-            perror("shm_open failed");
+        // 打开（不存在则创建）消息总线，display先启动或后启动都可以
+        if (msg_bus_open(&display_bus, NULL) != 0) {
             usleep(500000); // 等待500ms后重试
             continue;
         }
         
-        if (ftruncate(shm_fd, BUFFER_SIZE) == -1) {
-            perror("ftruncate failed");
-            close(shm_fd);
-            usleep(500000);
-            continue;
-        }
-        
-        // 修改这一行，添加显式类型转换
-        shared_memory = (char*)mmap(0, BUFFER_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
-        if (shared_memory == MAP_FAILED) {
-            perror("mmap failed");
-            close(shm_fd);
-            usleep(500000);
-            continue;
-        }
-        
-        close(shm_fd);
-        
-        // 创建信号量
-        semaphore = sem_open(SEM_NAME, O_CREAT, 0666, 0);
-        if (semaphore == SEM_FAILED) {
-            perror("sem_open failed");
-            munmap(shared_memory, BUFFER_SIZE);
-            usleep(500000);
-            continue;
-        }
-        
-        // 初始化共享内存
-        memset(shared_memory, 0, BUFFER_SIZE);
+        display_bus_opened = true;
         printf("IPC initialized successfully on attempt %d\n", 5 - retries);
         return 0;
     }
@@ -278,30 +242,23 @@ static void cleanup_ipc() {
         stop_ai_client();
     }
     
-    if (shared_memory) {
-        munmap(shared_memory, BUFFER_SIZE);
-        shm_unlink(SHM_NAME);
-    }
-    if (semaphore) {
-        sem_close(semaphore);
-        sem_unlink(SEM_NAME);
+    // 总线由所有进程共用，只关闭不删除
+    if (display_bus_opened) {
+        msg_bus_close(&display_bus);
+        display_bus_opened = false;
     }
 }
 
 // 发送消息给display
 static void send_to_display(const char *message) {
-    if (!shared_memory || !semaphore) {
+    if (!display_bus_opened) {
         printf("IPC not initialized, cannot send message\n");
         return;
     }
     
-    // 复制消息到共享内存
-    strncpy(shared_memory, message, BUFFER_SIZE - 1);
-    shared_memory[BUFFER_SIZE - 1] = '\0'; // 确保字符串终止
-    
-    // 通知display有新消息
-    if (sem_post(semaphore) == -1) {
-        perror("sem_post failed");
+    // 发布到总线，display和其他订阅者各自收到一份，连续发送也不会互相覆盖
+    if (msg_bus_publish_text(&display_bus, message) != 0) {
+        printf("msg_bus_publish failed: %s\n", message);
     } else {
         printf("Sent message to display: %s\n", message);
     }
@@ -515,32 +472,32 @@ static void* gpio_monitor_thread(void *arg) {
                                         send_to_display(message);
                                     }
                                 }
-                                else if(MenuValue == 2){snprintf(message, sizeof(message), "Bright++");send_to_display(message);}
+                                else if(MenuValue == 2){snprintf(message, sizeof(message), "%s", display_cmd_str(DISPLAY_CMD_BRIGHT_UP));send_to_display(message);}
                                  else if(MenuValue == 3){
                                      system("v4l2-ctl -d /dev/v4l-subdev2 --set-ctrl=exposure=1300,analogue_gain=500");//设置增益
                                      system("v4l2-ctl  -d  /dev/video7   --set-fmt-video=width=1920,height=1080,pixelformat=NV12   --stream-mmap=3      --stream-to=/tmp/1.raw --stream-count=1    --stream-skip=1");//拍照
                                      //system("pgrep -x FFlaunch >/dev/null || FFlaunch &");
-                                     snprintf(message, sizeof(message), "Finish-Photo");
+                                     snprintf(message, sizeof(message), "%s", display_cmd_str(DISPLAY_CMD_PHOTO_FINISHED));
                                      send_to_display(message);//发送信息
                                      char ffmpeg_cmd[512];
                                      snprintf(ffmpeg_cmd, sizeof(ffmpeg_cmd), "ffmpeg -y -f rawvideo -pixel_format nv12 -s 1920x1080 -i /tmp/1.raw -vf scale=512:288 -q:v 5 -frames:v 1 -f image2 /tmp/123.jpg");
                                      int ffmpeg_result = system(ffmpeg_cmd);//压缩，保存临时文件，容易被覆盖
                                     snprintf(ffmpeg_cmd, sizeof(ffmpeg_cmd), "mkdir -p /userdata/Rec && cp /tmp/123.jpg /userdata/Rec/P$(date +%%s).jpg");
                                      system(ffmpeg_cmd);//保存
-                                     snprintf(message, sizeof(message), "FFmFinished");
+                                     snprintf(message, sizeof(message), "%s", display_cmd_str(DISPLAY_CMD_FFM_FINISHED));
                                      send_to_display(message);
                                  }
                                 else if(MenuValue == 4){
-                                    snprintf(message, sizeof(message), "VideoRecing");
+                                    snprintf(message, sizeof(message), "%s", display_cmd_str(DISPLAY_CMD_VIDEO_RECORDING));
                                     send_to_display(message);
                                     system("v4l2-ctl -d /dev/v4l-subdev2 --set-ctrl=exposure=1300,analogue_gain=500");//设置增益
                                     char cmd[256];
                                     snprintf(cmd, sizeof(cmd), "simple_vi_bind_venc -c 150 -o /userdata/Rec/out_$(date +%%s).h264");
                                     system(cmd);
-                                    snprintf(message, sizeof(message), "Finish-Video");
+                                    snprintf(message, sizeof(message), "%s", display_cmd_str(DISPLAY_CMD_VIDEO_FINISHED));
                                     send_to_display(message);
                                 }
-                                else if(MenuValue == 5){snprintf(message, sizeof(message), "TelePrompTerNextParagraph");send_to_display(message);}
+                                else if(MenuValue == 5){snprintf(message, sizeof(message), "%s", display_cmd_str(DISPLAY_CMD_TELEPROMPTER_NEXT));send_to_display(message);}
                                 
                             } else if (gpios[i].prev_state == 0 && gpios[i].current_state == 1) {
                                 // LOW转HIGH
@@ -551,21 +508,21 @@ static void* gpio_monitor_thread(void *arg) {
                                 // HIGH转LOW
                                 MenuValue++;
                                 if(MenuValue == 1){
-                                    snprintf(message, sizeof(message), "AiTalk");
+                                    snprintf(message, sizeof(message), "%s", display_cmd_str(DISPLAY_CMD_AI_TALK));
                                     // 如果AI客户端正在运行，停止它
                                     send_to_display(message);
                                 }
                                 else if(MenuValue == 2){
-                                    snprintf(message, sizeof(message), "Brightness");
+                                    snprintf(message, sizeof(message), "%s", display_cmd_str(DISPLAY_CMD_BRIGHTNESS));
                                     if (is_ai_client_running()) {
                                         stop_ai_client();
                                         //printf("AI Client Stopped");
                                     }
                                     send_to_display(message);
                                 }
-                                else if(MenuValue == 4){snprintf(message, sizeof(message), "Record");send_to_display(message);}
-                                else if(MenuValue == 3){snprintf(message, sizeof(message), "CamerA");send_to_display(message);}
-                                else if(MenuValue == 5){snprintf(message, sizeof(message), "TelePrompTer");send_to_display(message);}
+                                else if(MenuValue == 4){snprintf(message, sizeof(message), "%s", display_cmd_str(DISPLAY_CMD_RECORD));send_to_display(message);}
+                                else if(MenuValue == 3){snprintf(message, sizeof(message), "%s", display_cmd_str(DISPLAY_CMD_CAMERA));send_to_display(message);}
+                                else if(MenuValue == 5){snprintf(message, sizeof(message), "%s", display_cmd_str(DISPLAY_CMD_TELEPROMPTER));send_to_display(message);}
                                 else{MenuValue = 0;}
                             } else if (gpios[i].prev_state == 0 && gpios[i].current_state == 1) {
                                 // LOW转HIGH
@@ -40,6 +40,8 @@
 #include <semaphore.h>
 #include <fcntl.h>
 
+#include "../../../src/display/display_cmds.h"	// display的命令表
+
 
 
 
@@ -1472,7 +1474,7 @@ int main(int argc, char *argv[])
 	mainloop_run_with_signal(signal_cb, NULL);
 
 	printf("\n\nShutting down...\n");
-	send_to_display("BLE DissCon");
+	send_to_display(display_cmd_str(DISPLAY_CMD_BLE_DISCONNECTED));
 	server_destroy(g_server);
 	cleanup_ipc();
 